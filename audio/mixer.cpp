@@ -21,6 +21,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -42,7 +43,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResamplerMode resamplerMode);
 	~Channel();
 
 	/**
@@ -197,10 +198,17 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _mixMutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _resamplerMode(kResamplerLinear) {
 
 	assert(sampleRate > 0);
 
+	if (ConfMan.get("resampler") == "sinc")
+		_resamplerMode = kResamplerSinc;
+
+	if (_resamplerMode == kResamplerSinc)
+		initSincFilterBanks();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = nullptr;
 }
@@ -210,6 +218,77 @@ MixerImpl::~MixerImpl() {
 		delete _channels[i];
 }
 
+int MixerImpl::findChannelState(SoundHandle handle) const {
+	const int index = handle._val % NUM_CHANNELS;
+	if (Common::atomicLoadAcquire(&_channelStates[index].handle) != handle._val)
+		return -1;
+	return index;
+}
+
+void MixerImpl::queueCommand(Command::Type type, uint32 handle, int value) {
+	Command command;
+	command.type = type;
+	command.handle = handle;
+	command.value = value;
+
+	{
+		Common::StackLock lock(_commandMutex);
+		if (_commands.push(command))
+			return;
+	}
+
+	// The audio callback is not draining the queue, e.g. because the
+	// mixer is not running yet. Apply everything now, in order.
+	Common::StackLock mixLock(_mixMutex);
+	Common::StackLock lock(_mutex);
+	processCommands();
+	applyCommand(command);
+}
+
+void MixerImpl::processCommands() {
+	Command command;
+	while (_commands.pop(command))
+		applyCommand(command);
+}
+
+void MixerImpl::applyCommand(const Command &command) {
+	if (command.type == Command::kUpdateSoundType) {
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channels[i] && _channels[i]->getType() == (SoundType)command.handle)
+				_channels[i]->notifyGlobalVolChange();
+		}
+		return;
+	}
+
+	// Ignore changes to sounds that already terminated
+	const int index = command.handle % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != command.handle)
+		return;
+
+	switch (command.type) {
+	case Command::kSetVolume:
+		_channels[index]->setVolume(command.value);
+		break;
+	case Command::kSetBalance:
+		_channels[index]->setBalance(command.value);
+		break;
+	case Command::kSetRate:
+		_channels[index]->setRate(command.value);
+		break;
+	case Command::kResetRate:
+		_channels[index]->resetRate();
+		break;
+	case Command::kPause:
+		_channels[index]->pause(command.value != 0);
+		break;
+	case Command::kLoop:
+		_channels[index]->loop();
+		break;
+	default:
+		break;
+	}
+}
+
 void MixerImpl::setReady(bool ready) {
 	Common::StackLock lock(_mutex);
 
@@ -228,6 +307,19 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
+void MixerImpl::setResamplerMode(ResamplerMode mode) {
+	if (mode == kResamplerSinc)
+		initSincFilterBanks();
+
+	Common::StackLock lock(_mutex);
+
+	_resamplerMode = mode;
+}
+
+ResamplerMode MixerImpl::getResamplerMode() const {
+	return _resamplerMode;
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -251,6 +343,36 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	ChannelState &state = _channelStates[index];
+	state.id = chan->getId();
+	state.type = chan->getType();
+	state.volume = chan->getVolume();
+	state.balance = chan->getBalance();
+	state.rate = state.streamRate = chan->getRate();
+	Common::atomicStoreRelease(&state.handle, chanHandle._val);
+}
+
+Channel *MixerImpl::detachChannel(int index) {
+	Common::atomicStoreRelease(&_channelStates[index].handle, (uint32)0xffffffff);
+
+	Channel *chan = _channels[index];
+	_channels[index] = nullptr;
+	return chan;
+}
+
+void MixerImpl::removeChannel(int index) {
+	delete detachChannel(index);
+}
+
+void MixerImpl::deleteChannels(Channel **channels, int count) {
+	if (!count)
+		return;
+
+	// Wait for the mix which may still be using the channels
+	Common::StackLock mixLock(_mixMutex);
+	for (int i = 0; i < count; i++)
+		delete channels[i];
 }
 
 void MixerImpl::playStream(
@@ -292,7 +414,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _resamplerMode);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -301,12 +423,32 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock mixLock(_mixMutex);
 
 	int16 *buf = (int16 *)samples;
 
-	// Since the mixer callback has been called, the mixer must be ready...
-	_mixerReady = true;
+	// Only the channel array is locked, so that engine threads can start
+	// and stop sounds while the channels are being mixed
+	Channel *channels[NUM_CHANNELS];
+	uint32 handles[NUM_CHANNELS];
+
+	{
+		Common::StackLock lock(_mutex);
+
+		// Since the mixer callback has been called, the mixer must be ready...
+		_mixerReady = true;
+
+		// Apply the channel changes requested since the last callback
+		processCommands();
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] && _channels[i]->isFinished())
+				removeChannel(i);
+
+			channels[i] = _channels[i];
+			handles[i] = channels[i] ? channels[i]->getHandle()._val : 0xffffffff;
+		}
+	}
 
 	//  zero the buf
 	memset(buf, 0, len);
@@ -320,64 +462,73 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 		len >>= 1;
 	}
 
-	// mix all channels
+	// mix all channels, skipping those stopped by the streams mixed so far
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
-			}
+		if (channels[i] && Common::atomicLoadAcquire(&_channelStates[i].handle) == handles[i] && !channels[i]->isPaused()) {
+			tmp = channels[i]->mix(buf, len);
+
+			if (tmp > res)
+				res = tmp;
 		}
 
 	return res;
 }
 
 void MixerImpl::stopAll() {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+	Channel *stopped[NUM_CHANNELS];
+	int count = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
+				stopped[count++] = detachChannel(i);
+			}
 		}
 	}
+
+	deleteChannels(stopped, count);
 }
 
 void MixerImpl::stopID(int id) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
+	Channel *stopped[NUM_CHANNELS];
+	int count = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+				stopped[count++] = detachChannel(i);
+			}
 		}
 	}
+
+	deleteChannels(stopped, count);
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Channel *stopped;
 
-	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock lock(_mutex);
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+		// Simply ignore stop requests for handles of sounds that already terminated
+		const int index = handle._val % NUM_CHANNELS;
+		if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+			return;
+
+		stopped = detachChannel(index);
+	}
+
+	deleteChannels(&stopped, 1);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(Command::kUpdateSoundType, type, 0);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -386,67 +537,63 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index < 0)
 		return;
 
-	_channels[index]->setVolume(volume);
+	_channelStates[index].volume = volume;
+	queueCommand(Command::kSetVolume, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index < 0)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _channelStates[index].volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index < 0)
 		return;
 
-	_channels[index]->setBalance(balance);
+	_channelStates[index].balance = balance;
+	queueCommand(Command::kSetBalance, handle._val, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index < 0)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _channelStates[index].balance;
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index < 0)
 		return;
 
-	_channels[index]->setRate(rate);
+	_channelStates[index].rate = rate;
+	queueCommand(Command::kSetRate, handle._val, rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index < 0)
 		return 0;
-	
-	return _channels[index]->getRate();
+
+	return _channelStates[index].rate;
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannelState(handle);
+	if (index < 0)
 		return;
-	
-	_channels[index]->resetRate();
+
+	_channelStates[index].rate = _channelStates[index].streamRate;
+	queueCommand(Command::kResetRate, handle._val, 0);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -454,8 +601,13 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
+	// The time is advanced by mixing, so wait for a consistent value
+	Common::StackLock mixLock(_mixMutex);
 	Common::StackLock lock(_mutex);
 
+	// Take pending pauses into account
+	processCommands();
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return Timestamp(0, _sampleRate);
@@ -464,81 +616,85 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	// Simply ignore loop requests for sounds that already terminated
+	if (findChannelState(handle) < 0)
 		return;
 
-	_channels[index]->loop();
+	queueCommand(Command::kLoop, handle._val, 0);
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
+	// The channels are picked now, so that sounds started before the next
+	// mix are not affected
+	uint32 handles[NUM_CHANNELS];
+	int count = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr)
+				handles[count++] = _channels[i]->getHandle()._val;
 		}
 	}
+
+	for (int i = 0; i < count; i++)
+		queueCommand(Command::kPause, handles[i], paused);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
-			return;
+	uint32 handle = 0xffffffff;
+
+	{
+		Common::StackLock lock(_mutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+				handle = _channels[i]->getHandle()._val;
+				break;
+			}
 		}
 	}
+
+	if (handle != 0xffffffff)
+		queueCommand(Command::kPause, handle, paused);
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
-
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	if (findChannelState(handle) < 0)
 		return;
 
-	_channels[index]->pause(paused);
+	queueCommand(Command::kPause, handle._val, paused);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (Common::atomicLoadAcquire(&_channelStates[i].handle) != 0xffffffff && _channelStates[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	const int index = findChannelState(handle);
+	if (index >= 0)
+		return _channelStates[index].id;
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannelState(handle) >= 0;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (Common::atomicLoadAcquire(&_channelStates[i].handle) != 0xffffffff && _channelStates[i].type == type)
 			return true;
 	return false;
 }
@@ -552,13 +708,9 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	queueCommand(Command::kUpdateSoundType, type, 0);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -573,7 +725,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResamplerMode resamplerMode)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
@@ -582,7 +734,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo, resamplerMode);
 }
 
 Channel::~Channel() {
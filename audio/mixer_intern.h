@@ -24,7 +24,9 @@
 
 #include "common/scummsys.h"
 #include "common/mutex.h"
+#include "common/spsc-queue.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -58,11 +60,61 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
+	/**
+	 * Channel change requested by an engine thread, applied by the audio
+	 * callback before mixing.
+	 */
+	struct Command {
+		enum Type {
+			kSetVolume,
+			kSetBalance,
+			kSetRate,
+			kResetRate,
+			kPause,
+			kLoop,
+			kUpdateSoundType
+		};
+
+		Type type;
+		uint32 handle;	///< Target channel handle, or sound type for kUpdateSoundType
+		int value;
+	};
+
+	/**
+	 * Copy of the channel state, kept for the queries which do not lock
+	 * the mixer. The handle is published last, so that the other fields
+	 * are valid whenever it matches.
+	 */
+	struct ChannelState {
+		ChannelState() : handle(0xffffffff), id(-1), type(kPlainSoundType), volume(0), balance(0), rate(0), streamRate(0) {}
+
+		uint32 handle;
+		int id;
+		SoundType type;
+		byte volume;
+		int8 balance;
+		uint32 rate;
+		uint32 streamRate;
+	};
+
+	// Guards the channel array, which the audio callback only locks for
+	// taking a snapshot of the channels to mix.
 	Common::Mutex _mutex;
 
+	// Held by the audio callback while it mixes, and returned by mutex().
+	// Stopping a sound waits for it before the channel is deleted, since
+	// the caller may free the data of the stream right afterwards.
+	Common::Mutex _mixMutex;
+
+	// Serializes the engine threads pushing commands. The audio callback
+	// never takes it, so it never waits on engine code to change a channel.
+	Common::Mutex _commandMutex;
+	Common::SPSCQueue<Command, COMMAND_QUEUE_SIZE> _commands;
+
 	const uint _sampleRate;
 	const bool _stereo;
 	const uint _outBufSize;
@@ -78,6 +130,9 @@ private:
 
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
+	ChannelState _channelStates[NUM_CHANNELS];
+
+	ResamplerMode _resamplerMode;
 
 
 public:
@@ -87,7 +142,7 @@ public:
 
 	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
 
-	virtual Common::Mutex &mutex() { return _mutex; }
+	virtual Common::Mutex &mutex() { return _mixMutex; }
 
 	virtual void playStream(
 		SoundType type,
@@ -136,8 +191,34 @@ public:
 	virtual bool getOutputStereo() const;
 	virtual uint getOutputBufSize() const;
 
+	/**
+	 * Set the resampling algorithm used by the channels started from now on.
+	 * It defaults to the one set by the "resampler" config key.
+	 */
+	void setResamplerMode(ResamplerMode mode);
+	ResamplerMode getResamplerMode() const;
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
+	/** Take a channel out of the channel array. The mixer must be locked. */
+	Channel *detachChannel(int index);
+	/** Delete a channel. Both the mixer and the mix must be locked. */
+	void removeChannel(int index);
+	/** Delete detached channels, once they are not being mixed any more. */
+	void deleteChannels(Channel **channels, int count);
+
+	/** Return the index of the channel for a handle, or -1 if it is not playing any more. */
+	int findChannelState(SoundHandle handle) const;
+
+	/**
+	 * Queue a channel change for the audio callback. If the queue is full,
+	 * lock the mix and the mixer and apply it right away instead.
+	 */
+	void queueCommand(Command::Type type, uint32 handle, int value);
+
+	/** Apply the queued channel changes. Both the mixer and the mix must be locked. */
+	void processCommands();
+	void applyCommand(const Command &command);
 
 public:
 	/**
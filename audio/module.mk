@@ -24,6 +24,7 @@ MODULE_OBJS := \
 	musicplugin.o \
 	null.o \
 	rate.o \
+	rate_mix.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
@@ -112,5 +113,18 @@ MODULE_OBJS += \
 	rwopl3.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate_mix_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate_mix_sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate_mix_avx2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
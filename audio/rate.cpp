@@ -29,6 +29,7 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_mix.h"
 #include "audio/mixer.h"
 #include "common/util.h"
 
@@ -45,6 +46,73 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * Parameters of the polyphase sinc filter. The fractional position of each
+ * output sample selects one of kSincPhases sets of RateMix::kSincTaps
+ * coefficients. The coefficients use kSincCoefBits fractional bits and
+ * their cutoff frequency is quantized to kSincCutoffSteps steps.
+ */
+enum {
+	kSincPhases = 256,
+	kSincPhaseShift = FRAC_BITS_LOW - 8,
+	kSincCoefBits = 14,
+	kSincCutoffSteps = 64
+};
+
+/**
+ * Compute the coefficients of all the phases of a Blackman windowed sinc
+ * filter. The cutoff is a fraction of the input Nyquist frequency, in
+ * units of 1/kSincCutoffSteps.
+ */
+static void computeSincBank(int16 *bank, int cutoff) {
+	const int halfTaps = RateMix::kSincTaps / 2;
+
+	// Leave some room for the transition band of such a short filter
+	const double fc = 0.9 * cutoff / kSincCutoffSteps;
+
+	for (int phase = 0; phase < kSincPhases; phase++) {
+		double coefs[RateMix::kSincTaps];
+		double sum = 0.0;
+
+		for (int tap = 0; tap < RateMix::kSincTaps; tap++) {
+			// Distance between the output position and this tap
+			const double d = (halfTaps - 1) + (double)phase / kSincPhases - tap;
+			const double x = M_PI * d * fc;
+			const double sinc = (d == 0.0) ? 1.0 : sin(x) / x;
+			const double window = 0.42 + 0.5 * cos(M_PI * d / halfTaps) + 0.08 * cos(2 * M_PI * d / halfTaps);
+
+			coefs[tap] = sinc * window;
+			sum += coefs[tap];
+		}
+
+		// Normalize each phase so that its DC gain is exactly one
+		for (int tap = 0; tap < RateMix::kSincTaps; tap++)
+			bank[phase * RateMix::kSincTaps + tap] = (int16)floor(coefs[tap] / sum * (1 << kSincCoefBits) + 0.5);
+	}
+}
+
+/** Coefficient banks of the sinc filter for all cutoffs, built once */
+static int16 *s_sincBanks = nullptr;
+
+void initSincFilterBanks() {
+	if (s_sincBanks)
+		return;
+
+	const int bankSize = kSincPhases * RateMix::kSincTaps;
+	int16 *banks = new int16[kSincCutoffSteps * bankSize];
+	for (int cutoff = 1; cutoff <= kSincCutoffSteps; cutoff++)
+		computeSincBank(banks + (cutoff - 1) * bankSize, cutoff);
+	s_sincBanks = banks;
+}
+
+static inline const int16 *getSincBank(int cutoff) {
+	return s_sincBanks + (cutoff - 1) * kSincPhases * RateMix::kSincTaps;
+}
+
+static inline st_sample_t clampSincSample(int sum) {
+	return (st_sample_t)CLIP<int>((sum + (1 << (kSincCoefBits - 1))) >> kSincCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
 template<bool inStereo, bool outStereo, bool reverseStereo>
 class RateConverter_Impl : public RateConverter {
 private:
@@ -64,6 +132,15 @@ private:
 	/** Size of data currently loaded into the buffer */
 	int _bufferSize;
 
+	/**
+	 * Resampled stereo frames, in the order of the output channels, waiting
+	 * to be scaled and mixed into the output buffer.
+	 */
+	st_sample_t _frames[512];
+
+	/** Kernel mixing the resampled frames into stereo output */
+	RateMix::MixFunc _mixFunc;
+
 	/** How far output is ahead of input when doing simple conversion */
 	frac_t _outPos;
 
@@ -76,12 +153,36 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
-	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	/** Resampling algorithm used when the rates differ */
+	ResamplerMode _mode;
+
+	/**
+	 * The last input samples for the sinc filter (left/right channel). They
+	 * are stored twice, so that the filter always reads contiguous taps.
+	 */
+	st_sample_t _sincHistL[RateMix::kSincTaps * 2], _sincHistR[RateMix::kSincTaps * 2];
+
+	/** Position of the oldest sample in the sinc filter history */
+	int _sincHistPos;
+
+	/** Kernel computing the sinc filter */
+	RateMix::FilterFunc _filterFunc;
+
+	static void storeFrame(st_sample_t *&frames, st_sample_t inL, st_sample_t inR) {
+		frames[reverseStereo    ] = inL;
+		frames[reverseStereo ^ 1] = inR;
+		frames += 2;
+	}
+
+	int copyConvert(AudioStream &input, st_sample_t *frames, st_size_t numFrames);
+	int simpleConvert(AudioStream &input, st_sample_t *frames, st_size_t numFrames);
+	int interpolateConvert(AudioStream &input, st_sample_t *frames, st_size_t numFrames);
+	int sincConvert(AudioStream &input, st_sample_t *frames, st_size_t numFrames);
+
+	void mixMono(st_sample_t *outBuffer, const st_sample_t *frames, st_size_t numFrames, st_volume_t vol_l, st_volume_t vol_r);
 
 public:
-	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
+	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate, ResamplerMode mode);
 	virtual ~RateConverter_Impl() {}
 
 	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
@@ -96,62 +197,44 @@ public:
 };
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, st_sample_t *frames, st_size_t numFrames) {
 	st_sample_t *outStart, *outEnd;
 
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outStart = frames;
+	outEnd = frames + numFrames * 2;
 
-	while (outBuffer < outEnd) {
+	while (frames < outEnd) {
 		// Check if we have to refill the buffer
 		if (_bufferSize == 0) {
 			_bufferPos = _buffer;
 			_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 			if (_bufferSize <= 0)
-				return (outBuffer - outStart) / (outStereo ? 2 : 1);
+				return (frames - outStart) / 2;
 		}
 
-		// Mix the data into the output buffer
 		st_sample_t inL, inR;
 		inL = *_bufferPos++;
 		inR = (inStereo ? *_bufferPos++ : inL);
 		_bufferSize -= (inStereo ? 2 : 1);
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		storeFrame(frames, inL, inR);
 	}
 
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (frames - outStart) / 2;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, st_sample_t *frames, st_size_t numFrames) {
 	// How much to increment _outPos by
 	frac_t outPos_inc = _inRate / _outRate;
 
 	st_sample_t *outStart, *outEnd;
 
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outStart = frames;
+	outEnd = frames + numFrames * 2;
 
-	while (outBuffer < outEnd) {
+	while (frames < outEnd) {
 		// Read enough input samples so that _outPos >= 0
 		do {
 			// Check if we have to refill the buffer
@@ -160,7 +243,7 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+					return (frames - outStart) / 2;
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -178,38 +261,21 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 		// Increment output position
 		_outPos += outPos_inc;
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		storeFrame(frames, inL, inR);
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (frames - outStart) / 2;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *frames, st_size_t numFrames) {
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
 	st_sample_t *outStart, *outEnd;
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outStart = frames;
+	outEnd = frames + numFrames * 2;
 
-	while (outBuffer < outEnd) {
+	while (frames < outEnd) {
 		// Read enough input samples so that _outPosFrac < 0
 		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
 			// Check if we have to refill the buffer
@@ -218,7 +284,7 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+					return (frames - outStart) / 2;
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -235,7 +301,7 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 
 		// Loop as long as the _outPos trails behind, and as long as there is
 		// still space in the output buffer.
-		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
+		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && frames < outEnd) {
 			// Interpolate
 			st_sample_t inL, inR;
 			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
@@ -243,34 +309,87 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
 						inL);
 
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+			storeFrame(frames, inL, inR);
 
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
+			// Increment output position
+			_outPosFrac += outPos_inc;
+		}
+	}
+	return (frames - outStart) / 2;
+}
 
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::sincConvert(AudioStream &input, st_sample_t *frames, st_size_t numFrames) {
+	// When downsampling, the cutoff has to follow the output rate to
+	// avoid aliasing
+	const int cutoff = CLIP<int>((int)((uint64)_outRate * kSincCutoffSteps / _inRate), 1, kSincCutoffSteps);
+	const int16 *sincBank = getSincBank(cutoff);
 
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
+	// Mono input only needs the left channel history
+	const st_sample_t *histR = inStereo ? _sincHistR : _sincHistL;
 
-				outBuffer += 1;
+	// How much to increment _outPosFrac by
+	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
+
+	st_sample_t *outStart, *outEnd;
+	outStart = frames;
+	outEnd = frames + numFrames * 2;
+
+	while (frames < outEnd) {
+		// Read enough input samples so that _outPosFrac < 0
+		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
+			// Check if we have to refill the buffer
+			if (_bufferSize == 0) {
+				_bufferPos = _buffer;
+				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+				if (_bufferSize <= 0)
+					return (frames - outStart) / 2;
 			}
 
+			_bufferSize -= (inStereo ? 2 : 1);
+			_sincHistL[_sincHistPos] = _sincHistL[_sincHistPos + RateMix::kSincTaps] = *_bufferPos++;
+
+			if (inStereo)
+				_sincHistR[_sincHistPos] = _sincHistR[_sincHistPos + RateMix::kSincTaps] = *_bufferPos++;
+
+			_sincHistPos = (_sincHistPos + 1) % RateMix::kSincTaps;
+			_outPosFrac -= FRAC_ONE_LOW;
+		}
+
+		// Loop as long as the _outPos trails behind, and as long as there is
+		// still space in the output buffer.
+		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && frames < outEnd) {
+			const int16 *coefs = sincBank + (_outPosFrac >> kSincPhaseShift) * RateMix::kSincTaps;
+
+			int sumL, sumR;
+			_filterFunc(_sincHistL + _sincHistPos, histR + _sincHistPos, coefs, sumL, sumR);
+
+			storeFrame(frames, clampSincSample(sumL), clampSincSample(sumR));
+
 			// Increment output position
 			_outPosFrac += outPos_inc;
 		}
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (frames - outStart) / 2;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void RateConverter_Impl<inStereo, outStereo, reverseStereo>::mixMono(st_sample_t *outBuffer, const st_sample_t *frames, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	for (st_size_t i = 0; i < numFrames; i++) {
+		st_sample_t outL, outR;
+		outL = (frames[0] * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (frames[1] * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+		// Output mono channel
+		clampedAdd(outBuffer[i], (outL + outR) / 2);
+
+		frames += 2;
+	}
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate) :
+RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate, ResamplerMode mode) :
 	_inRate(inputRate),
 	_outRate(outputRate),
 	_outPos(1),
@@ -280,37 +399,74 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_inCurL(0),
 	_inCurR(0),
 	_bufferSize(0),
-	_bufferPos(nullptr) {}
+	_bufferPos(nullptr),
+	_mixFunc(RateMix::getMixFunc()),
+	_mode(mode),
+	_sincHistPos(0),
+	_filterFunc(RateMix::getFilterFunc()) {
+	memset(_sincHistL, 0, sizeof(_sincHistL));
+	memset(_sincHistR, 0, sizeof(_sincHistR));
+
+	// Converters are not created in the audio callback, so make sure the
+	// filter banks exist before it runs
+	if (_mode == kResamplerSinc)
+		initSincFilterBanks();
+}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	assert(input.isStereo() == inStereo);
 
-	if (_inRate == _outRate) {
-		return copyConvert(input, outBuffer, numSamples, volL, volR);
-	} else {
-		if ((_inRate % _outRate) == 0 && (_inRate < 65536)) {
-			return simpleConvert(input, outBuffer, numSamples, volL, volR);
+	// The frames are already in the order of the output channels, so
+	// the volumes have to follow
+	if (reverseStereo)
+		SWAP(volL, volR);
+
+	// Resample a chunk into _frames, then scale and mix it all at once
+	st_size_t numFrames = 0;
+	while (numFrames < numSamples) {
+		const st_size_t chunkFrames = MIN<st_size_t>(numSamples - numFrames, ARRAYSIZE(_frames) / 2);
+		int read;
+
+		if (_inRate == _outRate) {
+			read = copyConvert(input, _frames, chunkFrames);
+		} else if (_mode == kResamplerSinc) {
+			read = sincConvert(input, _frames, chunkFrames);
 		} else {
-			return interpolateConvert(input, outBuffer, numSamples, volL, volR);
+			if ((_inRate % _outRate) == 0 && (_inRate < 65536)) {
+				read = simpleConvert(input, _frames, chunkFrames);
+			} else {
+				read = interpolateConvert(input, _frames, chunkFrames);
+			}
 		}
+
+		if (outStereo)
+			_mixFunc(outBuffer + numFrames * 2, _frames, read, volL, volR);
+		else
+			mixMono(outBuffer + numFrames, _frames, read, volL, volR);
+
+		numFrames += read;
+		if ((st_size_t)read < chunkFrames)
+			break;
 	}
+
+	return numFrames;
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, ResamplerMode mode) {
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
-				return new RateConverter_Impl<true, true, true>(inRate, outRate);
+				return new RateConverter_Impl<true, true, true>(inRate, outRate, mode);
 			else
-				return new RateConverter_Impl<true, true, false>(inRate, outRate);
+				return new RateConverter_Impl<true, true, false>(inRate, outRate, mode);
 		} else
-			return new RateConverter_Impl<true, false, false>(inRate, outRate);
+			return new RateConverter_Impl<true, false, false>(inRate, outRate, mode);
 	} else {
 		if (outStereo) {
-			return new RateConverter_Impl<false, true, false>(inRate, outRate);
+			return new RateConverter_Impl<false, true, false>(inRate, outRate, mode);
 		} else
-			return new RateConverter_Impl<false, false, false>(inRate, outRate);
+			return new RateConverter_Impl<false, false, false>(inRate, outRate, mode);
 	}
 }
 
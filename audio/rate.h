@@ -66,6 +66,16 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * Resampling algorithms available to the rate converters.
+ */
+enum ResamplerMode {
+	/** Nearest sample for integer ratios, linear interpolation otherwise. */
+	kResamplerLinear,
+	/** Band-limited polyphase windowed-sinc filter. */
+	kResamplerSinc
+};
+
 /**
  * Helper class that handles resampling an AudioStream between an input and output
  * sample rate. Its regular use case is upsampling from the native stream rate
@@ -104,7 +114,15 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, ResamplerMode mode = kResamplerLinear);
+
+/**
+ * Compute the coefficients of the sinc filter for all the cutoff
+ * frequencies, once. They are shared by all the rate converters, which
+ * then never compute them in the audio callback when the rates change.
+ * Called by the mixer on the main thread when the sinc resampler is used.
+ */
+void initSincFilterBanks();
 
 /** @} */
 } // End of namespace Audio
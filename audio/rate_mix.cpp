@@ -0,0 +1,95 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/rate_mix.h"
+#include "audio/mixer.h"
+#include "common/system.h"
+
+namespace Audio {
+
+RateMix::MixFunc RateMix::_mixFunc = nullptr;
+RateMix::FilterFunc RateMix::_filterFunc = nullptr;
+
+RateMix::MixFunc RateMix::getMixFunc() {
+	// If no function has been selected yet, detect and select
+	if (!_mixFunc) {
+		_mixFunc = mixGeneric;
+#ifndef OUTPUT_UNSIGNED_AUDIO
+		if (g_system) {
+#ifdef SCUMMVM_NEON
+			if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) _mixFunc = mixNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+			if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) _mixFunc = mixSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+			if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) _mixFunc = mixAVX2;
+#endif
+		}
+#endif
+	}
+
+	return _mixFunc;
+}
+
+RateMix::FilterFunc RateMix::getFilterFunc() {
+	// If no function has been selected yet, detect and select
+	if (!_filterFunc) {
+		_filterFunc = filterGeneric;
+		if (g_system) {
+#ifdef SCUMMVM_NEON
+			if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) _filterFunc = filterNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+			if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) _filterFunc = filterSSE2;
+#endif
+		}
+	}
+
+	return _filterFunc;
+}
+
+void RateMix::mixGeneric(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	for (uint i = 0; i < numFrames; i++) {
+		st_sample_t outL, outR;
+		outL = (in[0] * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (in[1] * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+		clampedAdd(out[0], outL);
+		clampedAdd(out[1], outR);
+
+		in += 2;
+		out += 2;
+	}
+}
+
+void RateMix::filterGeneric(const st_sample_t *inL, const st_sample_t *inR, const int16 *coefs, int &outL, int &outR) {
+	int sumL = 0, sumR = 0;
+	for (int i = 0; i < kSincTaps; i++) {
+		sumL += inL[i] * coefs[i];
+		sumR += inR[i] * coefs[i];
+	}
+
+	outL = sumL;
+	outR = sumR;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_MIX_H
+#define AUDIO_RATE_MIX_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Inner loops of the rate converters.
+ *
+ * The mix kernels scale interleaved stereo frames by a volume and mix them
+ * into the output buffer. Every mix kernel computes exactly the same as
+ * mixGeneric: each sample is multiplied by its channel volume, divided by
+ * Mixer::kMaxMixerVolume and added to the output with clampedAdd.
+ *
+ * The filter kernels compute the dot product of kSincTaps samples of both
+ * channels with the coefficients of one phase of the sinc filter. They
+ * all compute exactly the same as filterGeneric.
+ */
+class RateMix {
+public:
+	enum {
+		/** Number of taps of each phase of the sinc filter */
+		kSincTaps = 16
+	};
+
+	typedef void (*MixFunc)(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR);
+	typedef void (*FilterFunc)(const st_sample_t *inL, const st_sample_t *inR, const int16 *coefs, int &outL, int &outR);
+
+	/** Return the fastest mix kernel supported by the CPU. */
+	static MixFunc getMixFunc();
+
+	/** Return the fastest filter kernel supported by the CPU. */
+	static FilterFunc getFilterFunc();
+
+	static void filterGeneric(const st_sample_t *inL, const st_sample_t *inR, const int16 *coefs, int &outL, int &outR);
+#ifdef SCUMMVM_NEON
+	static void filterNEON(const st_sample_t *inL, const st_sample_t *inR, const int16 *coefs, int &outL, int &outR);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void filterSSE2(const st_sample_t *inL, const st_sample_t *inR, const int16 *coefs, int &outL, int &outR);
+#endif
+
+	static void mixGeneric(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR);
+#ifdef SCUMMVM_NEON
+	static void mixNEON(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void mixSSE2(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void mixAVX2(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR);
+#endif
+
+private:
+	static MixFunc _mixFunc;
+	static FilterFunc _filterFunc;
+};
+
+} // End of namespace Audio
+
+#endif
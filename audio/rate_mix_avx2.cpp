@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/mixer.h"
+#include "audio/rate_mix.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+/**
+ * Divide 32-bit products by 256, rounding towards zero like the C division
+ * of the generic kernel.
+ */
+static inline __m256i divideByMixerVolume(__m256i prod) {
+	const __m256i bias = _mm256_srli_epi32(_mm256_srai_epi32(prod, 31), 24);
+	return _mm256_srai_epi32(_mm256_add_epi32(prod, bias), 8);
+}
+
+void RateMix::mixAVX2(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	// The SIMD code relies on the quotients fitting in 16 bits
+	if (volL > Audio::Mixer::kMaxMixerVolume || volR > Audio::Mixer::kMaxMixerVolume) {
+		mixGeneric(out, in, numFrames, volL, volR);
+		return;
+	}
+
+	const __m256i vol = _mm256_set1_epi32((volR << 16) | volL);
+
+	uint i = 0;
+	for (; i + 8 <= numFrames; i += 8) {
+		const __m256i src = _mm256_loadu_si256((const __m256i *)(in + i * 2));
+		const __m256i lo = _mm256_mullo_epi16(src, vol);
+		const __m256i hi = _mm256_mulhi_epi16(src, vol);
+
+		// Unpacking and packing both work within 128-bit lanes, so the
+		// samples end up in their original order
+		const __m256i prod0 = divideByMixerVolume(_mm256_unpacklo_epi16(lo, hi));
+		const __m256i prod1 = divideByMixerVolume(_mm256_unpackhi_epi16(lo, hi));
+
+		__m256i dst = _mm256_loadu_si256((const __m256i *)(out + i * 2));
+		dst = _mm256_adds_epi16(dst, _mm256_packs_epi32(prod0, prod1));
+		_mm256_storeu_si256((__m256i *)(out + i * 2), dst);
+	}
+
+	mixGeneric(out + i * 2, in + i * 2, numFrames - i, volL, volR);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/mixer.h"
+#include "audio/rate_mix.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Audio {
+
+/**
+ * Divide 32-bit products by 256, rounding towards zero like the C division
+ * of the generic kernel.
+ */
+static inline int32x4_t divideByMixerVolume(int32x4_t prod) {
+	const int32x4_t bias = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(prod, 31)), 24));
+	return vshrq_n_s32(vaddq_s32(prod, bias), 8);
+}
+
+void RateMix::mixNEON(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	// The SIMD code relies on the quotients fitting in 16 bits
+	if (volL > Audio::Mixer::kMaxMixerVolume || volR > Audio::Mixer::kMaxMixerVolume) {
+		mixGeneric(out, in, numFrames, volL, volR);
+		return;
+	}
+
+	const int16 volArray[4] = { (int16)volL, (int16)volR, (int16)volL, (int16)volR };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	uint i = 0;
+	for (; i + 4 <= numFrames; i += 4) {
+		const int16x8_t src = vld1q_s16(in + i * 2);
+
+		const int32x4_t prod0 = divideByMixerVolume(vmull_s16(vget_low_s16(src), vol));
+		const int32x4_t prod1 = divideByMixerVolume(vmull_s16(vget_high_s16(src), vol));
+
+		int16x8_t dst = vld1q_s16(out + i * 2);
+		dst = vqaddq_s16(dst, vcombine_s16(vqmovn_s32(prod0), vqmovn_s32(prod1)));
+		vst1q_s16(out + i * 2, dst);
+	}
+
+	mixGeneric(out + i * 2, in + i * 2, numFrames - i, volL, volR);
+}
+
+static inline int horizontalSum(int32x4_t sum) {
+	const int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(half, half), 0);
+}
+
+void RateMix::filterNEON(const st_sample_t *inL, const st_sample_t *inR, const int16 *coefs, int &outL, int &outR) {
+	const int16x8_t coefs0 = vld1q_s16(coefs);
+	const int16x8_t coefs1 = vld1q_s16(coefs + 8);
+
+	const int16x8_t inL0 = vld1q_s16(inL), inL1 = vld1q_s16(inL + 8);
+	int32x4_t sumL = vmull_s16(vget_low_s16(inL0), vget_low_s16(coefs0));
+	sumL = vmlal_s16(sumL, vget_high_s16(inL0), vget_high_s16(coefs0));
+	sumL = vmlal_s16(sumL, vget_low_s16(inL1), vget_low_s16(coefs1));
+	sumL = vmlal_s16(sumL, vget_high_s16(inL1), vget_high_s16(coefs1));
+
+	const int16x8_t inR0 = vld1q_s16(inR), inR1 = vld1q_s16(inR + 8);
+	int32x4_t sumR = vmull_s16(vget_low_s16(inR0), vget_low_s16(coefs0));
+	sumR = vmlal_s16(sumR, vget_high_s16(inR0), vget_high_s16(coefs0));
+	sumR = vmlal_s16(sumR, vget_low_s16(inR1), vget_low_s16(coefs1));
+	sumR = vmlal_s16(sumR, vget_high_s16(inR1), vget_high_s16(coefs1));
+
+	outL = horizontalSum(sumL);
+	outR = horizontalSum(sumR);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif // __GNUC__
+
+#endif // SCUMMVM_NEON
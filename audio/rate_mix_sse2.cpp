@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/mixer.h"
+#include "audio/rate_mix.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Audio {
+
+/**
+ * Divide 32-bit products by 256, rounding towards zero like the C division
+ * of the generic kernel.
+ */
+static inline __m128i divideByMixerVolume(__m128i prod) {
+	const __m128i bias = _mm_srli_epi32(_mm_srai_epi32(prod, 31), 24);
+	return _mm_srai_epi32(_mm_add_epi32(prod, bias), 8);
+}
+
+void RateMix::mixSSE2(st_sample_t *out, const st_sample_t *in, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	// The SIMD code relies on the quotients fitting in 16 bits
+	if (volL > Audio::Mixer::kMaxMixerVolume || volR > Audio::Mixer::kMaxMixerVolume) {
+		mixGeneric(out, in, numFrames, volL, volR);
+		return;
+	}
+
+	const __m128i vol = _mm_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL);
+
+	uint i = 0;
+	for (; i + 4 <= numFrames; i += 4) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(in + i * 2));
+		const __m128i lo = _mm_mullo_epi16(src, vol);
+		const __m128i hi = _mm_mulhi_epi16(src, vol);
+
+		const __m128i prod0 = divideByMixerVolume(_mm_unpacklo_epi16(lo, hi));
+		const __m128i prod1 = divideByMixerVolume(_mm_unpackhi_epi16(lo, hi));
+
+		__m128i dst = _mm_loadu_si128((const __m128i *)(out + i * 2));
+		dst = _mm_adds_epi16(dst, _mm_packs_epi32(prod0, prod1));
+		_mm_storeu_si128((__m128i *)(out + i * 2), dst);
+	}
+
+	mixGeneric(out + i * 2, in + i * 2, numFrames - i, volL, volR);
+}
+
+static inline int horizontalSum(__m128i sum) {
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+void RateMix::filterSSE2(const st_sample_t *inL, const st_sample_t *inR, const int16 *coefs, int &outL, int &outR) {
+	const __m128i coefs0 = _mm_loadu_si128((const __m128i *)coefs);
+	const __m128i coefs1 = _mm_loadu_si128((const __m128i *)(coefs + 8));
+
+	__m128i sumL = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)inL), coefs0);
+	sumL = _mm_add_epi32(sumL, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(inL + 8)), coefs1));
+	__m128i sumR = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)inR), coefs0);
+	sumR = _mm_add_epi32(sumR, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(inR + 8)), coefs1));
+
+	outL = horizontalSum(sumL);
+	outR = horizontalSum(sumR);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -172,6 +172,17 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the last modification time of the file
+	 * referred by this node, if the backend is able to provide them.
+	 *
+	 * @param size  Set to the size of the file in bytes.
+	 * @param mtime Set to the modification time, in seconds since the epoch.
+	 *
+	 * @return bool true if both values could be retrieved, false otherwise.
+	 */
+	virtual bool getFileStats(int64 &size, int64 &mtime) const;
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -182,6 +193,15 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance corresponding to the file
+	 * referred by this node, which may map the file into memory.
+	 * The default implementation calls createReadStream().
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to an alternate
 	 * stream of the file referred by this node. This assumes that the node
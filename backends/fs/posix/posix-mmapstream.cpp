@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mmapstream.h"
+
+#ifdef HAS_MMAP
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Small files are read faster with buffered stdio than by setting up a
+// mapping. Big files are not mapped on 32-bit systems, where they would
+// take up too much of the address space.
+static const int64 kMinMappedFileSize = 64 * 1024;
+static const int64 kMaxMappedFileSize = sizeof(void *) >= 8 ? 0xFFFFFFFF : 256 * 1024 * 1024;
+
+static bool isMappable(const struct stat &st) {
+	return S_ISREG(st.st_mode) && st.st_size >= kMinMappedFileSize && st.st_size <= kMaxMappedFileSize;
+}
+
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path) {
+	// Check the path first, so that files which are not mapped do not have
+	// to be opened twice
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0 || !isMappable(st))
+		return nullptr;
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	// The file may have changed in the meantime
+	if (fstat(fd, &st) != 0 || !isMappable(st)) {
+		close(fd);
+		return nullptr;
+	}
+
+	// The mapping stays valid after the file is closed
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMmapStream((const byte *)data, st.st_size);
+}
+
+PosixMmapStream::PosixMmapStream(const byte *data, int64 size) :
+		_data(data), _size(size), _pos(0), _eos(false) {
+}
+
+PosixMmapStream::~PosixMmapStream() {
+	munmap(const_cast<byte *>(_data), _size);
+}
+
+uint32 PosixMmapStream::read(void *dataPtr, uint32 dataSize) {
+	// Read at most as many bytes as are still available...
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+	memcpy(dataPtr, _data + _pos, dataSize);
+	_pos += dataSize;
+
+	return dataSize;
+}
+
+bool PosixMmapStream::seek(int64 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset = _size + offset;
+		break;
+	case SEEK_CUR:
+		offset = _pos + offset;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+#endif
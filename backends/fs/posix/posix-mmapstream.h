@@ -0,0 +1,76 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+
+#include "common/scummsys.h"
+
+#ifdef HAS_MMAP
+
+#include "common/str.h"
+#include "common/stream.h"
+
+/**
+ * A read-only file stream which maps the whole file into memory.
+ *
+ * Reads are served directly from the page cache, and getMemoryData() gives
+ * access to the file contents without copying them.
+ *
+ * @note The file must not be truncated while it is mapped, since accessing
+ *       the pages past its new end is fatal. It is therefore only used by
+ *       POSIXFilesystemNode::createMappedReadStream().
+ */
+class PosixMmapStream final : public Common::SeekableReadStream {
+public:
+	/**
+	 * Map the file at @p path into memory.
+	 *
+	 * @return The stream, or nullptr if the file cannot be mapped, e.g.
+	 *         because it is too small or too big to be worth mapping. The
+	 *         caller should then fall back to a PosixIoStream.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+	~PosixMmapStream() override;
+
+	bool eos() const override { return _eos; }
+	void clearErr() override { _eos = false; }
+
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+
+	const byte *getMemoryData() const override { return _data; }
+
+private:
+	PosixMmapStream(const byte *data, int64 size);
+
+	const byte *_data;
+	int64 _size;
+	int64 _pos;
+	bool _eos;
+};
+
+#endif
+
+#endif
@@ -25,8 +25,10 @@
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 #include "common/translation.h"
 #include "common/util.h"
 #include "common/file.h"
@@ -137,6 +139,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
 	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
+	_dirtyTilesEnabled(false), _dirtyTilesColumns(0), _dirtyTilesRows(0),
+	_dirtyTilesPixelsChecked(0), _dirtyTilesPixelsSaved(0),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0), _disableMouseKeyColor(false) {
 
@@ -163,6 +167,9 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 		_enableFocusRectDebugCode = ConfMan.getBool("use_sdl_debug_focusrect");
 #endif
 
+	if (ConfMan.hasKey("sdl_dirty_tiles"))
+		_dirtyTilesEnabled = ConfMan.getBool("sdl_dirty_tiles");
+
 #if defined(USE_ASPECT)
 	_videoMode.aspectRatioCorrection = ConfMan.getBool("aspect_ratio");
 	_videoMode.desiredAspectRatio = getDesiredAspectRatio();
@@ -955,6 +962,14 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	// SDL_SetColors does nothing for non indexed surfaces.
 	SDL_SetColors(_screen, _currentPalette, 0, 256);
 
+	if (_dirtyTilesEnabled) {
+		// The copy is filled by the forced redraw of the first update
+		_dirtyTilesScreen.create(_videoMode.screenWidth, _videoMode.screenHeight, _screenFormat);
+		_dirtyTilesColumns = (_videoMode.screenWidth + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+		_dirtyTilesRows = (_videoMode.screenHeight + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+		_dirtyTilesTouched.resize(_dirtyTilesColumns * _dirtyTilesRows, false);
+	}
+
 	//
 	// Create the surface that contains the scaled graphics in 16 bit mode
 	//
@@ -1066,6 +1081,15 @@ void SurfaceSdlGraphicsManager::unloadGFXMode() {
 		_screen = nullptr;
 	}
 
+	if (!_dirtyTilesTouched.empty()) {
+		debug(1, "Dirty tiles: %llu of %llu checked pixels were unchanged",
+			(unsigned long long)_dirtyTilesPixelsSaved, (unsigned long long)_dirtyTilesPixelsChecked);
+		_dirtyTilesScreen.free();
+		_dirtyTilesTouched.clear();
+		_dirtyTilesPixelsChecked = 0;
+		_dirtyTilesPixelsSaved = 0;
+	}
+
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	deinitializeRenderer();
 #endif
@@ -1178,6 +1202,90 @@ void SurfaceSdlGraphicsManager::updateScreen(SDL_Rect *dirtyRectList, int actual
 	SDL_UpdateRects(_hwScreen, actualDirtyRects, dirtyRectList);
 }
 
+namespace {
+
+// Minimum number of source rows scaled by each thread
+const int kMinScaleStripeRows = 16;
+
+struct ScaleStripesParams {
+	Scaler *scaler;
+	const byte *src;
+	uint32 srcPitch;
+	byte *dstPixels;
+	uint32 dstPitch;
+	Graphics::PixelFormat format;
+	int srcX, srcY;
+	int dstX, dstY;
+	int width;
+	int scaleFactor;
+	bool aspectRatioCorrection;
+	bool filtering;
+	Common::Array<int> stripes;
+};
+
+void scaleStripe(void *param, uint stripe) {
+	const ScaleStripesParams &p = *(const ScaleStripesParams *)param;
+	int y = p.stripes[stripe];
+	int height = p.stripes[stripe + 1] - y;
+	int origDstY = (p.dstY + y) * p.scaleFactor;
+	int dstY = p.aspectRatioCorrection ? real2Aspect(origDstY) : origDstY;
+
+	p.scaler->scale(p.src + y * p.srcPitch, p.srcPitch,
+			p.dstPixels + p.dstX * p.format.bytesPerPixel + dstY * p.dstPitch, p.dstPitch,
+			p.width, height, p.srcX, p.srcY + y);
+
+#ifdef USE_ASPECT
+	if (p.aspectRatioCorrection)
+		stretch200To240(p.dstPixels, p.dstPitch, p.width * p.scaleFactor, height * p.scaleFactor,
+				p.dstX, dstY, origDstY, p.filtering, p.format);
+#endif
+}
+
+} // End of anonymous namespace
+
+void SurfaceSdlGraphicsManager::scaleRect(SDL_Surface *srcSurf, int srcX, int srcY, int dstX, int dstY, int width, int height, int scaleFactor, bool aspectRatioCorrection) {
+	ScaleStripesParams params;
+	params.scaler = _scaler;
+	params.format = convertSDLPixelFormat(_hwScreen->format);
+	params.src = (const byte *)srcSurf->pixels + (srcX + _maxExtraPixels) * params.format.bytesPerPixel + (srcY + _maxExtraPixels) * srcSurf->pitch;
+	params.srcPitch = srcSurf->pitch;
+	params.dstPixels = (byte *)_hwScreen->pixels;
+	params.dstPitch = _hwScreen->pitch;
+	params.srcX = srcX;
+	params.srcY = srcY;
+	params.dstX = dstX * scaleFactor;
+	params.dstY = dstY;
+	params.width = width;
+	params.scaleFactor = scaleFactor;
+	params.aspectRatioCorrection = aspectRatioCorrection;
+	params.filtering = _videoMode.filtering;
+
+	// Split large rects into horizontal stripes for the worker threads.
+	// Scalers read the rows around each stripe from the source surface,
+	// which is not written to, so the result does not depend on the split.
+	uint stripeCount = 1;
+	if (_scalerPlugin->canScaleInParallel())
+		stripeCount = MAX<uint>(1, MIN<uint>(Common::getWorkerThreadCount(), height / kMinScaleStripeRows));
+
+	params.stripes.push_back(0);
+	for (uint i = 1; i < stripeCount; i++) {
+		int y = height * i / stripeCount;
+		// When correcting the aspect ratio, each stripe is stretched in place
+		// and must start a group of five rows that is stretched to six, so
+		// that stripes end up in separate rows, and read the same source rows
+		// as when stretching the whole rect.
+		if (aspectRatioCorrection)
+			y -= (dstY + y) % 5;
+		params.stripes.push_back(y);
+	}
+	params.stripes.push_back(height);
+
+	if (stripeCount == 1)
+		scaleStripe(&params, 0);
+	else
+		Common::runParallelJobs(stripeCount, scaleStripe, &params);
+}
+
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	SDL_Surface *srcSurf, *origSurf;
 	int height, width;
@@ -1309,6 +1417,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		_isInOverlayPalette = _overlayVisible;
 	}
 
+	if (_dirtyTilesEnabled && !_overlayVisible)
+		addChangedTiles();
+
 	// In case of double buferring partially good version may be on another page,
 	// so we need to fully redraw
 	if (_isDoubleBuf && _numDirtyRects)
@@ -1341,7 +1452,6 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	if (actualDirtyRects > 0 || _cursorNeedsRedraw) {
 		SDL_Rect *r;
 		SDL_Rect dst;
-		uint32 bpp, srcPitch, dstPitch;
 		SDL_Rect *lastRect = _dirtyRectList + actualDirtyRects;
 
 		for (r = _dirtyRectList; r != lastRect; ++r) {
@@ -1356,10 +1466,6 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_LockSurface(srcSurf);
 		SDL_LockSurface(_hwScreen);
 
-		bpp = _hwScreen->format->BytesPerPixel;
-		srcPitch = srcSurf->pitch;
-		dstPitch = _hwScreen->pitch;
-
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			int src_x = r->x;
 			int src_y = r->y;
@@ -1367,9 +1473,6 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 			int dst_y = r->y;
 			int dst_w = r->w;
 			int dst_h = r->h;
-#ifdef USE_ASPECT
-			int orig_dst_y = 0;
-#endif
 			dst_x += _currentShakeXOffset;
 			if (dst_x < 0) {
 				src_x -= dst_x;
@@ -1395,27 +1498,22 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (dst_h > height - src_y)
 					dst_h = height - src_y;
 
-#ifdef USE_ASPECT
-				orig_dst_y = dst_y;
-#endif
-				dst_x *= scale1;
-				dst_y *= scale1;
-
-				if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
-					dst_y = real2Aspect(dst_y);
+				bool aspectRatioCorrection = _videoMode.aspectRatioCorrection && !_overlayInGUI;
 
-				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
-						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
+				scaleRect(srcSurf, src_x, src_y, dst_x, dst_y, dst_w, dst_h, scale1, aspectRatioCorrection);
 
-				r->x = dst_x;
-				r->y = dst_y;
+				r->x = dst_x * scale1;
+				r->y = dst_y * scale1;
 				r->w = dst_w * scale1;
 				r->h = dst_h * scale1;
 
+				if (aspectRatioCorrection) {
+					r->y = real2Aspect(r->y);
 #ifdef USE_ASPECT
-				if (_videoMode.aspectRatioCorrection && orig_dst_y < height && !_overlayInGUI)
-					r->h = stretch200To240((uint8 *) _hwScreen->pixels, dstPitch, r->w, r->h, r->x, r->y, orig_dst_y * scale1, _videoMode.filtering, 	convertSDLPixelFormat(_hwScreen->format));
+					// The rect stretched by stretch200To240()
+					r->h = 1 + real2Aspect(dst_y * scale1 + r->h - 1) - r->y;
 #endif
+				}
 			}
 		}
 		SDL_UnlockSurface(srcSurf);
@@ -1653,7 +1751,7 @@ void SurfaceSdlGraphicsManager::copyRectToScreen(const void *buf, int pitch, int
 	assert(h > 0 && y + h <= _videoMode.screenHeight);
 	assert(w > 0 && x + w <= _videoMode.screenWidth);
 
-	addDirtyRect(x, y, w, h, false);
+	addScreenDirtyRect(x, y, w, h);
 
 	// Try to lock the screen surface
 	if (SDL_LockSurface(_screen) == -1)
@@ -1705,7 +1803,10 @@ void SurfaceSdlGraphicsManager::unlockScreen() {
 	SDL_UnlockSurface(_screen);
 
 	// Trigger a full screen update
-	_forceRedraw = true;
+	if (_dirtyTilesEnabled)
+		addScreenDirtyRect(0, 0, _videoMode.screenWidth, _videoMode.screenHeight);
+	else
+		_forceRedraw = true;
 
 	// Finally unlock the graphics mutex
 	_graphicsMutex.unlock();
@@ -1794,6 +1895,95 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 	}
 }
 
+void SurfaceSdlGraphicsManager::addScreenDirtyRect(int x, int y, int w, int h) {
+	if (_dirtyTilesTouched.empty()) {
+		addDirtyRect(x, y, w, h, false);
+		return;
+	}
+
+	const uint left = x / DIRTY_TILE_SIZE;
+	const uint right = (x + w - 1) / DIRTY_TILE_SIZE;
+	const uint top = y / DIRTY_TILE_SIZE;
+	const uint bottom = (y + h - 1) / DIRTY_TILE_SIZE;
+
+	for (uint tileY = top; tileY <= bottom; tileY++) {
+		for (uint tileX = left; tileX <= right; tileX++)
+			_dirtyTilesTouched[tileY * _dirtyTilesColumns + tileX] = true;
+	}
+}
+
+void SurfaceSdlGraphicsManager::addChangedTiles() {
+	if (_dirtyTilesTouched.empty())
+		return;
+
+	if (SDL_LockSurface(_screen) == -1)
+		error("SDL_LockSurface failed: %s", SDL_GetError());
+
+	// A forced redraw scales the whole screen anyway, so only bring the copy
+	// up to date
+	if (_forceRedraw) {
+		_dirtyTilesScreen.copyRectToSurface(_screen->pixels, _screen->pitch, 0, 0, _videoMode.screenWidth, _videoMode.screenHeight);
+		Common::fill(_dirtyTilesTouched.begin(), _dirtyTilesTouched.end(), false);
+		SDL_UnlockSurface(_screen);
+		return;
+	}
+
+	const uint bytesPerPixel = _screenFormat.bytesPerPixel;
+	uint checkedPixels = 0;
+	uint changedPixels = 0;
+
+	for (uint tileY = 0; tileY < _dirtyTilesRows; tileY++) {
+		const int y = tileY * DIRTY_TILE_SIZE;
+		const int h = MIN<int>(DIRTY_TILE_SIZE, _videoMode.screenHeight - y);
+
+		// Changed tiles next to each other are added as a single rect
+		int runStart = -1;
+		for (uint tileX = 0; tileX <= _dirtyTilesColumns; tileX++) {
+			bool changed = false;
+
+			if (tileX < _dirtyTilesColumns && _dirtyTilesTouched[tileY * _dirtyTilesColumns + tileX]) {
+				_dirtyTilesTouched[tileY * _dirtyTilesColumns + tileX] = false;
+
+				const int x = tileX * DIRTY_TILE_SIZE;
+				const int w = MIN<int>(DIRTY_TILE_SIZE, _videoMode.screenWidth - x);
+				const byte *src = (const byte *)_screen->pixels + y * _screen->pitch + x * bytesPerPixel;
+				byte *dst = (byte *)_dirtyTilesScreen.getBasePtr(x, y);
+
+				for (int row = 0; row < h && !changed; row++)
+					changed = memcmp(src + row * _screen->pitch, dst + row * _dirtyTilesScreen.pitch, w * bytesPerPixel) != 0;
+
+				if (changed) {
+					for (int row = 0; row < h; row++)
+						memcpy(dst + row * _dirtyTilesScreen.pitch, src + row * _screen->pitch, w * bytesPerPixel);
+					changedPixels += w * h;
+				}
+				checkedPixels += w * h;
+			}
+
+			if (changed && runStart < 0) {
+				runStart = tileX;
+			} else if (!changed && runStart >= 0) {
+				const int x = runStart * DIRTY_TILE_SIZE;
+				addDirtyRect(x, y, MIN<int>(tileX * DIRTY_TILE_SIZE, _videoMode.screenWidth) - x, h, false);
+				runStart = -1;
+			}
+		}
+	}
+
+	SDL_UnlockSurface(_screen);
+
+	// Too many changed rects end up in a full redraw, which saves nothing.
+	// So does any change with double buffering, see internUpdateScreen().
+	_dirtyTilesPixelsChecked += checkedPixels;
+	if (!_forceRedraw && !(_isDoubleBuf && (_numDirtyRects || _prevForceRedraw)))
+		_dirtyTilesPixelsSaved += checkedPixels - changedPixels;
+}
+
+void SurfaceSdlGraphicsManager::getDirtyTilesStats(uint64 &checkedPixels, uint64 &savedPixels) const {
+	checkedPixels = _dirtyTilesPixelsChecked;
+	savedPixels = _dirtyTilesPixelsSaved;
+}
+
 int16 SurfaceSdlGraphicsManager::getHeight() const {
 	return _videoMode.screenHeight;
 }
@@ -65,6 +65,13 @@ public:
 	bool setScaler(uint mode, int factor) override;
 	uint getScaler() const override;
 	uint getScaleFactor() const override;
+
+	/**
+	 * Return how many pixels of the tiles touched by the engine were checked
+	 * for changes, and how many of them were found unchanged and not scaled
+	 * again, since the graphics mode was set up.
+	 */
+	void getDirtyTilesStats(uint64 &checkedPixels, uint64 &savedPixels) const;
 #ifdef USE_RGB_COLOR
 	Graphics::PixelFormat getScreenFormat() const override { return _screenFormat; }
 	Common::List<Graphics::PixelFormat> getSupportedFormats() const override;
@@ -357,6 +364,27 @@ protected:
 	SDL_Rect _prevDirtyRectList[NUM_DIRTY_RECT];
 	int _numPrevDirtyRects;
 
+	// Dirty tile management
+	// When enabled with the "sdl_dirty_tiles" option, updates of the game
+	// screen only mark the tiles they cover as touched. Before scaling, the
+	// touched tiles are compared against a copy of the game screen as it was
+	// last scaled, and only the tiles which actually changed are added to the
+	// dirty rects. This keeps engines which redraw the whole screen every
+	// frame from scaling and updating pixels which did not change.
+	enum {
+		DIRTY_TILE_SIZE = 16
+	};
+
+	bool _dirtyTilesEnabled;
+	Graphics::Surface _dirtyTilesScreen;
+	Common::Array<bool> _dirtyTilesTouched;
+	uint _dirtyTilesColumns, _dirtyTilesRows;
+
+	// Pixels in touched tiles, and pixels in tiles found unchanged and
+	// skipped. See getDirtyTilesStats().
+	uint64 _dirtyTilesPixelsChecked;
+	uint64 _dirtyTilesPixelsSaved;
+
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
 		int16 w, h;
@@ -420,12 +448,27 @@ protected:
 #endif
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool inOverlay, bool realCoordinates = false);
+	/**
+	 * Mark a rect of the game screen as changed. With dirty tiles enabled,
+	 * this only marks the tiles it covers as touched.
+	 */
+	void addScreenDirtyRect(int x, int y, int w, int h);
+	/**
+	 * Add the touched tiles which changed since they were last scaled to the
+	 * dirty rects.
+	 */
+	void addChangedTiles();
 
 	virtual void drawMouse();
 	virtual void undrawMouse();
 	virtual void blitCursor();
 
 	virtual void internUpdateScreen();
+	/**
+	 * Scale a rect of srcSurf, in source coordinates, to _hwScreen and
+	 * correct its aspect ratio. Large rects are scaled on worker threads.
+	 */
+	void scaleRect(SDL_Surface *srcSurf, int srcX, int srcY, int dstX, int dstY, int width, int height, int scaleFactor, bool aspectRatioCorrection);
 	virtual void updateScreen(SDL_Rect *dirtyRectList, int actualDirtyRects);
 
 	virtual bool loadGFXMode();
@@ -192,6 +192,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mixer/null/null-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	thread/sdl/sdl-thread.o \
 	timer/sdl/sdl-timer.o
 
 ifndef RISCOS
@@ -236,6 +237,7 @@ MODULE_OBJS += \
 	fs/posix/posix-fs.o \
 	fs/posix/posix-fs-factory.o \
 	fs/posix/posix-iostream.o \
+	fs/posix/posix-mmapstream.o \
 	fs/posix-drives/posix-drives-fs.o \
 	fs/posix-drives/posix-drives-fs-factory.o \
 	fs/chroot/chroot-fs-factory.o \
@@ -427,6 +429,12 @@ endif
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
 	mixer/null/null-mixer.o
+
+ifdef POSIX
+MODULE_OBJS += \
+	mutex/pthread/pthread-mutex.o \
+	thread/pthread/pthread-thread.o
+endif
 endif
 
 ifdef MIYOO
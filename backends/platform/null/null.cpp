@@ -21,6 +21,7 @@
 
 #include <time.h>
 #ifdef POSIX
+#include <sys/resource.h>
 #include <sys/time.h>
 #include <unistd.h>
 #include <signal.h>
@@ -49,6 +50,10 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#ifdef POSIX
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/thread/pthread/pthread-thread.h"
+#endif
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
@@ -58,6 +63,12 @@ typedef void (*sighandler_t)(int);
 #include "backends/mixer/null/null-mixer.h"
 #include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
+
+#ifdef ENABLE_EVENTRECORDER
+#include "common/array.h"
+#include "common/algorithm.h"
+#include "gui/EventRecorder.h"
+#endif
 #endif
 
 /*
@@ -75,6 +86,106 @@ typedef void (*sighandler_t)(int);
 	#include "backends/fs/windows/windows-fs-factory.h"
 #endif
 
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+#define NULL_DRIVER_USE_EVENTRECORDER
+#endif
+
+#if defined(NULL_DRIVER_USE_EVENTRECORDER) && defined(POSIX)
+/**
+ * Null graphics manager which measures the time between presented frames
+ * while a recording is played back as a benchmark.
+ */
+class NullBenchmarkGraphicsManager : public NullGraphicsManager {
+public:
+	NullBenchmarkGraphicsManager() : _lastFrame(0), _screenshotChecks(0), _screenshotFailures(0), _reported(false) {}
+
+	void updateScreen() override;
+
+	/** Take over the screenshot check results of the event recorder. */
+	void updateScreenshotChecks();
+
+	/**
+	 * Print the benchmark results, if any.
+	 *
+	 * @return false if a screenshot differed from the recorded one
+	 */
+	bool report();
+
+private:
+	static uint64 getMicros();
+
+	Common::Array<uint32> _frameTimes;
+	uint64 _lastFrame;
+	uint32 _screenshotChecks;
+	uint32 _screenshotFailures;
+	bool _reported;
+};
+
+uint64 NullBenchmarkGraphicsManager::getMicros() {
+	timeval curTime;
+	gettimeofday(&curTime, 0);
+	return (uint64)curTime.tv_sec * 1000000 + curTime.tv_usec;
+}
+
+void NullBenchmarkGraphicsManager::updateScreen() {
+	if (!g_eventRec.isBenchmark())
+		return;
+
+	// The first frame only starts the clock
+	uint64 now = getMicros();
+	if (_lastFrame)
+		_frameTimes.push_back((uint32)(now - _lastFrame));
+	_lastFrame = now;
+
+	updateScreenshotChecks();
+}
+
+void NullBenchmarkGraphicsManager::updateScreenshotChecks() {
+	if (!g_eventRec.isBenchmark())
+		return;
+
+	_screenshotChecks = g_eventRec.getScreenshotChecks();
+	_screenshotFailures = g_eventRec.getScreenshotFailures();
+}
+
+bool NullBenchmarkGraphicsManager::report() {
+	if (_reported || !_lastFrame)
+		return true;
+	_reported = true;
+
+	uint64 total = 0;
+	for (uint i = 0; i < _frameTimes.size(); i++) {
+		fputs(Common::String::format("benchmark:frame=%u time_us=%u\n", i + 1, _frameTimes[i]).c_str(), stdout);
+		total += _frameTimes[i];
+	}
+
+	Common::Array<uint32> sorted = _frameTimes;
+	Common::sort(sorted.begin(), sorted.end());
+	uint32 median = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+	uint32 p95 = sorted.empty() ? 0 : sorted[sorted.size() * 95 / 100];
+	uint32 worst = sorted.empty() ? 0 : sorted.back();
+
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	uint32 userMillis = usage.ru_utime.tv_sec * 1000 + usage.ru_utime.tv_usec / 1000;
+	uint32 systemMillis = usage.ru_stime.tv_sec * 1000 + usage.ru_stime.tv_usec / 1000;
+#ifdef MACOSX
+	// Reported in bytes instead of kilobytes
+	uint32 peakKB = usage.ru_maxrss / 1024;
+#else
+	uint32 peakKB = usage.ru_maxrss;
+#endif
+
+	fputs(Common::String::format("benchmark:frames=%u total_ms=%u median_us=%u p95_us=%u max_us=%u "
+	                             "cpu_user_ms=%u cpu_system_ms=%u peak_rss_kb=%u screenshots=%u screenshot_failures=%u\n",
+	                             _frameTimes.size(), (uint32)(total / 1000), median, p95, worst,
+	                             userMillis, systemMillis, peakKB, _screenshotChecks, _screenshotFailures).c_str(), stdout);
+	fflush(stdout);
+
+	return _screenshotFailures == 0;
+}
+#endif
+
 class OSystem_NULL : public ModularMixerBackend, public ModularGraphicsBackend, Common::EventSource {
 public:
 	OSystem_NULL(bool silenceLogs);
@@ -83,14 +194,35 @@ public:
 	virtual void initBackend();
 
 	virtual bool pollEvent(Common::Event &event);
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	virtual bool hasFeature(Feature f);
+#endif
 
 	virtual Common::MutexInternal *createMutex();
+#ifdef POSIX
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param);
+	virtual Common::SemaphoreInternal *createSemaphore();
+	virtual uint getCPUCoreCount();
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
 
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	virtual MixerManager *getMixerManager();
+	virtual Common::TimerManager *getTimerManager();
+	virtual Common::SaveFileManager *getSavefileManager();
+#endif
+
 	virtual void quit();
 
+	/**
+	 * Print the results of a benchmarked playback.
+	 *
+	 * @return false if the playback did not match the recording
+	 */
+	bool reportBenchmark();
+
 	virtual void logMessage(LogMessageType::Type type, const char *message);
 
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority);
@@ -147,13 +279,23 @@ void OSystem_NULL::initBackend() {
 	last_handler = signal(SIGINT, intHandler);
 #endif
 
-	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
+#if defined(NULL_DRIVER_USE_EVENTRECORDER) && defined(POSIX)
+	_graphicsManager = new NullBenchmarkGraphicsManager();
+#else
 	_graphicsManager = new NullGraphicsManager();
+#endif
 	_mixerManager = new NullMixerManager();
 	// Setup and start mixer
 	_mixerManager->init();
+
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	g_eventRec.registerMixerManager(_mixerManager);
+	g_eventRec.registerTimerManager(new DefaultTimerManager());
+#else
+	_timerManager = new DefaultTimerManager();
+#endif
 #endif
 
 	BaseBackend::initBackend();
@@ -186,9 +328,35 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 	return false;
 }
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+bool OSystem_NULL::hasFeature(Feature f) {
+	// The tests never create a graphics manager which could be asked
+	return false;
+}
+#endif
+
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#ifdef POSIX
+	// Real mutexes are needed, since worker threads are supported
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
+}
+
+#ifdef POSIX
+Common::ThreadInternal *OSystem_NULL::createThread(Common::ThreadProc proc, void *param) {
+	return createPthreadThreadInternal(proc, param);
+}
+
+Common::SemaphoreInternal *OSystem_NULL::createSemaphore() {
+	return createPthreadSemaphoreInternal();
+}
+
+uint OSystem_NULL::getCPUCoreCount() {
+	return getPthreadCPUCoreCount();
 }
+#endif
 
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #ifdef POSIX
@@ -196,16 +364,27 @@ uint32 OSystem_NULL::getMillis(bool skipRecord) {
 
 	gettimeofday(&curTime, 0);
 
-	return (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
+	uint32 millis = (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
 			((curTime.tv_usec - _startTime.tv_usec) / 1000));
 #elif defined(WIN32)
-	return GetTickCount() - _startTime;
+	uint32 millis = GetTickCount() - _startTime;
 #else
-	return 0;
+	uint32 millis = 0;
+#endif
+
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	g_eventRec.processMillis(millis, skipRecord);
 #endif
+
+	return millis;
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	if (g_eventRec.processDelayMillis())
+		return;
+#endif
+
 #ifdef POSIX
 	usleep(msecs * 1000);
 #elif defined(WIN32)
@@ -223,14 +402,47 @@ void OSystem_NULL::getTimeAndDate(TimeDate &td, bool skipRecord) const {
 	td.tm_mon = t.tm_mon;
 	td.tm_year = t.tm_year;
 	td.tm_wday = t.tm_wday;
+
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+	g_eventRec.processTimeAndDate(td, skipRecord);
+#endif
+}
+
+#ifdef NULL_DRIVER_USE_EVENTRECORDER
+MixerManager *OSystem_NULL::getMixerManager() {
+	return g_eventRec.getMixerManager();
 }
 
+Common::TimerManager *OSystem_NULL::getTimerManager() {
+	return g_eventRec.getTimerManager();
+}
+
+Common::SaveFileManager *OSystem_NULL::getSavefileManager() {
+	return g_eventRec.getSaveManager(_savefileManager);
+}
+#endif
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 void OSystem_NULL::quit() {
+#if defined(NULL_DRIVER_USE_EVENTRECORDER) && defined(POSIX)
+	// A benchmarked playback ends here when the recording runs out
+	((NullBenchmarkGraphicsManager *)_graphicsManager)->updateScreenshotChecks();
+	if (!reportBenchmark())
+		exit(1);
+#endif
+
 	exit(0);
 }
 #endif
 
+bool OSystem_NULL::reportBenchmark() {
+#if defined(NULL_DRIVER_USE_EVENTRECORDER) && defined(POSIX)
+	return ((NullBenchmarkGraphicsManager *)_graphicsManager)->report();
+#else
+	return true;
+#endif
+}
+
 void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
 	if (_silenceLogs)
 		return;
@@ -257,11 +469,13 @@ OSystem *OSystem_NULL_create(bool silenceLogs) {
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
 int main(int argc, char *argv[]) {
-	g_system = OSystem_NULL_create(false);
-	assert(g_system);
+	OSystem_NULL *system = new OSystem_NULL(false);
+	g_system = system;
 
 	// Invoke the actual ScummVM main entry point:
 	int res = scummvm_main(argc, argv);
+	if (!system->reportBenchmark() && res == 0)
+		res = 1;
 	g_system->destroy();
 	return res;
 }
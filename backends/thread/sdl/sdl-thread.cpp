@@ -0,0 +1,113 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/thread/sdl/sdl-thread.h"
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/textconsole.h"
+
+/**
+ * SDL thread implementation
+ */
+class SdlThreadInternal final : public Common::ThreadInternal {
+public:
+	SdlThreadInternal(SDL_Thread *thread) : _thread(thread) {}
+	~SdlThreadInternal() override {}
+
+	void join() override { SDL_WaitThread(_thread, nullptr); }
+
+private:
+	SDL_Thread *_thread;
+};
+
+struct SdlThreadStartParams {
+	Common::ThreadProc proc;
+	void *param;
+};
+
+static int SDLCALL sdlThreadStart(void *param) {
+	SdlThreadStartParams *params = (SdlThreadStartParams *)param;
+	Common::ThreadProc proc = params->proc;
+	void *procParam = params->param;
+	delete params;
+
+	proc(procParam);
+	return 0;
+}
+
+Common::ThreadInternal *createSdlThreadInternal(Common::ThreadProc proc, void *param) {
+	SdlThreadStartParams *params = new SdlThreadStartParams;
+	params->proc = proc;
+	params->param = param;
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	SDL_Thread *thread = SDL_CreateThread(sdlThreadStart, "ScummVM worker", params);
+#else
+	SDL_Thread *thread = SDL_CreateThread(sdlThreadStart, params);
+#endif
+	if (!thread) {
+		warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		delete params;
+		return nullptr;
+	}
+
+	return new SdlThreadInternal(thread);
+}
+
+/**
+ * SDL semaphore implementation
+ */
+class SdlSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	SdlSemaphoreInternal(SDL_sem *semaphore) : _semaphore(semaphore) {}
+	~SdlSemaphoreInternal() override { SDL_DestroySemaphore(_semaphore); }
+
+	void post() override { SDL_SemPost(_semaphore); }
+	void wait() override { SDL_SemWait(_semaphore); }
+
+private:
+	SDL_sem *_semaphore;
+};
+
+Common::SemaphoreInternal *createSdlSemaphoreInternal() {
+	SDL_sem *semaphore = SDL_CreateSemaphore(0);
+	if (!semaphore) {
+		warning("SDL_CreateSemaphore() failed: %s", SDL_GetError());
+		return nullptr;
+	}
+
+	return new SdlSemaphoreInternal(semaphore);
+}
+
+uint getSdlCPUCoreCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	int count = SDL_GetCPUCount();
+	if (count > 0)
+		return (uint)count;
+#endif
+	return 1;
+}
+
+#endif
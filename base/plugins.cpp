@@ -707,6 +707,9 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
 
+	// Store the new detection results, unless a mass add defers it
+	ADCacheMan.savePersistentCache();
+
 	return DetectionResults(candidates);
 }
 
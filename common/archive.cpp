@@ -20,6 +20,7 @@
  */
 
 #include "common/archive.h"
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/system.h"
@@ -176,6 +177,27 @@ char Archive::getPathSeparator() const {
 	return '/';
 }
 
+MemcachingCaseInsensitiveArchive::LRUList *MemcachingCaseInsensitiveArchive::_lruList = nullptr;
+uint32 MemcachingCaseInsensitiveArchive::_maxCachedSize = 0;
+uint32 MemcachingCaseInsensitiveArchive::_cachedSize = 0;
+
+MemcachingCaseInsensitiveArchive::MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize) :
+	_maxStronglyCachedSize(maxStronglyCachedSize), _cacheHits(0), _cacheMisses(0) {
+	if (ConfMan.hasKey("archive_cache_size"))
+		setMaxCachedSize(MAX(ConfMan.getInt("archive_cache_size"), 0) * 1024);
+}
+
+MemcachingCaseInsensitiveArchive::~MemcachingCaseInsensitiveArchive() {
+	// Give the budget held by this archive back to the others
+	while (!_lruIndex.empty())
+		releaseCachedEntry(_lruIndex.begin()->_value);
+}
+
+void MemcachingCaseInsensitiveArchive::setMaxCachedSize(uint32 maxCachedSize) {
+	_maxCachedSize = maxCachedSize;
+	evictCachedEntries(_maxCachedSize);
+}
+
 SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMember(const Path &path) const {
 	return createReadStreamForMemberImpl(path, false, Common::AltStreamType::Invalid);
 }
@@ -222,6 +244,11 @@ SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMemberI
 		isNew = true;
 	}
 
+	if (isNew)
+		_cacheMisses++;
+	else
+		_cacheHits++;
+
 	// It's possible that recreation failed in case of e.g. network
 	// share going offline.
 	if (entry->isFileMissing())
@@ -230,15 +257,68 @@ SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMemberI
 	// Now we have a valid contents reference. Make stream for it.
 	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(entry->getContents(), entry->getSize());
 
-	// If the entry was just created and it's too big for strong caching,
-	// mark the copy in cache as weak
-	if (isNew && entry->getSize() > _maxStronglyCachedSize) {
-		entry->makeWeak();
-	}
+	// Entries too big for strong caching are only kept strong while they
+	// fit in the LRU budget
+	if (entry->getSize() > _maxStronglyCachedSize)
+		touchCachedEntry(cacheKey, *entry);
 
 	return memStream;
 }
 
+void MemcachingCaseInsensitiveArchive::touchCachedEntry(const CacheKey &cacheKey, SharedArchiveContents &entry) const {
+	const uint32 size = entry.getSize();
+
+	LRUIndex::iterator lruEntry = _lruIndex.find(cacheKey);
+	if (lruEntry != _lruIndex.end()) {
+		// Already held, just move it to the front
+		LRUEntry held = *lruEntry->_value;
+		_lruList->erase(lruEntry->_value);
+		_lruList->push_front(held);
+		lruEntry->_value = _lruList->begin();
+		return;
+	}
+
+	if (size > _maxCachedSize) {
+		entry.makeWeak();
+		return;
+	}
+
+	// Make room before inserting, so that the new entry is never evicted
+	evictCachedEntries(_maxCachedSize - size);
+
+	if (!_lruList)
+		_lruList = new LRUList();
+
+	LRUEntry held;
+	held.archive = this;
+	held.cacheKey = cacheKey;
+	held.size = size;
+	_lruList->push_front(held);
+	_lruIndex[cacheKey] = _lruList->begin();
+	_cachedSize += size;
+}
+
+void MemcachingCaseInsensitiveArchive::releaseCachedEntry(LRUList::iterator lruEntry) const {
+	const CacheKey cacheKey = lruEntry->cacheKey;
+
+	_cachedSize -= lruEntry->size;
+	_cache[cacheKey].makeWeak();
+	_lruIndex.erase(cacheKey);
+
+	_lruList->erase(lruEntry);
+	if (_lruList->empty()) {
+		delete _lruList;
+		_lruList = nullptr;
+	}
+}
+
+void MemcachingCaseInsensitiveArchive::evictCachedEntries(uint32 maxCachedSize) {
+	while (_cachedSize > maxCachedSize && _lruList) {
+		LRUList::iterator lruEntry = _lruList->reverse_begin();
+		lruEntry->archive->releaseCachedEntry(lruEntry);
+	}
+}
+
 SharedArchiveContents MemcachingCaseInsensitiveArchive::readContentsForPathAltStream(const Path &translatedPath, AltStreamType altStreamType) const {
 	return SharedArchiveContents();
 }
@@ -265,10 +265,21 @@ private:
 
 /**
  * An archive that caches the resulting contents.
+ *
+ * Members up to @c maxStronglyCachedSize bytes are always kept in memory.
+ * Bigger members are kept in memory as long as they fit in a total byte
+ * budget shared by all the archives, evicting the least recently used ones
+ * first. Evicted members stay available for as long as a stream still
+ * references them.
+ *
+ * The budget is set by the "archive_cache_size" setting, in kilobytes.
+ * It is 0 by default, so that bigger members are only kept in memory while
+ * they are referenced.
  */
 class MemcachingCaseInsensitiveArchive : public Archive {
 public:
-	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512) : _maxStronglyCachedSize(maxStronglyCachedSize) {}
+	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512);
+	~MemcachingCaseInsensitiveArchive() override;
 	SeekableReadStream *createReadStreamForMember(const Path &path) const;
 	SeekableReadStream *createReadStreamForMemberAltStream(const Path &path, Common::AltStreamType altStreamType) const;
 
@@ -279,6 +290,25 @@ public:
 	virtual SharedArchiveContents readContentsForPath(const Path &translatedPath) const = 0;
 	virtual SharedArchiveContents readContentsForPathAltStream(const Path &translatedPath, AltStreamType altStreamType) const;
 
+	/**
+	 * Set the total size in bytes of the big members kept in memory by all
+	 * the archives. Least recently used members are evicted if the cache is
+	 * already bigger.
+	 */
+	static void setMaxCachedSize(uint32 maxCachedSize);
+	static uint32 getMaxCachedSize() { return _maxCachedSize; }
+
+	/** Return the total size in bytes of the big members currently kept in memory by all the archives. */
+	static uint32 getCachedSize() { return _cachedSize; }
+
+	/** Return how many member streams were served without reading the member again. */
+	uint32 getCacheHits() const { return _cacheHits; }
+
+	/** Return how many member streams required reading the member. */
+	uint32 getCacheMisses() const { return _cacheMisses; }
+
+	void resetCacheStats() { _cacheHits = _cacheMisses = 0; }
+
 private:
 	struct CacheKey {
 		CacheKey();
@@ -295,10 +325,34 @@ private:
 		uint operator()(const CacheKey &x) const;
 	};
 
+	struct LRUEntry {
+		const MemcachingCaseInsensitiveArchive *archive;
+		CacheKey cacheKey;
+		uint32 size;
+	};
+
+	typedef List<LRUEntry> LRUList;
+	typedef HashMap<CacheKey, LRUList::iterator, CacheKey_Hash, CacheKey_EqualTo> LRUIndex;
+
 	SeekableReadStream *createReadStreamForMemberImpl(const Path &path, bool isAltStream, Common::AltStreamType altStreamType) const;
+	void touchCachedEntry(const CacheKey &cacheKey, SharedArchiveContents &entry) const;
+	void releaseCachedEntry(LRUList::iterator lruEntry) const;
+	static void evictCachedEntries(uint32 maxCachedSize);
 
 	mutable HashMap<CacheKey, SharedArchiveContents, CacheKey_Hash, CacheKey_EqualTo> _cache;
 	uint32 _maxStronglyCachedSize;
+
+	// Positions of the members of this archive in the shared LRU list
+	mutable LRUIndex _lruIndex;
+
+	// Big members of all the archives held strongly, most recently used
+	// first. Only allocated while it is not empty.
+	static LRUList *_lruList;
+	static uint32 _maxCachedSize;
+	static uint32 _cachedSize;
+
+	mutable uint32 _cacheHits;
+	mutable uint32 _cacheMisses;
 };
 
 /**
@@ -0,0 +1,92 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal memory ordering primitives for sharing data between threads.
+ *
+ * These only cover loads and stores of naturally aligned types no bigger
+ * than a pointer. Anything more complex should use a Common::Mutex.
+ * @{
+ */
+
+/**
+ * Load a value with acquire semantics. Reads and writes after the load
+ * cannot be moved before it, so everything written before the matching
+ * atomicStoreRelease() in another thread is visible afterwards.
+ */
+template<typename T>
+inline T atomicLoadAcquire(const T *ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+	const T value = *(const volatile T *)ptr;
+#if defined(_M_ARM) || defined(_M_ARM64)
+	__dmb(0xB); // Inner shareable full barrier
+#else
+	_ReadWriteBarrier();
+#endif
+	return value;
+#else
+	// Only correct on compilers which do not reorder volatile accesses
+	// and CPUs with strong memory ordering
+	return *(const volatile T *)ptr;
+#endif
+}
+
+/**
+ * Store a value with release semantics. Reads and writes before the store
+ * cannot be moved after it.
+ */
+template<typename T>
+inline void atomicStoreRelease(T *ptr, T value) {
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+#if defined(_M_ARM) || defined(_M_ARM64)
+	__dmb(0xB); // Inner shareable full barrier
+#else
+	_ReadWriteBarrier();
+#endif
+	*(volatile T *)ptr = value;
+#else
+	*(volatile T *)ptr = value;
+#endif
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -91,10 +91,13 @@ typedef Byte Bytef;
 #include "common/crc.h"
 #endif
 
+#include "common/config-manager.h"
 #include "common/fs.h"
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -237,6 +240,15 @@ Common::SharedArchiveContents unzOpenCurrentFile(unzFile file
   If there is no error, the return value is UNZ_OK.
 */
 
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file, Common::SeekableReadStream *zipStream);
+/*
+  Open the current file in the zipfile as a stream reading from zipStream
+  on demand, instead of loading it into memory first. zipStream is another
+  stream of the zipfile, which is owned by the returned stream, so that
+  streamed files do not share any state. Its CRC is not checked.
+  Return nullptr if there is an error, in which case zipStream is deleted.
+*/
+
 int unzCloseCurrentFile(unzFile file);
 /*
   Close the file in zip opened with unzOpenCurrentFile
@@ -325,6 +337,7 @@ typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCa
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef;	/* owns _stream, shared with streamed files */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -459,6 +472,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 	int err = UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef.reset(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos == 0)
@@ -510,7 +524,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -600,7 +613,7 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
+	// Streamed files keep their own reference to the zipfile stream
 	delete s;
 	return UNZ_OK;
 }
@@ -1018,9 +1031,63 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
 }
 
+/*
+  Open the current file in the zipfile as a stream.
+  Stored files are a plain view into the zipfile, so they are read without
+  any intermediate copy. Deflated files are decompressed on the fly.
+*/
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file, Common::SeekableReadStream *zipStream) {
+	uInt iSizeVar;
+	unz_s *s;
+	uLong offset_local_extrafield;  /* offset of the local extra field */
+	uInt  size_local_extrafield;    /* size of the local extra field */
+
+	if (file == nullptr) {
+		delete zipStream;
+		return nullptr;
+	}
+	s = (unz_s *)file;
+	if (!s->current_file_ok ||
+		unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar,
+				&offset_local_extrafield, &size_local_extrafield) != UNZ_OK) {
+		delete zipStream;
+		return nullptr;
+	}
+
+	uint32 begin = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+	Common::SeekableReadStream *member = new Common::SeekableSubReadStream(zipStream, begin, begin + s->cur_file_info.compressed_size, DisposeAfterUse::YES);
+
+	switch (s->cur_file_info.compression_method) {
+	case 0: // Store
+		return member;
+	case Z_DEFLATED:
+		return Common::wrapDeflateReadStream(member, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size);
+	default:
+		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+		delete member;
+		return nullptr;
+	}
+}
+
 
 namespace Common {
 
+namespace {
+
+/*
+  Memory of the zipfile, which keeps the zipfile stream alive, so that the
+  file may be read after the archive has been closed.
+*/
+class ZipMemoryReadStream : public MemoryReadStream {
+public:
+	ZipMemoryReadStream(const SharedPtr<SeekableReadStream> &zipStream)
+		: MemoryReadStream(zipStream->getMemoryData(), zipStream->size()), _zipStream(zipStream) {}
+
+private:
+	SharedPtr<SeekableReadStream> _zipStream;
+};
+
+} // End of anonymous namespace
 
 class ZipArchive : public MemcachingCaseInsensitiveArchive {
 	unzFile _zipFile;
@@ -1028,9 +1095,22 @@ class ZipArchive : public MemcachingCaseInsensitiveArchive {
 	Common::CRC32 _crc;
 #endif
 	bool _flattenTree;
+	uint32 _streamThreshold;
+
+	// Where the zipfile can be opened again. Members may be read from
+	// different threads, so every streamed member has a stream of its own.
+	FSNode _sourceNode;
+	Path _sourceName;
+
+	SeekableReadStream *openZipStream() const;
+
+	enum {
+		// Bigger members would not stay in the default member cache anyway
+		kDefaultStreamThreshold = 8 * 1024 * 1024
+	};
 
 public:
-	ZipArchive(unzFile zipFile, bool flattenTree);
+	ZipArchive(unzFile zipFile, bool flattenTree, const FSNode &sourceNode, const Path &sourceName);
 
 
 	~ZipArchive();
@@ -1063,8 +1143,35 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree) : _zipFile(zipFile), _flattenTree(flattenTree) {
+ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree, const FSNode &sourceNode, const Path &sourceName) :
+	_zipFile(zipFile), _flattenTree(flattenTree), _streamThreshold(kDefaultStreamThreshold),
+	_sourceNode(sourceNode), _sourceName(sourceName) {
 	assert(_zipFile);
+
+	if (ConfMan.hasKey("archive_stream_threshold"))
+		_streamThreshold = MAX(ConfMan.getInt("archive_stream_threshold"), 0) * 1024;
+}
+
+SeekableReadStream *ZipArchive::openZipStream() const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+
+	// Memory is read without any shared position
+	if (archive->_stream->getMemoryData())
+		return new ZipMemoryReadStream(archive->_streamRef);
+
+	SeekableReadStream *stream = nullptr;
+	if (!_sourceName.empty())
+		stream = SearchMan.createReadStreamForMember(_sourceName);
+	else if (_sourceNode.isReadable())
+		stream = _sourceNode.createReadStream();
+
+	// The zipfile was changed since the archive was opened
+	if (stream && stream->size() != archive->_stream->size()) {
+		delete stream;
+		stream = nullptr;
+	}
+
+	return stream;
 }
 
 ZipArchive::~ZipArchive() {
@@ -1109,6 +1216,17 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
+
+	// Big members are decompressed while they are read, and never cached
+	unz_file_info fi;
+	if (_streamThreshold > 0 && unzGetCurrentFileInfo(_zipFile, &fi, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK &&
+	    fi.uncompressed_size >= _streamThreshold) {
+		SeekableReadStream *zipStream = openZipStream();
+		SeekableReadStream *stream = zipStream ? unzOpenCurrentFileStream(_zipFile, zipStream) : nullptr;
+		if (stream)
+			return SharedArchiveContents::bypass(stream);
+	}
+
 #ifndef USE_ZLIB
 	return unzOpenCurrentFile(_zipFile, _crc);
 #else
@@ -1116,15 +1234,7 @@ Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path
 #endif
 }
 
-Archive *makeZipArchive(const Path &name, bool flattenTree) {
-	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree);
-}
-
-Archive *makeZipArchive(const FSNode &node, bool flattenTree) {
-	return makeZipArchive(node.createReadStream(), flattenTree);
-}
-
-Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
+static Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree, const FSNode &sourceNode, const Path &sourceName) {
 	if (!stream)
 		return nullptr;
 	unzFile zipFile = unzOpen(stream, flattenTree);
@@ -1133,7 +1243,19 @@ Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
 		// goes wrong.
 		return nullptr;
 	}
-	return new ZipArchive(zipFile, flattenTree);
+	return new ZipArchive(zipFile, flattenTree, sourceNode, sourceName);
+}
+
+Archive *makeZipArchive(const Path &name, bool flattenTree) {
+	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree, FSNode(), name);
+}
+
+Archive *makeZipArchive(const FSNode &node, bool flattenTree) {
+	return makeZipArchive(node.createReadStream(), flattenTree, node, Path());
+}
+
+Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
+	return makeZipArchive(stream, flattenTree, FSNode(), Path());
 }
 
 } // End of namespace Common
@@ -32,6 +32,14 @@ namespace Common {
  *
  * @brief API related to ZIP archive files.
  *
+ * Members are loaded into memory and cached when they are opened, except
+ * members of at least "archive_stream_threshold" kilobytes (8 MB by default,
+ * 0 disables this). These are read from the ZIP file on demand instead,
+ * and are decompressed on the fly. Every streamed member reads from a stream
+ * of its own, so the ZIP file must be memory backed or possible to open
+ * again, which is not the case for archives created from a stream which is
+ * not in memory. The CRC of streamed members is not checked.
+ *
  * @{
  */
 
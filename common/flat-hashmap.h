@@ -0,0 +1,619 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/hashmap.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on an open-addressing hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val> which
+ * stores keys and values inline in a single array instead of allocating
+ * a node for each of them.
+ *
+ * Slots are organized in groups of 16. Each slot has a control byte which
+ * is either empty, deleted, or holds 7 bits of the hash of its key. A lookup
+ * compares the control bytes of a whole group at once (with SSE2 when
+ * available) and only compares the keys of the slots whose hash bits match.
+ * This makes lookups and iteration much more cache friendly for big maps.
+ *
+ * The API is the same as the one of HashMap, with one difference: inserting
+ * a new key may move the other elements, so references and iterators are
+ * invalidated by insertions. Erasing elements does not move anything, so
+ * it is still possible to erase elements while iterating over the map.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	enum {
+		FLATHASHMAP_GROUP_SIZE = 16,
+		FLATHASHMAP_MIN_CAPACITY = FLATHASHMAP_GROUP_SIZE,
+
+		// Maximum load factor, deleted slots included
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	enum {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_ctrl;		///< Control bytes, one for each slot
+	Node *_slots;		///< Uninitialized storage for the elements
+	size_type _capacity;	///< Number of slots, a power of two
+	size_type _size;
+	size_type _deleted;	///< Number of slots marked as deleted
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static uint32 mixHash(size_type hash) {
+		// Spread the bits of weak hashes (such as the identity hash used
+		// for integers) over the whole word. A plain multiplication only
+		// carries bits upwards, so keys differing in their high bits only
+		// would share a group; the MurmurHash3 finalizer mixes both ways.
+		uint32 h = (uint32)hash;
+		h ^= h >> 16;
+		h *= 0x85EBCA6BU;
+		h ^= h >> 13;
+		h *= 0xC2B2AE35U;
+		h ^= h >> 16;
+		return h;
+	}
+
+	static byte hashToCtrl(uint32 mixed) {
+		return (byte)(mixed >> 25);
+	}
+
+	/** Return a bit mask of the slots of the group at @p ctrl holding @p value. */
+	static uint32 matchGroup(const byte *ctrl, byte value) {
+#if defined(__SSE2__)
+		const __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+		return (uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)value)));
+#else
+		uint32 mask = 0;
+		for (int i = 0; i < FLATHASHMAP_GROUP_SIZE; i++) {
+			if (ctrl[i] == value)
+				mask |= 1 << i;
+		}
+		return mask;
+#endif
+	}
+
+	/** Return a bit mask of the slots of the group at @p ctrl which are empty or deleted. */
+	static uint32 matchGroupFree(const byte *ctrl) {
+#if defined(__SSE2__)
+		// Both kCtrlEmpty and kCtrlDeleted have the top bit set
+		return (uint32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+		uint32 mask = 0;
+		for (int i = 0; i < FLATHASHMAP_GROUP_SIZE; i++) {
+			if (ctrl[i] & 0x80)
+				mask |= 1 << i;
+		}
+		return mask;
+#endif
+	}
+
+	static int firstBit(uint32 mask) {
+		int bit = 0;
+		while (!(mask & 1)) {
+			mask >>= 1;
+			bit++;
+		}
+		return bit;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type findFreeSlot(uint32 mixed) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx < _hashmap->_capacity);
+			assert(!(_hashmap->_ctrl[_idx] & 0x80));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextUsedSlot(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	size_type nextUsedSlot(size_type idx) const {
+		for (; idx < _capacity; ++idx) {
+			if (!(_ctrl[idx] & 0x80))
+				return idx;
+		}
+		return (size_type)-1;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		freeStorage();
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	/** Return true if hashmap is empty. */
+	bool empty() const { return (_size == 0); }
+
+	iterator begin() { return iterator(nextUsedSlot(0), this); }
+	iterator end() { return iterator((size_type)-1, this); }
+
+	const_iterator begin() const { return const_iterator(nextUsedSlot(0), this); }
+	const_iterator end() const { return const_iterator((size_type)-1, this); }
+
+	iterator find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_capacity = capacity;
+	_size = 0;
+	_deleted = 0;
+
+	_ctrl = new byte[capacity];
+	memset(_ctrl, kCtrlEmpty, capacity);
+
+	_slots = (Node *)malloc(capacity * sizeof(Node));
+	assert(_slots != nullptr);
+}
+
+/**
+ * Destroy all elements and free the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+		if (!(_ctrl[ctr] & 0x80))
+			_slots[ctr].~Node();
+	}
+
+	delete[] _ctrl;
+	free(_slots);
+	_ctrl = nullptr;
+	_slots = nullptr;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._capacity);
+
+	for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+		if (!(map._ctrl[ctr] & 0x80)) {
+			new (&_slots[ctr]) Node(map._slots[ctr]._key);
+			_slots[ctr]._value = map._slots[ctr]._value;
+		}
+	}
+
+	memcpy(_ctrl, map._ctrl, _capacity);
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _capacity > FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr < _capacity; ++ctr) {
+		if (!(_ctrl[ctr] & 0x80))
+			_slots[ctr].~Node();
+	}
+
+	memset(_ctrl, kCtrlEmpty, _capacity);
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	assert(newCapacity >= FLATHASHMAP_MIN_CAPACITY);
+
+	byte *oldCtrl = _ctrl;
+	Node *oldSlots = _slots;
+	const size_type oldCapacity = _capacity;
+#ifndef NDEBUG
+	const size_type oldSize = _size;
+#endif
+
+	allocStorage(newCapacity);
+
+	// Move all the elements to the new table. Since we know that no key
+	// exists twice in the old table, we don't have to call _equal().
+	for (size_type ctr = 0; ctr < oldCapacity; ++ctr) {
+		if (oldCtrl[ctr] & 0x80)
+			continue;
+
+		const uint32 mixed = mixHash(_hash(oldSlots[ctr]._key));
+		const size_type idx = findFreeSlot(mixed);
+
+		new (&_slots[idx]) Node(oldSlots[ctr]._key);
+		_slots[idx]._value = oldSlots[ctr]._value;
+		_ctrl[idx] = hashToCtrl(mixed);
+		_size++;
+
+		oldSlots[ctr].~Node();
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == oldSize);
+
+	delete[] oldCtrl;
+	free(oldSlots);
+}
+
+/**
+ * Return the index of the slot holding @p key, or (size_type)-1 if the
+ * key is not present.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const uint32 mixed = mixHash(_hash(key));
+	const byte ctrl = hashToCtrl(mixed);
+	const size_type groupMask = _capacity / FLATHASHMAP_GROUP_SIZE - 1;
+	size_type group = mixed & groupMask;
+
+	// Triangular probing visits every group once
+	for (size_type step = 1; step <= groupMask + 1; ++step) {
+		const size_type base = group * FLATHASHMAP_GROUP_SIZE;
+
+		for (uint32 match = matchGroup(_ctrl + base, ctrl); match; match &= match - 1) {
+			const size_type idx = base + firstBit(match);
+			if (_equal(_slots[idx]._key, key))
+				return idx;
+		}
+
+		// An empty slot ends the probe sequence
+		if (matchGroup(_ctrl + base, kCtrlEmpty))
+			break;
+
+		group = (group + step) & groupMask;
+	}
+
+	return (size_type)-1;
+}
+
+/**
+ * Return the first empty or deleted slot in the probe sequence of a hash.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(uint32 mixed) const {
+	const size_type groupMask = _capacity / FLATHASHMAP_GROUP_SIZE - 1;
+	size_type group = mixed & groupMask;
+
+	for (size_type step = 1; ; ++step) {
+		const size_type base = group * FLATHASHMAP_GROUP_SIZE;
+		const uint32 match = matchGroupFree(_ctrl + base);
+		if (match)
+			return base + firstBit(match);
+
+		// The load factor guarantees that there are free slots
+		assert(step <= groupMask + 1);
+		group = (group + step) & groupMask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type idx = lookup(key);
+	if (idx != (size_type)-1)
+		return idx;
+
+	const uint32 mixed = mixHash(_hash(key));
+	idx = findFreeSlot(mixed);
+
+	// Keep the load factor below a certain threshold. Deleted slots are
+	// also counted, unless the new element reuses one of them.
+	if (_ctrl[idx] == kCtrlEmpty &&
+	        (_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > _capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Only grow if the live elements need it, otherwise just get rid
+		// of the deleted slots
+		size_type capacity = _capacity;
+		if ((_size + 1) * 2 * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity = capacity < 512 ? (capacity * 4) : (capacity * 2);
+		rehash(capacity);
+		idx = findFreeSlot(mixed);
+	}
+
+	if (_ctrl[idx] == kCtrlDeleted)
+		_deleted--;
+
+	new (&_slots[idx]) Node(key);
+	_ctrl[idx] = hashToCtrl(mixed);
+	_size++;
+
+	return idx;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != (size_type)-1;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap, creating it if it is not present.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// Creating the element may reallocate the slots, so look them up afterwards
+	const size_type idx = lookupAndCreateIfMissing(key);
+	return _slots[idx]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type idx = lookup(key);
+	if (idx != (size_type)-1)
+		return _slots[idx]._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type idx = lookup(key);
+	if (idx != (size_type)-1)
+		return _slots[idx]._value;
+	else
+		// See the comment in HashMap::getVal()
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type idx = lookup(key);
+	if (idx != (size_type)-1)
+		return _slots[idx]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type idx = lookup(key);
+	if (idx != (size_type)-1) {
+		out = _slots[idx]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type idx = lookupAndCreateIfMissing(key);
+	_slots[idx]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type idx = entry._idx;
+	assert(idx < _capacity);
+	assert(!(_ctrl[idx] & 0x80));
+
+	_slots[idx].~Node();
+	_ctrl[idx] = kCtrlDeleted;
+	_size--;
+	_deleted++;
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	const size_type idx = lookup(key);
+	if (idx == (size_type)-1)
+		return;
+
+	_slots[idx].~Node();
+	_ctrl[idx] = kCtrlDeleted;
+	_size--;
+	_deleted++;
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
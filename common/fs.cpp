@@ -31,7 +31,7 @@ namespace Common {
 // File-in-directory archive member that captures relative path
 class FSDirectoryFile : public ArchiveMember {
 public:
-	FSDirectoryFile(const Common::Path &pathInDirectory, const FSNode &fsNode);
+	FSDirectoryFile(const Common::Path &pathInDirectory, const FSNode &fsNode, bool mapFile = false);
 
 	SeekableReadStream *createReadStream() const override;
 	SeekableReadStream *createReadStreamForAltStream(AltStreamType altStreamType) const override;
@@ -45,13 +45,16 @@ public:
 private:
 	Common::Path _pathInDirectory;
 	FSNode _fsNode;
+	bool _mapFile;
 };
 
-FSDirectoryFile::FSDirectoryFile(const Common::Path &pathInDirectory, const FSNode &fsNode)
-	: _pathInDirectory(pathInDirectory), _fsNode(fsNode) {
+FSDirectoryFile::FSDirectoryFile(const Common::Path &pathInDirectory, const FSNode &fsNode, bool mapFile)
+	: _pathInDirectory(pathInDirectory), _fsNode(fsNode), _mapFile(mapFile) {
 }
 
 SeekableReadStream *FSDirectoryFile::createReadStream() const {
+	if (_mapFile)
+		return _fsNode.createMappedReadStream();
 	return _fsNode.createReadStream();
 }
 
@@ -95,7 +98,7 @@ void FSDirectoryFile::listChildren(ArchiveMemberList &list, const char *pattern)
 
 		Common::Path subPath = _pathInDirectory.appendComponent(fileName);
 
-		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(subPath, fsNode)));
+		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(subPath, fsNode, _mapFile)));
 	}
 }
 
@@ -233,6 +236,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getFileStats(int64 &size, int64 &mtime) const {
+	return _realNode && _realNode->getFileStats(size, mtime);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -248,6 +255,21 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+SeekableReadStream *FSNode::createMappedReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createMappedReadStream: '%s' does not exist", getName().c_str());
+		return nullptr;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createMappedReadStream: '%s' is a directory", getName().c_str());
+		return nullptr;
+	}
+
+	return _realNode->createMappedReadStream();
+}
+
 SeekableReadStream *FSNode::createReadStreamForAltStream(AltStreamType altStreamType) const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -293,26 +315,26 @@ bool FSNode::createDirectory() const {
 
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 }
 
 FSDirectory::FSDirectory(const Path &prefix, const FSNode &node, int depth, bool flat,
 						 bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 
 	setPrefix(prefix);
 }
 
 FSDirectory::FSDirectory(const Path &name, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 }
 
 FSDirectory::FSDirectory(const Path &prefix, const Path &name, int depth, bool flat,
 						 bool ignoreClashes, bool includeDirectories)
   : _node(name), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
-	_includeDirectories(includeDirectories) {
+	_includeDirectories(includeDirectories), _mapFiles(false) {
 
 	setPrefix(prefix);
 }
@@ -370,7 +392,7 @@ const ArchiveMemberPtr FSDirectory::getMember(const Path &path) const {
 		return ArchiveMemberPtr();
 	}
 
-	return ArchiveMemberPtr(new FSDirectoryFile(path, *node));
+	return ArchiveMemberPtr(new FSDirectoryFile(path, *node, _mapFiles));
 }
 
 SeekableReadStream *FSDirectory::createReadStreamForMember(const Path &path) const {
@@ -383,7 +405,7 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const Path &path) con
 
 	debug(5, "FSDirectory::createReadStreamForMember('%s') -> '%s'", path.toString(Common::Path::kNativeSeparator).c_str(), node->getPath().toString(Common::Path::kNativeSeparator).c_str());
 
-	SeekableReadStream *stream = node->createReadStream();
+	SeekableReadStream *stream = _mapFiles ? node->createMappedReadStream() : node->createReadStream();
 	if (!stream)
 		warning("FSDirectory::createReadStreamForMember: Can't create stream for file '%s'", Common::toPrintable(path.toString(Common::Path::kNativeSeparator)).c_str());
 
@@ -420,7 +442,9 @@ FSDirectory *FSDirectory::getSubDirectory(const Path &prefix, const Path &name,
 	if (!node)
 		return nullptr;
 
-	return new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
+	FSDirectory *dir = new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
+	dir->setMapFiles(_mapFiles);
+	return dir;
 }
 
 void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix) const {
@@ -496,7 +520,7 @@ int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const Path &patter
 				isMatch = it->_key.matchPattern(pattern);
 
 			if (isMatch) {
-				list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value)));
+				list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value, _mapFiles)));
 				++matches;
 			}
 		}
@@ -519,13 +543,13 @@ int FSDirectory::listMembers(ArchiveMemberList &list) const {
 
 	int files = 0;
 	for (NodeCache::const_iterator it = _fileCache.begin(); it != _fileCache.end(); ++it) {
-		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value)));
+		list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value, _mapFiles)));
 		++files;
 	}
 
 	if (_includeDirectories) {
 		for (NodeCache::const_iterator it = _subDirCache.begin(); it != _subDirCache.end(); ++it) {
-			list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value)));
+			list.push_back(ArchiveMemberPtr(new FSDirectoryFile(it->_key, it->_value, _mapFiles)));
 			++files;
 		}
 	}
@@ -252,6 +252,17 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and the last modification time of the file referred
+	 * by this node. Not all backends are able to provide this information.
+	 *
+	 * @param size  Set to the size of the file in bytes.
+	 * @param mtime Set to the modification time, in seconds since the epoch.
+	 *
+	 * @return True if both values could be retrieved, false otherwise.
+	 */
+	bool getFileStats(int64 &size, int64 &mtime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -261,6 +272,20 @@ public:
 	 */
 	SeekableReadStream *createReadStream() const override;
 
+	/**
+	 * Create a SeekableReadStream instance corresponding to the file
+	 * referred by this node, like createReadStream(), but allow the backend
+	 * to map the file into memory.
+	 *
+	 * Only use this for files which are not written while the stream is
+	 * open, such as game data. Reading a mapped file after it has been
+	 * truncated crashes. FSDirectory opens its members this way when
+	 * FSDirectory::setMapFiles() is enabled.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to an alternate stream
 	 * of the file referred by this node. This assumes that the node actually
@@ -339,6 +364,7 @@ class FSDirectory : public Archive {
 	bool _flat;
 	bool _ignoreClashes;
 	bool _includeDirectories;
+	bool _mapFiles;
 
 	Path	_prefix; // string that is prepended to each cache item key
 	void setPrefix(const Path &prefix);
@@ -391,6 +417,14 @@ public:
 	 */
 	FSNode getFSNode() const;
 
+	/**
+	 * Open the members of this directory with FSNode::createMappedReadStream(),
+	 * so that their data may be borrowed with SeekableReadStream::getMemoryData()
+	 * without copying it. This is off by default, and should only be enabled
+	 * for read-only data such as game files. Subdirectories inherit the setting.
+	 */
+	void setMapFiles(bool mapFiles) { _mapFiles = mapFiles; }
+
 	/**
 	 * Create a new FSDirectory pointing to a subdirectory of the instance.
 	 * @return A new FSDirectory instance.
@@ -39,6 +39,7 @@ MODULE_OBJS := \
 	system.o \
 	textconsole.o \
 	text-to-speech.o \
+	thread.o \
 	tokenizer.o \
 	translation.o \
 	unicode-bidi.o \
@@ -276,6 +276,18 @@ public:
 	 * @return true if the file exists. false otherwise.
 	 */
 	virtual bool exists(const String &name) = 0;
+
+	/**
+	 * Retrieve the size and the last modification time of a savefile. Not
+	 * all savefile managers are able to provide this information.
+	 *
+	 * @param name  Name of the save file.
+	 * @param size  Set to the size of the file in bytes.
+	 * @param mtime Set to the modification time, in seconds since the epoch.
+	 *
+	 * @return True if both values could be retrieved, false otherwise.
+	 */
+	virtual bool getSavefileStats(const String &name, int64 &size, int64 &mtime) { return false; }
 };
 
 /** @} */
@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SPSC_QUEUE_H
+#define COMMON_SPSC_QUEUE_H
+
+#include "common/atomic.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_spsc_queue Lock-free queue
+ * @ingroup common
+ *
+ * @brief Fixed size ring buffer for passing items between two threads.
+ * @{
+ */
+
+/**
+ * Lock-free single-producer/single-consumer queue.
+ *
+ * One thread may push items while another one pops them, without any
+ * locking. If several threads need to push (or pop), they have to be
+ * serialized by the caller, e.g. with a Common::Mutex that the other
+ * side never takes.
+ *
+ * @tparam T    Type of the items. Items are copied in and out.
+ * @tparam size Capacity of the queue, which must be a power of two.
+ */
+template<class T, uint32 size>
+class SPSCQueue : NonCopyable {
+	T _items[size];
+	uint32 _head; ///< Number of items popped so far, only written by the consumer
+	uint32 _tail; ///< Number of items pushed so far, only written by the producer
+
+public:
+	SPSCQueue() : _head(0), _tail(0) {
+		STATIC_ASSERT(size != 0 && (size & (size - 1)) == 0, SPSCQueue_size_must_be_a_power_of_two);
+	}
+
+	/**
+	 * Append an item. Must only be called by the producer.
+	 *
+	 * @return False if the queue is full.
+	 */
+	bool push(const T &item) {
+		const uint32 tail = _tail;
+		if (tail - atomicLoadAcquire(&_head) == size)
+			return false;
+
+		_items[tail & (size - 1)] = item;
+		atomicStoreRelease(&_tail, tail + 1);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest item. Must only be called by the consumer.
+	 *
+	 * @return False if the queue is empty.
+	 */
+	bool pop(T &item) {
+		const uint32 head = _head;
+		if (atomicLoadAcquire(&_tail) == head)
+			return false;
+
+		item = _items[head & (size - 1)];
+		atomicStoreRelease(&_head, head + 1);
+		return true;
+	}
+
+	/** Return true if the queue is empty. May be called by both threads. */
+	bool empty() const {
+		return atomicLoadAcquire(&_tail) == atomicLoadAcquire(&_head);
+	}
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
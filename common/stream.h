@@ -792,6 +792,20 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Borrow a pointer to the whole contents of the stream, if they are
+	 * available in memory, for example because the stream wraps a memory
+	 * buffer or a memory mapped file. This allows reading the data without
+	 * copying it.
+	 *
+	 * The data must not be modified, and is only valid as long as the
+	 * stream exists. It does not depend on the stream position.
+	 *
+	 * @return Pointer to size() bytes, or nullptr if the contents are not
+	 *         available in memory.
+	 */
+	virtual const byte *getMemoryData() const { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
@@ -982,6 +996,7 @@ public:
 	int64 pos() const override { return _parentStream->pos(); }
 	int64 size() const override { return _parentStream->size(); }
 	bool seek(int64 offset, int whence = SEEK_SET) override { return _parentStream->seek(offset, whence); }
+	const byte *getMemoryData() const override { return _parentStream->getMemoryData(); }
 };
 
 /** @} */
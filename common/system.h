@@ -55,6 +55,9 @@ class Store;
 namespace Common {
 class EventManager;
 class MutexInternal;
+class SemaphoreInternal;
+class ThreadInternal;
+typedef void (*ThreadProc)(void *param);
 struct Rect;
 class SaveFileManager;
 class SearchSet;
@@ -1570,7 +1573,7 @@ public:
 
 
 	/**
-	 * @defgroup common_system_mutex Mutex handling
+	 * @defgroup common_system_mutex Mutex and thread handling
 	 * @ingroup common_system
 	 * @{
 	 *
@@ -1586,6 +1589,9 @@ public:
 	 *
 	 * Hence, backends that do not use threads to implement the timers can simply
 	 * use dummy implementations for these methods.
+	 *
+	 * Backends may also provide worker threads, which the engines and
+	 * subsystems use for optional parallel processing (see Common::Thread).
 	 */
 
 	/**
@@ -1595,6 +1601,34 @@ public:
 	 */
 	virtual Common::MutexInternal *createMutex() = 0;
 
+	/**
+	 * Create a new thread running @p proc with @p param.
+	 *
+	 * Threads are optional. They are only meant to spread self-contained
+	 * work (such as hashing files or rendering parts of a frame) over
+	 * several CPU cores, and every user must work without them. Backends
+	 * that do not support threads return nullptr, in which case
+	 * Common::Thread runs the function synchronously.
+	 *
+	 * @return The newly created thread, or nullptr if threads are not supported.
+	 */
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *param) { return nullptr; }
+
+	/**
+	 * Create a new counting semaphore with an initial count of zero.
+	 *
+	 * Backends which support threads must also support semaphores, since
+	 * they are used to hand work to long-lived worker threads.
+	 *
+	 * @return The newly created semaphore, or nullptr if threads are not supported.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore() { return nullptr; }
+
+	/**
+	 * Return the number of CPU cores that can run threads in parallel.
+	 */
+	virtual uint getCPUCoreCount() { return 1; }
+
 	/** @} */
 
 
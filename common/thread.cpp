@@ -0,0 +1,212 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/thread.h"
+#include "common/config-manager.h"
+
+namespace Common {
+
+Thread::Thread() : _thread(nullptr) {
+}
+
+Thread::~Thread() {
+	join();
+}
+
+bool Thread::start(ThreadProc proc, void *param) {
+	join();
+
+	if (g_system)
+		_thread = g_system->createThread(proc, param);
+
+	if (_thread)
+		return true;
+
+	// No thread support, run the function right away
+	proc(param);
+	return false;
+}
+
+bool Thread::tryStart(ThreadProc proc, void *param) {
+	join();
+
+	if (g_system)
+		_thread = g_system->createThread(proc, param);
+
+	return _thread != nullptr;
+}
+
+void Thread::join() {
+	if (!_thread)
+		return;
+
+	_thread->join();
+	delete _thread;
+	_thread = nullptr;
+}
+
+Semaphore::Semaphore() : _semaphore(nullptr) {
+	if (g_system)
+		_semaphore = g_system->createSemaphore();
+}
+
+Semaphore::~Semaphore() {
+	delete _semaphore;
+}
+
+void Semaphore::post() {
+	if (_semaphore)
+		_semaphore->post();
+}
+
+void Semaphore::wait() {
+	if (_semaphore)
+		_semaphore->wait();
+}
+
+
+#pragma mark -
+
+
+uint getWorkerThreadCount() {
+	if (!g_system)
+		return 1;
+
+	return ParallelJobsPool::instance().getThreadCount();
+}
+
+void runParallelJobs(uint jobCount, ParallelJobProc proc, void *param, uint maxThreads) {
+	uint threads = getWorkerThreadCount();
+	if (maxThreads && threads > maxThreads)
+		threads = maxThreads;
+	if (threads > jobCount)
+		threads = jobCount;
+
+	if (threads > 1 && ParallelJobsPool::instance().run(jobCount, proc, param, threads))
+		return;
+
+	// Single threaded, or the pool is busy with another batch
+	for (uint job = 0; job < jobCount; job++)
+		proc(param, job);
+}
+
+
+#pragma mark -
+
+
+DECLARE_SINGLETON(ParallelJobsPool);
+
+ParallelJobsPool::ParallelJobsPool() : _busy(false), _quit(false),
+	_proc(nullptr), _param(nullptr), _jobCount(0), _step(1) {
+	int count = 0;
+	if (ConfMan.hasKey("worker_threads"))
+		count = ConfMan.getInt("worker_threads");
+
+	if (count <= 0 && g_system)
+		count = g_system->getCPUCoreCount();
+
+	if (count > 1)
+		addWorkers(count - 1);
+}
+
+ParallelJobsPool::~ParallelJobsPool() {
+	_quit = true;
+	for (uint i = 0; i < _workers.size(); i++)
+		_workers[i]->start.post();
+
+	// Deleting a worker joins its thread
+	for (uint i = 0; i < _workers.size(); i++)
+		delete _workers[i];
+}
+
+bool ParallelJobsPool::addWorkers(uint count) {
+	if (!_done.isValid())
+		return false;
+
+	for (uint i = 0; i < count; i++) {
+		Worker *worker = new Worker();
+		worker->pool = this;
+		worker->index = _workers.size() + 1;
+
+		if (!worker->start.isValid() || !worker->thread.tryStart(workerProc, worker)) {
+			delete worker;
+			return false;
+		}
+
+		_workers.push_back(worker);
+	}
+
+	return true;
+}
+
+void ParallelJobsPool::workerProc(void *param) {
+	Worker *worker = (Worker *)param;
+
+	for (;;) {
+		worker->start.wait();
+		if (worker->pool->_quit)
+			break;
+
+		worker->pool->runShare(worker->index);
+		worker->pool->_done.post();
+	}
+}
+
+void ParallelJobsPool::runShare(uint worker) {
+	for (uint job = worker; job < _jobCount; job += _step)
+		_proc(_param, job);
+}
+
+uint ParallelJobsPool::run(uint jobCount, ParallelJobProc proc, void *param, uint threads) {
+	{
+		StackLock lock(_mutex);
+		if (_busy)
+			return 0;
+
+		if (threads > _workers.size() + 1)
+			threads = _workers.size() + 1;
+		if (threads <= 1)
+			return 0;
+
+		_busy = true;
+	}
+
+	_proc = proc;
+	_param = param;
+	_jobCount = jobCount;
+	_step = threads;
+
+	// The calling thread handles the first share of the jobs itself
+	for (uint i = 1; i < threads; i++)
+		_workers[i - 1]->start.post();
+
+	runShare(0);
+
+	for (uint i = 1; i < threads; i++)
+		_done.wait();
+
+	StackLock lock(_mutex);
+	_busy = false;
+	return threads;
+}
+
+} // End of namespace Common
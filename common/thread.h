@@ -0,0 +1,212 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+#include "common/singleton.h"
+#include "common/system.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Threads
+ * @ingroup common
+ *
+ * @brief API for running work on worker threads.
+ *
+ * Threads are an optional backend feature. When the backend does not
+ * provide them, all functions in this group run the work synchronously
+ * on the calling thread, so callers never need a separate code path.
+ *
+ * Thread functions must not touch non thread-safe global state, such as
+ * the configuration manager, the search manager or the debug output.
+ * @{
+ */
+
+class ThreadInternal {
+public:
+	virtual ~ThreadInternal() {}
+
+	/** Wait until the thread function has returned. */
+	virtual void join() = 0;
+};
+
+/**
+ * Wrapper class around the OSystem thread functions.
+ */
+class Thread : NonCopyable {
+	ThreadInternal *_thread;
+
+public:
+	Thread();
+	~Thread();
+
+	/**
+	 * Run @p proc with @p param on a new thread.
+	 *
+	 * If the backend does not support threads, the function is run
+	 * synchronously before start() returns.
+	 *
+	 * @return True if the function runs in the background, false if it
+	 *         has already been run.
+	 */
+	bool start(ThreadProc proc, void *param);
+
+	/**
+	 * Run @p proc with @p param on a new thread, if the backend supports
+	 * threads.
+	 *
+	 * Unlike start(), the function is not run at all when no thread can be
+	 * created. Use this for functions which wait for other threads.
+	 *
+	 * @return True if the function runs in the background.
+	 */
+	bool tryStart(ThreadProc proc, void *param);
+
+	/** Wait until the thread function has returned. */
+	void join();
+
+	/** Return true if the thread has been started and not joined yet. */
+	bool isRunning() const { return _thread != nullptr; }
+};
+
+class SemaphoreInternal {
+public:
+	virtual ~SemaphoreInternal() {}
+
+	virtual void post() = 0;
+	virtual void wait() = 0;
+};
+
+/**
+ * Wrapper class around the OSystem semaphore functions.
+ *
+ * Semaphores are only available when the backend supports threads.
+ * Otherwise isValid() returns false and post() and wait() do nothing.
+ */
+class Semaphore : NonCopyable {
+	SemaphoreInternal *_semaphore;
+
+public:
+	Semaphore();
+	~Semaphore();
+
+	bool isValid() const { return _semaphore != nullptr; }
+
+	/** Increment the count, waking up one waiting thread. */
+	void post();
+
+	/** Wait until the count is positive, then decrement it. */
+	void wait();
+};
+
+typedef void (*ParallelJobProc)(void *param, uint job);
+
+/**
+ * Return the number of worker threads to use for parallel jobs.
+ *
+ * This is the number of CPU cores reported by the backend, unless the
+ * "worker_threads" config key is set to a positive value. It is 1 if
+ * the backend does not support threads.
+ *
+ * The count is determined once, when the ParallelJobsPool is created, so
+ * it may be queried from any thread.
+ */
+uint getWorkerThreadCount();
+
+/**
+ * Run @p jobCount jobs, spread over the available worker threads, and
+ * wait until all of them have completed.
+ *
+ * Jobs are distributed in a fixed round-robin order: job @c i is run
+ * by worker <tt>i % workers</tt>, and worker 0 is the calling thread.
+ * The other workers are the threads of the ParallelJobsPool.
+ *
+ * @param jobCount   Number of jobs to run.
+ * @param proc       Function called once for each job index.
+ * @param param      Parameter passed to @p proc.
+ * @param maxThreads Upper bound for the number of threads, 0 for no limit.
+ */
+void runParallelJobs(uint jobCount, ParallelJobProc proc, void *param, uint maxThreads = 0);
+
+/**
+ * Persistent worker threads used by runParallelJobs().
+ *
+ * The threads are created once, sized by the "worker_threads" config key
+ * or the CPU core count, and sleep on a semaphore between batches of jobs.
+ * The configuration is read when the pool is created, on the main thread. The pool only runs one
+ * batch at a time: jobs submitted while it is busy, including jobs
+ * submitted from another job, run on the calling thread instead.
+ */
+class ParallelJobsPool : public Singleton<ParallelJobsPool> {
+public:
+	/**
+	 * Run @p jobCount jobs on the calling thread and up to
+	 * <tt>threads - 1</tt> pool threads, as described for runParallelJobs().
+	 *
+	 * @return The number of threads which ran the jobs, or 0 if the pool
+	 *         is busy and none of the jobs have been run.
+	 */
+	uint run(uint jobCount, ParallelJobProc proc, void *param, uint threads);
+
+	/** Return the number of threads running jobs, including the calling thread. */
+	uint getThreadCount() const { return _workers.size() + 1; }
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	ParallelJobsPool();
+	~ParallelJobsPool();
+
+	struct Worker {
+		ParallelJobsPool *pool;
+		uint index;
+		Semaphore start;
+		Thread thread;
+	};
+
+	static void workerProc(void *param);
+	void runShare(uint worker);
+	bool addWorkers(uint count);
+
+	Array<Worker *> _workers;
+	Semaphore _done;
+	Mutex _mutex;
+	bool _busy;
+	bool _quit;
+
+	// The batch being run, set up before the workers are woken up
+	ParallelJobProc _proc;
+	void *_param;
+	uint _jobCount;
+	uint _step;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -21,6 +21,7 @@
 
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "common/algorithm.h"
 #include "common/debug.h"
 #include "common/util.h"
 #include "common/file.h"
@@ -30,6 +31,7 @@
 #include "common/punycode.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 #include "common/compression/clickteam.h"
@@ -468,6 +470,157 @@ namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+#define DETECTION_CACHE_HEADER "# ScummVM detection cache v2"
+
+bool AdvancedDetectorCacheManager::isPersistentCacheEnabled() const {
+	return ConfMan.getBool("detection_cache") && !getPersistentCachePath().empty();
+}
+
+Common::Path AdvancedDetectorCacheManager::getPersistentCachePath() const {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	if (configFile.empty())
+		return Common::Path();
+
+	return configFile.getParent().appendComponent("detection.cache");
+}
+
+void AdvancedDetectorCacheManager::loadPersistentCache() {
+	_persistentLoaded = true;
+	_persistentHashMap.clear();
+	_persistentDirty = false;
+
+	if (!isPersistentCacheEnabled())
+		return;
+
+	Common::FSNode node(getPersistentCachePath());
+	if (!node.exists())
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+	if (!stream)
+		return;
+
+	if (stream->readLine() != DETECTION_CACHE_HEADER) {
+		warning("AdvancedDetectorCacheManager: Ignoring detection cache with unknown format");
+		return;
+	}
+
+	// Each line is: <file size> <mtime> <md5 size> <md5> <path> <key>
+	while (!stream->eos() && !stream->err()) {
+		Common::String line = stream->readLine();
+		if (line.empty())
+			continue;
+
+		long long fileSize, mtime, size;
+		char md5[33];
+		int pathPos = 0;
+
+		if (sscanf(line.c_str(), "%lld\t%lld\t%lld\t%32[0-9a-fA-F]\t%n", &fileSize, &mtime, &size, md5, &pathPos) != 4 || pathPos == 0)
+			continue;
+
+		const char *keyStart = strchr(line.c_str() + pathPos, '\t');
+		if (!keyStart || keyStart[1] == '\0')
+			continue;
+
+		PersistentEntry entry;
+		entry.path = Common::Path(Common::String(line.c_str() + pathPos, keyStart), Common::Path::kNativeSeparator);
+		entry.fileSize = fileSize;
+		entry.mtime = mtime;
+		entry.size = size;
+		entry.md5 = md5;
+		entry.used = false;
+
+		Common::String key(keyStart + 1);
+
+		_persistentHashMap.setVal(key, entry);
+	}
+
+	debugC(2, kDebugGlobalDetection, "Loaded %d entries from the detection cache", _persistentHashMap.size());
+}
+
+void AdvancedDetectorCacheManager::savePersistentCache() {
+	if (!_persistentDirty || _persistentSaveDeferred)
+		return;
+
+	_persistentDirty = false;
+
+	// Drop the entries of files which changed since they were hashed.
+	// Entries used by this session are known to be current. Files which
+	// cannot be accessed are kept, as they may be on a drive which is
+	// currently not mounted.
+	for (PersistentHashMap::iterator entry = _persistentHashMap.begin(); entry != _persistentHashMap.end(); ++entry) {
+		if (entry->_value.used)
+			continue;
+
+		int64 fileSize, mtime;
+		if (Common::FSNode(entry->_value.path).getFileStats(fileSize, mtime) &&
+			(fileSize != entry->_value.fileSize || mtime != entry->_value.mtime))
+			_persistentHashMap.erase(entry);
+	}
+
+	Common::DumpFile file;
+	if (!file.open(Common::FSNode(getPersistentCachePath()))) {
+		warning("AdvancedDetectorCacheManager: Unable to write the detection cache");
+		return;
+	}
+
+	file.writeString(DETECTION_CACHE_HEADER "\n");
+
+	for (const auto &entry : _persistentHashMap) {
+		Common::String path = entry._value.path.toString(Common::Path::kNativeSeparator);
+		if (entry._key.contains('\n') || path.contains('\n') || path.contains('\t'))
+			continue;
+
+		file.writeString(Common::String::format("%lld\t%lld\t%lld\t%s\t%s\t%s\n",
+			(long long)entry._value.fileSize, (long long)entry._value.mtime, (long long)entry._value.size,
+			entry._value.md5.c_str(), path.c_str(), entry._key.c_str()));
+	}
+
+	file.finalize();
+	file.close();
+}
+
+bool AdvancedDetectorCacheManager::getPersistentMD5(const Common::String &key, int64 fileSize, int64 mtime, Common::String &md5, int64 &size) {
+	if (!_persistentLoaded)
+		loadPersistentCache();
+
+	const PersistentHashMap::iterator entry = _persistentHashMap.find(key);
+	if (entry == _persistentHashMap.end())
+		return false;
+
+	// The file has changed since it was hashed
+	if (entry->_value.fileSize != fileSize || entry->_value.mtime != mtime)
+		return false;
+
+	md5 = entry->_value.md5;
+	size = entry->_value.size;
+	entry->_value.used = true;
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setPersistentMD5(const Common::String &key, const Common::Path &path, int64 fileSize, int64 mtime, const Common::String &md5, int64 size) {
+	if (!_persistentLoaded)
+		loadPersistentCache();
+
+	if (!isPersistentCacheEnabled())
+		return;
+
+	PersistentEntry entry;
+	entry.path = path;
+	entry.fileSize = fileSize;
+	entry.mtime = mtime;
+	entry.size = size;
+	entry.md5 = md5;
+	entry.used = true;
+
+	_persistentHashMap.setVal(key, entry);
+	_persistentDirty = true;
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -532,12 +685,53 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
 
-bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
+/**
+ * Compose the key identifying a file in the persistent MD5 cache, and
+ * retrieve the path, the current size and the modification time of the
+ * file on disk.
+ */
+static bool getPersistentCacheKey(uint md5Bytes, const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, Common::String &key, Common::Path &path, int64 &fileSize, int64 &mtime) {
+	// Mac forks may come from companion files (AppleDouble, __MACOSX, etc.),
+	// so we can't reliably tell whether they have changed
+	if (md5prop & (kMD5MacResFork | kMD5MacDataFork))
+		return false;
+
+	Common::Path nodeName = fname;
+
+	if (md5prop & kMD5Archive) {
+		// For files inside archives, track the archive itself
+		Common::StringTokenizer tok(fname.toString(), ":");
+		tok.nextToken();
+		nodeName = Common::Path(tok.nextToken());
+	}
+
+	if (!allFiles.contains(nodeName))
+		return false;
+
+	const Common::FSNode &node = allFiles[nodeName];
+
+	if (!node.getFileStats(fileSize, mtime))
+		return false;
+
+	path = node.getPath();
+	key = Common::String::format("%s:%d:%s:%s", md5PropToCachePrefix(md5prop).c_str(), md5Bytes,
+		fname.toString('/').c_str(), path.toString(Common::Path::kNativeSeparator).c_str());
+
+	return true;
+}
+
+static Common::String getFileCacheKey(uint md5Bytes, MD5Properties md5prop, const Common::Path &fname) {
 	Common::String hashname = md5PropToCachePrefix(md5prop);
 		hashname += ':';
 		hashname += fname.toString('/');
 		hashname += ':';
-		hashname += Common::String::format("%d", _md5Bytes);
+		hashname += Common::String::format("%d", md5Bytes);
+
+	return hashname;
+}
+
+bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
+	Common::String hashname = getFileCacheKey(_md5Bytes, md5prop, fname);
 
 	if (ADCacheMan.containsMD5(hashname)) {
 		fileProps.md5 = ADCacheMan.getMD5(hashname);
@@ -545,16 +739,164 @@ bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles,
 		return true;
 	}
 
+	// Try the on-disk cache before reading the file
+	Common::String persistentKey;
+	Common::Path persistentPath;
+	int64 fileSize = 0, mtime = 0;
+	bool persistent = getPersistentCacheKey(_md5Bytes, allFiles, md5prop, fname, persistentKey, persistentPath, fileSize, mtime);
+
+	if (persistent && ADCacheMan.getPersistentMD5(persistentKey, fileSize, mtime, fileProps.md5, fileProps.size)) {
+		ADCacheMan.setMD5(hashname, fileProps.md5);
+		ADCacheMan.setSize(hashname, fileProps.size);
+		return true;
+	}
+
 	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
 		ADCacheMan.setSize(hashname, fileProps.size);
+
+		if (persistent)
+			ADCacheMan.setPersistentMD5(persistentKey, persistentPath, fileSize, mtime, fileProps.md5, fileProps.size);
 	}
 
 	return res;
 }
 
+namespace {
+
+struct PrefetchRequest {
+	MD5Properties md5prop;
+	Common::Path fname;
+	Common::String persistentKey;
+	Common::Path persistentPath;
+	int64 fileSize;
+	int64 mtime;
+	FileProperties props;
+	bool success;
+};
+
+/**
+ * All requests for one file. Each file is handled by a single worker,
+ * since FSNode and String reference counts are not thread-safe.
+ */
+struct PrefetchFile {
+	const Common::FSNode *node;
+	Common::Array<PrefetchRequest> requests;
+};
+
+struct PrefetchJobs {
+	uint md5Bytes;
+	Common::Array<PrefetchFile> files;
+};
+
+void prefetchFileJob(void *param, uint job) {
+	PrefetchJobs *jobs = (PrefetchJobs *)param;
+	PrefetchFile &file = jobs->files[job];
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(file.node->createReadStream());
+	if (!stream)
+		return;
+
+	for (uint i = 0; i < file.requests.size(); i++) {
+		PrefetchRequest &request = file.requests[i];
+
+		stream->seek(0);
+		if ((request.md5prop & kMD5Tail) && stream->size() > jobs->md5Bytes)
+			stream->seek(-(int64)jobs->md5Bytes, SEEK_END);
+
+		request.props.size = stream->size();
+		request.props.md5 = Common::computeStreamMD5AsString(*stream, jobs->md5Bytes);
+		request.props.md5prop = (MD5Properties)(request.md5prop & kMD5Tail);
+		request.success = !stream->err();
+	}
+}
+
+} // End of anonymous namespace
+
+void AdvancedMetaEngineDetectionBase::prefetchFileProperties(const FileMap &allFiles, const Common::Array<uint> &candidates) const {
+	if (Common::getWorkerThreadCount() <= 1)
+		return;
+
+	PrefetchJobs jobs;
+	jobs.md5Bytes = _md5Bytes;
+
+	Common::HashMap<Common::String, uint> fileIndices;
+	Common::HashMap<Common::String, bool> queued;
+
+	for (uint c = 0; c < candidates.size(); c++) {
+		const ADGameDescription *g = (const ADGameDescription *)(_gameDescriptors + candidates[c] * _descItemSize);
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
+
+			// Only plain files are hashed ahead, archives and Mac forks
+			// are left to getFileProperties()
+			if (md5prop & (kMD5MacResFork | kMD5MacDataFork | kMD5Archive))
+				continue;
+
+			Common::Path fname(fileDesc->fileName);
+			if (!allFiles.contains(fname))
+				continue;
+
+			Common::String hashname = getFileCacheKey(_md5Bytes, md5prop, fname);
+			if (queued.contains(hashname) || ADCacheMan.containsMD5(hashname))
+				continue;
+
+			queued[hashname] = true;
+
+			PrefetchRequest request;
+			request.md5prop = md5prop;
+			request.fname = fname;
+			request.fileSize = 0;
+			request.mtime = 0;
+			request.success = false;
+
+			if (getPersistentCacheKey(_md5Bytes, allFiles, md5prop, fname, request.persistentKey, request.persistentPath, request.fileSize, request.mtime) &&
+				ADCacheMan.getPersistentMD5(request.persistentKey, request.fileSize, request.mtime, request.props.md5, request.props.size)) {
+				ADCacheMan.setMD5(hashname, request.props.md5);
+				ADCacheMan.setSize(hashname, request.props.size);
+				continue;
+			}
+
+			const Common::FSNode &node = allFiles[fname];
+			Common::String path = node.getPath().toString(Common::Path::kNativeSeparator);
+
+			if (!fileIndices.contains(path)) {
+				fileIndices[path] = jobs.files.size();
+				jobs.files.push_back(PrefetchFile());
+				jobs.files.back().node = &node;
+			}
+
+			jobs.files[fileIndices[path]].requests.push_back(request);
+		}
+	}
+
+	if (jobs.files.empty())
+		return;
+
+	debugC(3, kDebugGlobalDetection, "Hashing %d files on %d threads", jobs.files.size(), Common::getWorkerThreadCount());
+
+	Common::runParallelJobs(jobs.files.size(), prefetchFileJob, &jobs);
+
+	// Store the results in the order they were requested
+	for (uint i = 0; i < jobs.files.size(); i++) {
+		for (uint j = 0; j < jobs.files[i].requests.size(); j++) {
+			const PrefetchRequest &request = jobs.files[i].requests[j];
+			if (!request.success)
+				continue;
+
+			Common::String hashname = getFileCacheKey(_md5Bytes, request.md5prop, request.fname);
+			ADCacheMan.setMD5(hashname, request.props.md5);
+			ADCacheMan.setSize(hashname, request.props.size);
+
+			if (!request.persistentKey.empty())
+				ADCacheMan.setPersistentMD5(request.persistentKey, request.persistentPath, request.fileSize, request.mtime, request.props.md5, request.props.size);
+		}
+	}
+}
+
 bool AdvancedMetaEngineBase::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	return getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps);
 }
@@ -726,16 +1068,24 @@ ADDetectedGames AdvancedMetaEngineDetectionBase::detectGame(const Common::FSNode
 
 	const ADGameFileDescription *fileDesc;
 	const ADGameDescription *g;
-	const byte *descPtr;
 
 	debugC(3, kDebugGlobalDetection, "Starting detection for engine '%s' in dir '%s'", getName(), parent.getPath().toString(Common::Path::kNativeSeparator).c_str());
 
 	preprocessDescriptions();
 
+	// Only look at the entries which may have all their files present
+	Common::Array<uint> candidates;
+	getCandidateDescriptions(allFiles, candidates);
+
+	debugC(3, kDebugGlobalDetection, "%d candidate entries", candidates.size());
+
+	// Hash the files needed below on the worker threads first
+	prefetchFileProperties(allFiles, candidates);
+
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
-	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
-		g = (const ADGameDescription *)descPtr;
+	for (uint c = 0; c < candidates.size(); c++) {
+		g = (const ADGameDescription *)(_gameDescriptors + candidates[c] * _descItemSize);
 
 		for (fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
 			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
@@ -762,9 +1112,9 @@ ADDetectedGames AdvancedMetaEngineDetectionBase::detectGame(const Common::FSNode
 	bool gotAnyMatchesWithAllFiles = false;
 
 	// MD5 based matching
-	uint i;
-	for (i = 0, descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize, ++i) {
-		g = (const ADGameDescription *)descPtr;
+	for (uint c = 0; c < candidates.size(); c++) {
+		uint i = candidates[c];
+		g = (const ADGameDescription *)(_gameDescriptors + i * _descItemSize);
 
 		// Do not even bother to look at entries which do not have matching
 		// language and platform (if specified).
@@ -1037,12 +1387,78 @@ void AdvancedMetaEngineDetectionBase::preprocessDescriptions() {
 		}
 	}
 
+	buildDescriptionIndex();
+
 #ifndef RELEASE_BUILD
 	// Check the provided tables for sanity
 	detectClashes();
 #endif
 }
 
+void AdvancedMetaEngineDetectionBase::buildDescriptionIndex() {
+	// An entry can only match if all its files are present, so it is
+	// enough to index each entry by one of its files. Files inside archives
+	// and Mac forks are not looked up directly in the file map, so only
+	// plain files are used. Among them, pick the one shared by the fewest
+	// entries to keep the candidate lists short.
+	Common::HashMap<Common::Path, uint, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> fileCounts;
+
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			if (!(gameFileToMD5Props(fileDesc, g->flags) & (kMD5MacMask | kMD5Archive)))
+				fileCounts[Common::Path(fileDesc->fileName)]++;
+		}
+	}
+
+	uint i = 0;
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize, ++i) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+		const char *anchor = nullptr;
+		uint anchorCount = 0;
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			if (gameFileToMD5Props(fileDesc, g->flags) & (kMD5MacMask | kMD5Archive))
+				continue;
+
+			uint count = fileCounts[Common::Path(fileDesc->fileName)];
+			if (!anchor || count < anchorCount) {
+				anchor = fileDesc->fileName;
+				anchorCount = count;
+			}
+		}
+
+		if (anchor)
+			_descriptionIndex[Common::Path(anchor)].push_back(i);
+		else
+			_unindexedDescriptions.push_back(i);
+	}
+
+	debugC(4, kDebugGlobalDetection, "Indexed detection entries for '%s' by %d files, %d unindexed",
+		getName(), _descriptionIndex.size(), _unindexedDescriptions.size());
+}
+
+void AdvancedMetaEngineDetectionBase::getCandidateDescriptions(const FileMap &allFiles, Common::Array<uint> &candidates) const {
+	candidates = _unindexedDescriptions;
+
+	for (FileMap::const_iterator file = allFiles.begin(); file != allFiles.end(); ++file) {
+		DescriptionIndexMap::const_iterator entries = _descriptionIndex.find(file->_key);
+		if (entries != _descriptionIndex.end())
+			candidates.push_back(entries->_value);
+	}
+
+	// Keep the order of the detection tables, which the matching relies on
+	Common::sort(candidates.begin(), candidates.end());
+
+	uint size = 0;
+	for (uint i = 0; i < candidates.size(); i++) {
+		if (size == 0 || candidates[size - 1] != candidates[i])
+			candidates[size++] = candidates[i];
+	}
+	candidates.resize(size);
+}
+
 Common::StringArray AdvancedMetaEngineDetectionBase::getPathsFromEntry(const ADGameDescription *g) {
 	Common::StringArray result;
 	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> unique;
@@ -535,15 +535,33 @@ protected:
 
 private:
 	void preprocessDescriptions();
+	void buildDescriptionIndex();
 	static Common::StringArray getPathsFromEntry(const ADGameDescription *g);
 	bool isEntryGrayListed(const ADGameDescription *g) const;
 	void detectClashes() const;
 
+	/**
+	 * Return the indices (in ascending order) of the detection entries
+	 * which may match the files in @p allFiles. All other entries lack
+	 * at least one of their files.
+	 */
+	void getCandidateDescriptions(const FileMap &allFiles, Common::Array<uint> &candidates) const;
+
 private:
 	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _grayListMap;
 	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _globsMap;
 	bool _hashMapsInited;
 
+	/**
+	 * Detection entries indexed by one of their plain files, the one
+	 * used by the fewest other entries.
+	 */
+	typedef Common::HashMap<Common::Path, Common::Array<uint>, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> DescriptionIndexMap;
+	DescriptionIndexMap _descriptionIndex;
+
+	/** Detection entries without any plain file, which are always checked. */
+	Common::Array<uint> _unindexedDescriptions;
+
 protected:
 	/**
 	 * Detect games in the specified directory.
@@ -586,6 +604,14 @@ protected:
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const;
 
+	/**
+	 * Compute the properties of all plain files referenced by the @p candidates
+	 * detection entries which are present in @p allFiles, spreading the work over the
+	 * worker threads. The results are stored in the MD5 cache, where
+	 * getFileProperties() finds them.
+	 */
+	void prefetchFileProperties(const FileMap &allFiles, const Common::Array<uint> &candidates) const;
+
 	/** Convert an AD game description into the shared game description format. */
 	virtual DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo = nullptr) const;
 
@@ -766,10 +792,16 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	AdvancedDetectorCacheManager() : _persistentLoaded(false), _persistentDirty(false), _persistentSaveDeferred(false) {
 		clear();
 	}
 
+	~AdvancedDetectorCacheManager() {
+		_persistentSaveDeferred = false;
+		savePersistentCache();
+		clearArchives();
+	}
+
 	void clearArchives() {
 		for (auto &entry : archiveHashMap) {
 			delete entry._value;
@@ -777,6 +809,36 @@ public:
 		archiveHashMap.clear(true);
 	}
 
+	/**
+	 * Look up the MD5 and size of a file in the persistent on-disk cache.
+	 *
+	 * The cache is stored next to the configuration file and survives
+	 * restarts. An entry is only returned if the size and the modification
+	 * time of the file on disk still match the ones recorded with it.
+	 */
+	bool getPersistentMD5(const Common::String &key, int64 fileSize, int64 mtime, Common::String &md5, int64 &size);
+
+	/**
+	 * Record the MD5 and size of a file in the persistent on-disk cache.
+	 */
+	void setPersistentMD5(const Common::String &key, const Common::Path &path, int64 fileSize, int64 mtime, const Common::String &md5, int64 size);
+
+	/**
+	 * Write the persistent cache back to disk, if it has been modified
+	 * and saving is not deferred. Entries of files which were changed are
+	 * dropped.
+	 */
+	void savePersistentCache();
+
+	/**
+	 * Defer writing the persistent cache, e.g. while many directories are
+	 * detected in a row. Ending the deferral writes the pending changes.
+	 */
+	void setPersistentCacheSaveDeferred(bool deferred) {
+		_persistentSaveDeferred = deferred;
+		savePersistentCache();
+	}
+
 	void clear() {
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
@@ -792,6 +854,25 @@ private:
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	struct PersistentEntry {
+		Common::Path path;
+		int64 fileSize;
+		int64 mtime;
+		int64 size;
+		Common::String md5;
+		bool used; ///< Looked up or stored by this session
+	};
+
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentHashMap;
+	PersistentHashMap _persistentHashMap;
+	bool _persistentLoaded;
+	bool _persistentDirty;
+	bool _persistentSaveDeferred;
+
+	bool isPersistentCacheEnabled() const;
+	Common::Path getPersistentCachePath() const;
+	void loadPersistentCache();
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
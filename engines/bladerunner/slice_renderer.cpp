@@ -29,6 +29,7 @@
 
 #include "common/memstream.h"
 #include "common/rect.h"
+#include "common/thread.h"
 #include "common/util.h"
 
 namespace BladeRunner {
@@ -58,8 +59,6 @@ SliceRenderer::SliceRenderer(BladeRunnerEngine *vm) {
 	_frameSliceCount   = 0;
 	_startSlice        = 0.0f;
 	_endSlice          = 0.0f;
-	_m13               = 0;
-	_m23               = 0;
 
 	_shadowPolygonDefault[ 0] = Vector3( 16.0f,  96.0f, 0.0f);
 	_shadowPolygonDefault[ 1] = Vector3( 16.0f, 160.0f, 0.0f);
@@ -411,20 +410,10 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 		&setEffectsColorCoeficient,
 		&setEffectColor);
 
-	_lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
-	_lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
-	_lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
-
-	_setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
-	_setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
-	_setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
-
 	setupLookupTable(_m12lookup, sliceLineIterator._sliceMatrix(0, 1));
 	setupLookupTable(_m11lookup, sliceLineIterator._sliceMatrix(0, 0));
-	_m13 = sliceLineIterator._sliceMatrix(0, 2);
 	setupLookupTable(_m21lookup, sliceLineIterator._sliceMatrix(1, 0));
 	setupLookupTable(_m22lookup, sliceLineIterator._sliceMatrix(1, 1));
-	_m23 = sliceLineIterator._sliceMatrix(1, 2);
 
 	if (_animationsShadowEnabled[_animation]) {
 		float coeficientShadow;
@@ -442,11 +431,12 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 
 	int frameY = sliceLineIterator._startY;
 
-	uint16 *zBufferLinePtr = zbuffer + BladeRunnerEngine::kOriginalGameWidth * frameY;
+	// Lights and set effects are evaluated incrementally from line to line,
+	// so they are calculated for all lines first. The lines are then drawn
+	// independently of each other.
+	_lines.clear();
 
 	while (sliceLineIterator._currentY <= sliceLineIterator._endY) {
-		_m13 = sliceLineIterator._sliceMatrix(0, 2);
-		_m23 = sliceLineIterator._sliceMatrix(1, 2);
 		sliceLine = sliceLineIterator.line();
 
 		sliceRendererLights.calculateColorSlice(Vector3(_position.x, _position.y, _position.z + _frameBottomZ + sliceLine * _frameSliceHeight));
@@ -459,21 +449,76 @@ void SliceRenderer::drawInWorld(int animationId, int animationFrame, Vector3 pos
 				&setEffectColor);
 		}
 
-		_lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
-		_lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
-		_lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
+		if (frameY >= 0 && frameY < surface.h) {
+			SliceLine line;
+			line._y     = frameY;
+			line._slice = (int)sliceLine;
+			line._m13   = sliceLineIterator._sliceMatrix(0, 2);
+			line._m23   = sliceLineIterator._sliceMatrix(1, 2);
 
-		_setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
-		_setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
-		_setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
+			line._lightsColor.r = setEffectsColorCoeficient * sliceRendererLights._finalColor.r * 65536.0f;
+			line._lightsColor.g = setEffectsColorCoeficient * sliceRendererLights._finalColor.g * 65536.0f;
+			line._lightsColor.b = setEffectsColorCoeficient * sliceRendererLights._finalColor.b * 65536.0f;
 
-		if (frameY >= 0 && frameY < surface.h) {
-			drawSlice((int)sliceLine, true, frameY, surface, zBufferLinePtr);
+			line._setEffectColor.r = setEffectColor.r * 31.0f * 65536.0f;
+			line._setEffectColor.g = setEffectColor.g * 31.0f * 65536.0f;
+			line._setEffectColor.b = setEffectColor.b * 31.0f * 65536.0f;
+
+			_lines.push_back(line);
 		}
 
 		sliceLineIterator.advance();
 		++frameY;
-		zBufferLinePtr += BladeRunnerEngine::kOriginalGameWidth;
+	}
+
+	drawLines(surface, zbuffer);
+}
+
+// Drawing fewer lines than this per thread is not worth starting threads for
+static const uint kMinLinesPerBand = 32;
+
+namespace {
+
+struct DrawLinesParams {
+	SliceRenderer     *renderer;
+	Graphics::Surface *surface;
+	uint16            *zbuffer;
+	uint               bandCount;
+};
+
+} // End of anonymous namespace
+
+void SliceRenderer::drawLines(Graphics::Surface &surface, uint16 *zbuffer) {
+	// Every line only writes to its own row of the surface and the z-buffer,
+	// so bands of lines can be drawn by different threads in any order
+	uint bandCount = MIN<uint>(Common::getWorkerThreadCount(), _lines.size() / kMinLinesPerBand);
+
+	if (bandCount <= 1) {
+		for (uint i = 0; i < _lines.size(); ++i) {
+			drawSlice(_lines[i], true, surface, zbuffer + BladeRunnerEngine::kOriginalGameWidth * _lines[i]._y);
+		}
+		return;
+	}
+
+	DrawLinesParams params;
+	params.renderer  = this;
+	params.surface   = &surface;
+	params.zbuffer   = zbuffer;
+	params.bandCount = bandCount;
+	Common::runParallelJobs(bandCount, drawLinesJob, &params);
+}
+
+void SliceRenderer::drawLinesJob(void *param, uint band) {
+	const DrawLinesParams *params = (const DrawLinesParams *)param;
+	SliceRenderer *renderer = params->renderer;
+
+	uint lineCount = renderer->_lines.size();
+	uint first = lineCount * band / params->bandCount;
+	uint end = lineCount * (band + 1) / params->bandCount;
+
+	for (uint i = first; i < end; ++i) {
+		const SliceLine &line = renderer->_lines[i];
+		renderer->drawSlice(line, true, *params->surface, params->zbuffer + BladeRunnerEngine::kOriginalGameWidth * line._y);
 	}
 }
 
@@ -514,10 +559,12 @@ void SliceRenderer::drawOnScreen(int animationId, int animationFrame, int screen
 
 	setupLookupTable(_m11lookup, m(0, 0));
 	setupLookupTable(_m12lookup, m(0, 1));
-	_m13 = m(0, 2);
 	setupLookupTable(_m21lookup, m(1, 0));
 	setupLookupTable(_m22lookup, m(1, 1));
-	_m23 = m(1, 2);
+
+	SliceLine line;
+	line._m13 = m(0, 2);
+	line._m23 = m(1, 2);
 
 	int frameY = screenY + (size / 2.0f * frameHeight);
 	int currentY = frameY;
@@ -530,21 +577,25 @@ void SliceRenderer::drawOnScreen(int animationId, int animationFrame, int screen
 	while (currentSlice < _frameSliceCount) {
 		if (currentY >= 0 && currentY < surface.h) {
 			memset(lineZbuffer, 0xFF, BladeRunnerEngine::kOriginalGameWidth * 2);
-			drawSlice(currentSlice, false, currentY, surface, lineZbuffer);
+			line._y     = currentY;
+			line._slice = currentSlice;
+			drawSlice(line, false, surface, lineZbuffer);
 			currentSlice += sliceStep;
 			--currentY;
 		}
 	}
 }
 
-void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface &surface, uint16 *zbufferLine) {
-	if (slice < 0 || (uint32)slice >= _frameSliceCount) {
+void SliceRenderer::drawSlice(const SliceLine &line, bool advanced, Graphics::Surface &surface, uint16 *zbufferLine) {
+	if (line._slice < 0 || (uint32)line._slice >= _frameSliceCount) {
 		return;
 	}
 
+	const int y = line._y;
+
 	SliceAnimations::Palette &palette = _vm->_sliceAnimations->getPalette(_framePaletteIndex);
 
-	byte *p = (byte *)_sliceFramePtr + 0x20 + 4 * slice;
+	byte *p = (byte *)_sliceFramePtr + 0x20 + 4 * line._slice;
 
 	uint32 polyOffset = READ_LE_UINT32(p);
 
@@ -561,15 +612,15 @@ void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface
 			continue;
 
 		uint32 lastVertex = vertexCount - 1;
-		int lastVertexX = MAX((_m11lookup[p[3 * lastVertex]] + _m12lookup[p[3 * lastVertex + 1]] + _m13) / 65536, 0);
+		int lastVertexX = MAX((_m11lookup[p[3 * lastVertex]] + _m12lookup[p[3 * lastVertex + 1]] + line._m13) / 65536, 0);
 
 		int previousVertexX = lastVertexX;
 
 		while (vertexCount--) {
-			int vertexX = CLIP<int32>((_m11lookup[p[0]] + _m12lookup[p[1]] + _m13) / 65536, 0, BladeRunnerEngine::kOriginalGameWidth);
+			int vertexX = CLIP<int32>((_m11lookup[p[0]] + _m12lookup[p[1]] + line._m13) / 65536, 0, BladeRunnerEngine::kOriginalGameWidth);
 
 			if (vertexX > previousVertexX) {
-				int vertexZ = (_m21lookup[p[0]] + _m22lookup[p[1]] + _m23) / 64;
+				int vertexZ = (_m21lookup[p[0]] + _m22lookup[p[1]] + line._m23) / 64;
 
 				if (vertexZ >= 0 && vertexZ < 65536) {
 					uint32 outColor = palette.value[p[2]];
@@ -578,9 +629,9 @@ void SliceRenderer::drawSlice(int slice, bool advanced, int y, Graphics::Surface
 						_screenEffects->getColor(&aescColor, vertexX, y, vertexZ);
 
 						Color256 color = palette.color[p[2]];
-						color.r = ((int)(_setEffectColor.r + _lightsColor.r * color.r) / 65536) + aescColor.r;
-						color.g = ((int)(_setEffectColor.g + _lightsColor.g * color.g) / 65536) + aescColor.g;
-						color.b = ((int)(_setEffectColor.b + _lightsColor.b * color.b) / 65536) + aescColor.b;
+						color.r = ((int)(line._setEffectColor.r + line._lightsColor.r * color.r) / 65536) + aescColor.r;
+						color.g = ((int)(line._setEffectColor.g + line._lightsColor.g * color.g) / 65536) + aescColor.g;
+						color.b = ((int)(line._setEffectColor.b + line._lightsColor.b * color.b) / 65536) + aescColor.b;
 						// We need to convert from 5 bits per channel (r,g,b) to 8 bits
 						outColor = _pixelFormat.RGBToColor(Color::get8BitColorFrom5Bit(color.r), Color::get8BitColorFrom5Bit(color.g), Color::get8BitColorFrom5Bit(color.b));
 					}
@@ -27,6 +27,7 @@
 #include "bladerunner/view.h"
 #include "bladerunner/matrix.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 #include "graphics/surface.h"
@@ -43,6 +44,16 @@ class Lights;
 class SetEffects;
 
 class SliceRenderer {
+	// Everything drawSlice needs to draw one screen line of a frame
+	struct SliceLine {
+		int   _y;
+		int   _slice;
+		int   _m13;
+		int   _m23;
+		Color _setEffectColor;
+		Color _lightsColor;
+	};
+
 	BladeRunnerEngine *_vm;
 
 	int       _animation;
@@ -75,19 +86,17 @@ class SliceRenderer {
 
 	int _m11lookup[256];
 	int _m12lookup[256];
-	int _m13;
 	int _m21lookup[256];
 	int _m22lookup[256];
-	int _m23;
+
+	// Lines of the frame being drawn by drawInWorld
+	Common::Array<SliceLine> _lines;
 
 	bool _animationsShadowEnabled[997];
 
 	Vector3 _shadowPolygonDefault[12];
 	Vector3 _shadowPolygonCurrent[12];
 
-	Color _setEffectColor;
-	Color _lightsColor;
-
 	Graphics::PixelFormat _pixelFormat;
 
 public:
@@ -113,7 +122,9 @@ private:
 	Matrix3x2 calculateFacingRotationMatrix();
 	void loadFrame(int animation, int frame);
 
-	void drawSlice(int slice, bool advanced, int y, Graphics::Surface &surface, uint16 *zbufferLine);
+	void drawLines(Graphics::Surface &surface, uint16 *zbuffer);
+	static void drawLinesJob(void *param, uint band);
+	void drawSlice(const SliceLine &line, bool advanced, Graphics::Surface &surface, uint16 *zbufferLine);
 	void drawShadowInWorld(int transparency, Graphics::Surface &surface, uint16 *zbuffer);
 	void drawShadowPolygon(int transparency, Graphics::Surface &surface, uint16 *zbuffer);
 };
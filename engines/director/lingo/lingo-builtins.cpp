@@ -2032,6 +2032,7 @@ void LB::b_clearGlobals(int nargs) {
 			g_lingo->_globalvars.erase(it._key);
 		}
 	}
+	g_lingo->clearGlobalSlots();
 }
 
 void LB::b_cursor(int nargs) {
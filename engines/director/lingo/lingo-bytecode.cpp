@@ -77,16 +77,16 @@ static LingoV4Bytecode lingoV4[] = {
 	// 0x44, push a constant
 	{ 0x45, LC::c_namepush,		"bN" },
 	{ 0x46, LC::cb_varrefpush,  "bN" },
-	{ 0x48, LC::cb_globalpush,	"bN" }, // used in event scripts
-	{ 0x49, LC::cb_globalpush,	"bN" },
+	{ 0x48, LC::c_globalslotpush,"bG" }, // used in event scripts
+	{ 0x49, LC::c_globalslotpush,"bG" },
 	{ 0x4a, LC::cb_thepush,		"bN" },
-	{ 0x4b, LC::cb_varpush,		"bpaN" },
-	{ 0x4c, LC::cb_varpush,		"bpvN" },
-	{ 0x4e, LC::cb_globalassign,"bN" }, // used in event scripts
-	{ 0x4f, LC::cb_globalassign,"bN" },
+	{ 0x4b, LC::c_localslotpush,"bpA" },
+	{ 0x4c, LC::c_localslotpush,"bpV" },
+	{ 0x4e, LC::c_globalslotassign,"bG" }, // used in event scripts
+	{ 0x4f, LC::c_globalslotassign,"bG" },
 	{ 0x50, LC::cb_theassign,	"bN" },
-	{ 0x51, LC::cb_varassign,	"bpaN" },
-	{ 0x52, LC::cb_varassign,	"bpvN" },
+	{ 0x51, LC::c_localslotassign,"bpA" },
+	{ 0x52, LC::c_localslotassign,"bpV" },
 	{ 0x53, LC::c_jump,			"jb" },
 	{ 0x54, LC::c_jump,			"jbn" },
 	{ 0x55, LC::c_jumpifz,		"jb" },
@@ -113,16 +113,16 @@ static LingoV4Bytecode lingoV4[] = {
 	// 0x84, push a constant
 	{ 0x85, LC::c_namepush,		"wN" },
 	{ 0x86, LC::cb_varrefpush,  "wN" },
-	{ 0x88, LC::cb_globalpush,	"wN" }, // used in event scripts
-	{ 0x89, LC::cb_globalpush,	"wN" },
+	{ 0x88, LC::c_globalslotpush,"wG" }, // used in event scripts
+	{ 0x89, LC::c_globalslotpush,"wG" },
 	{ 0x8a, LC::cb_thepush,		"wN" },
-	{ 0x8b, LC::cb_varpush,		"wpaN" },
-	{ 0x8c, LC::cb_varpush,		"wpvN" },
-	{ 0x8e, LC::cb_globalassign,"wN" }, // used in event scripts
-	{ 0x8f, LC::cb_globalassign,"wN" },
+	{ 0x8b, LC::c_localslotpush,"wpA" },
+	{ 0x8c, LC::c_localslotpush,"wpV" },
+	{ 0x8e, LC::c_globalslotassign,"wG" }, // used in event scripts
+	{ 0x8f, LC::c_globalslotassign,"wG" },
 	{ 0x90, LC::cb_theassign, 	"wN" },
-	{ 0x91, LC::cb_varassign,	"wpaN" },
-	{ 0x92, LC::cb_varassign,	"wpvN" },
+	{ 0x91, LC::c_localslotassign,"wpA" },
+	{ 0x92, LC::c_localslotassign,"wpV" },
 	{ 0x93, LC::c_jump,			"jw" },
 	{ 0x94, LC::c_jump,			"jwn" },
 	{ 0x95, LC::c_jumpifz,		"jw" },
@@ -550,25 +550,6 @@ void LC::cb_call() {
 }
 
 
-void LC::cb_globalpush() {
-	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = GLOBALREF;
-	debugC(3, kDebugLingoExec, "cb_globalpush: pushing %s to stack", name.c_str());
-	Datum result = g_lingo->varFetch(target);
-	g_lingo->push(result);
-}
-
-
-void LC::cb_globalassign() {
-	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = GLOBALREF;
-	debugC(3, kDebugLingoExec, "cb_globalassign: assigning to %s", name.c_str());
-	Datum source = g_lingo->pop();
-	g_lingo->varAssign(target, source);
-}
-
 void LC::cb_objectfieldassign() {
 	Common::String fieldName = g_lingo->readString();
 	Datum value = g_lingo->pop();
@@ -652,27 +633,6 @@ void LC::cb_thepush2() {
 	g_lingo->push(result);
 }
 
-void LC::cb_varpush() {
-	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = LOCALREF;
-	debugC(3, kDebugLingoExec, "cb_varpush: pushing %s to stack", name.c_str());
-	Datum result = g_lingo->varFetch(target);
-	g_lingo->push(result);
-}
-
-
-void LC::cb_varassign() {
-	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = LOCALREF;
-	debugC(3, kDebugLingoExec, "cb_varassign: assigning to %s", name.c_str());
-	Datum source = g_lingo->pop();
-	// Local variables should be initialised by the script, no varCreate here
-	g_lingo->varAssign(target, source);
-}
-
-
 void LC::cb_v4assign2() {
 int arg = g_lingo->readInt();
 	int op = (arg >> 4) & 0xF;
@@ -1539,6 +1499,26 @@ ScriptContext *LingoCompiler::compileLingoV4(Common::SeekableReadStreamEndian &s
 								arg = -1;
 							}
 							break;
+						case 'A':
+							// argument is a function argument ID, code its local slot
+							if (arg >= (int)argNames->size()) {
+								warning("No argument found for ID %d", arg);
+								arg = -1;
+							}
+							break;
+						case 'V':
+							// argument is a local variable ID, code its local slot
+							if (arg < (int)varNames->size()) {
+								arg += argNames->size();
+							} else {
+								warning("No variable found for ID %d", arg);
+								arg = -1;
+							}
+							break;
+						case 'G':
+							// argument is a global name in the name table, code its slot
+							arg = g_lingo->getGlobalSlot(_assemblyArchive->getName(arg));
+							break;
 						case 'j':
 							// argument refers to a code offset; fix alignment in post
 							jumpList.push_back(offsetList.size());
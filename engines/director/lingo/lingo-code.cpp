@@ -90,6 +90,8 @@ static struct FuncDescr {
 	{ LC::c_globalinit,		"c_globalinit",		"s" },
 	{ LC::c_globalpush,		"c_globalpush",		"s" },
 	{ LC::c_globalrefpush,	"c_globalrefpush",	"s" },
+	{ LC::c_globalslotassign,"c_globalslotassign","i" },
+	{ LC::c_globalslotpush,	"c_globalslotpush",	"i" },
 	{ LC::c_ge,				"c_ge",				"" },
 	{ LC::c_gt,				"c_gt",				"" },
 	{ LC::c_hilite,			"c_hilite",			"" },
@@ -104,6 +106,8 @@ static struct FuncDescr {
 	{ LC::c_lineToOfRef,	"c_lineToOfRef",	"" },	// D3
 	{ LC::c_localpush,		"c_localpush",		"s" },
 	{ LC::c_localrefpush,	"c_localrefpush",	"s" },
+	{ LC::c_localslotassign,"c_localslotassign","i" },
+	{ LC::c_localslotpush,	"c_localslotpush",	"i" },
 	{ LC::c_lt,				"c_lt",				"" },
 	{ LC::c_mod,			"c_mod",			"" },
 	{ LC::c_mul,			"c_mul",			"" },
@@ -142,8 +146,6 @@ static struct FuncDescr {
 	{ LC::cb_call,			"cb_call",			"s" },
 	{ LC::cb_delete,		"cb_delete",		"i" },
 	{ LC::cb_hilite,		"cb_hilite",		"" },
-	{ LC::cb_globalassign,	"cb_globalassign",	"s" },
-	{ LC::cb_globalpush,	"cb_globalpush",	"s" },
 	{ LC::cb_list,			"cb_list",			"" },
 	{ LC::cb_proplist,		"cb_proplist",		"" },
 	{ LC::cb_localcall,		"cb_localcall",		"i" },
@@ -158,8 +160,6 @@ static struct FuncDescr {
 	{ LC::cb_unk,			"cb_unk",			"i" },
 	{ LC::cb_unk1,			"cb_unk1",			"ii" },
 	{ LC::cb_unk2,			"cb_unk2",			"iii" },
-	{ LC::cb_varassign,		"cb_varassign",		"s" },
-	{ LC::cb_varpush,		"cb_varpush",		"s" },
 	{ LC::cb_v4assign,		"cb_v4assign",		"i" },
 	{ LC::cb_v4assign2,		"cb_v4assign2",		"i" },
 	{ LC::cb_v4theentitypush,"cb_v4theentitypush","i" },
@@ -294,6 +294,16 @@ void Lingo::pushContext(const Symbol funcSym, bool allowRetVal, Datum defaultRet
 			}
 		}
 	}
+	// Compiled handlers access their arguments and variables by slot. Entries
+	// of the hash do not move, so the slots can point right into it.
+	if (funcSym.argNames) {
+		for (auto &it : *funcSym.argNames)
+			fp->localSlots.push_back(&localvars->getVal(it));
+	}
+	if (funcSym.varNames) {
+		for (auto &it : *funcSym.varNames)
+			fp->localSlots.push_back(&localvars->getVal(it));
+	}
 	_state->localVars = localvars;
 
 	fp->stackSizeBefore = _stack.size();
@@ -538,6 +548,28 @@ void LC::c_proppush() {
 	g_lingo->push(g_lingo->varFetch(d));
 }
 
+void LC::c_localslotpush() {
+	int slot = g_lingo->readInt();
+	g_lingo->push(g_lingo->localSlotFetch(slot));
+}
+
+void LC::c_localslotassign() {
+	int slot = g_lingo->readInt();
+	Datum d = g_lingo->pop();
+	g_lingo->localSlotAssign(slot, d);
+}
+
+void LC::c_globalslotpush() {
+	int slot = g_lingo->readInt();
+	g_lingo->push(g_lingo->globalSlotFetch(slot));
+}
+
+void LC::c_globalslotassign() {
+	int slot = g_lingo->readInt();
+	Datum d = g_lingo->pop();
+	g_lingo->globalSlotAssign(slot, d);
+}
+
 void LC::c_stackpeek() {
 	int peekOffset = g_lingo->readInt();
 	g_lingo->push(g_lingo->peek(peekOffset));
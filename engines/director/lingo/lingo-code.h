@@ -84,6 +84,10 @@ void c_globalinit();
 void c_globalpush();
 void c_localpush();
 void c_proppush();
+void c_localslotpush();
+void c_localslotassign();
+void c_globalslotpush();
+void c_globalslotassign();
 void c_argcpush();
 void c_argcnoretpush();
 void c_arraypush();
@@ -151,8 +155,6 @@ void cb_unk2();
 void cb_call();
 void cb_delete();
 void cb_hilite();
-void cb_globalassign();
-void cb_globalpush();
 void cb_list();
 void cb_localcall();
 void cb_objectcall();
@@ -164,8 +166,6 @@ void cb_theassign2();
 void cb_thepush();
 void cb_thepush2();
 void cb_proplist();
-void cb_varassign();
-void cb_varpush();
 void cb_v4assign();
 void cb_v4assign2();
 void cb_v4theentitypush();
@@ -339,6 +339,22 @@ int LingoCompiler::codeFunc(const Common::String &s, int numpar) {
 
 void LingoCompiler::codeVarSet(const Common::String &name) {
 	registerMethodVar(name);
+	switch ((*_methodVars)[name]) {
+	case kVarGlobal:
+		code1(LC::c_globalslotassign);
+		codeInt(g_lingo->getGlobalSlot(name));
+		return;
+	case kVarLocal:
+	case kVarArgument:
+		if (_methodVarSlots.contains(name)) {
+			code1(LC::c_localslotassign);
+			codeInt(_methodVarSlots[name]);
+			return;
+		}
+		break;
+	default:
+		break;
+	}
 	codeVarRef(name);
 	code1(LC::c_assign);
 }
@@ -383,10 +399,16 @@ void LingoCompiler::codeVarGet(const Common::String &name) {
 		code1(LC::c_varpush);
 		break;
 	case kVarGlobal:
-		code1(LC::c_globalpush);
-		break;
+		code1(LC::c_globalslotpush);
+		codeInt(g_lingo->getGlobalSlot(name));
+		return;
 	case kVarLocal:
 	case kVarArgument:
+		if (_methodVarSlots.contains(name)) {
+			code1(LC::c_localslotpush);
+			codeInt(_methodVarSlots[name]);
+			return;
+		}
 		code1(LC::c_localpush);
 		break;
 	case kVarProperty:
@@ -397,10 +419,21 @@ void LingoCompiler::codeVarGet(const Common::String &name) {
 	codeString(name.c_str());
 }
 
+bool LingoCompiler::isVarConst(const Common::String &name) {
+	// Names which visitVarNode() codes as constants
+	if (g_director->getVersion() < 400 || (g_director->getCurrentMovie() && g_director->getCurrentMovie()->_allowOutdatedLingo)) {
+		if (castNumToNum(name.c_str()) != -1)
+			return true;
+	}
+	return g_lingo->_builtinConsts.contains(name);
+}
+
 void LingoCompiler::registerMethodVar(const Common::String &name, VarType type) {
 	if (!_methodVars->contains(name)) {
 		if (_indef && type == kVarGeneric) {
 			type = kVarLocal;
+			_methodVarSlots[name] = _methodSlotNames.size();
+			_methodSlotNames.push_back(name);
 		}
 		(*_methodVars)[name] = type;
 		if (type == kVarProperty || type == kVarInstance) {
@@ -481,11 +514,23 @@ bool LingoCompiler::visitHandlerNode(HandlerNode *node) {
 	VarTypeHash *mainMethodVars = _methodVars;
 	_methodVars = new VarTypeHash;
 
+	Common::Array<Common::String> *argNames = new Common::Array<Common::String>;
 	if (_inFactory) {
-		registerMethodVar("me", kVarArgument);
+		argNames->push_back("me");
 	}
 	for (uint i = 0; i < node->args->size(); i++) {
-		registerMethodVar(*(*node->args)[i], kVarArgument);
+		argNames->push_back(Common::String((*node->args)[i]->c_str()));
+	}
+
+	// Arguments take the first slots, local variables follow as they are
+	// registered. See Lingo::pushContext().
+	_methodVarSlots.clear();
+	_methodSlotNames.clear();
+	for (uint i = 0; i < argNames->size(); i++) {
+		registerMethodVar((*argNames)[i], kVarArgument);
+		if (!_methodVarSlots.contains((*argNames)[i]))
+			_methodVarSlots[(*argNames)[i]] = i;
+		_methodSlotNames.push_back((*argNames)[i]);
 	}
 	for (auto &i : *mainMethodVars) {
 		if (i._value == kVarGlobal)
@@ -501,17 +546,9 @@ bool LingoCompiler::visitHandlerNode(HandlerNode *node) {
 	if (debugChannelSet(1, kDebugCompile))
 		debug("define handler \"%s\" (len: %d)", node->name->c_str(), _currentAssembly->size() - 1);
 
-	Common::Array<Common::String> *argNames = new Common::Array<Common::String>;
-	if (_inFactory) {
-		argNames->push_back("me");
-	}
-	for (uint i = 0; i < node->args->size(); i++) {
-		argNames->push_back(Common::String((*node->args)[i]->c_str()));
-	}
 	Common::Array<Common::String> *varNames = new Common::Array<Common::String>;
-	for (auto &it : *_methodVars) {
-		if (it._value == kVarLocal)
-			varNames->push_back(Common::String(it._key));
+	for (uint i = argNames->size(); i < _methodSlotNames.size(); i++) {
+		varNames->push_back(_methodSlotNames[i]);
 	}
 
 	if (debugChannelSet(1, kDebugCompile)) {
@@ -534,6 +571,8 @@ bool LingoCompiler::visitHandlerNode(HandlerNode *node) {
 	_currentAssembly = mainAssembly;
 	delete _methodVars;
 	_methodVars = mainMethodVars;
+	_methodVarSlots.clear();
+	_methodSlotNames.clear();
 	return true;
 }
 
@@ -622,6 +661,10 @@ bool LingoCompiler::visitPutIntoNode(PutIntoNode *node) {
 		registerMethodVar(*static_cast<VarNode *>(node->var)->name);
 	}
 	COMPILE(node->val);
+	if (node->var->type == kVarNode && !isVarConst(*static_cast<VarNode *>(node->var)->name)) {
+		codeVarSet(*static_cast<VarNode *>(node->var)->name);
+		return true;
+	}
 	COMPILE_REF(node->var);
 	code1(LC::c_assign);
 	return true;
@@ -822,6 +865,10 @@ bool LingoCompiler::visitSetNode(SetNode *node) {
 		registerMethodVar(*static_cast<VarNode *>(node->var)->name);
 	}
 	COMPILE(node->val);
+	if (node->var->type == kVarNode && !isVarConst(*static_cast<VarNode *>(node->var)->name)) {
+		codeVarSet(*static_cast<VarNode *>(node->var)->name);
+		return true;
+	}
 	COMPILE_REF(node->var);
 	code1(LC::c_assign);
 	return true;
@@ -49,6 +49,7 @@ public:
 	void codeVarRef(const Common::String &name);
 	void codeVarGet(const Common::String &name);
 	int getTheFieldID(int entity, const Common::String &field, bool silent = false);
+	bool isVarConst(const Common::String &name);
 	void registerFactory(Common::String &s);
 	void registerMethodVar(const Common::String &name, VarType type = kVarGeneric);
 	void updateLoopJumps(uint nextTargetPos, uint exitTargetPos);
@@ -68,6 +69,9 @@ public:
 	bool _refMode;
 
 	Common::HashMap<Common::String, VarType, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> *_methodVars;
+	// Slots of the arguments and local variables of the handler being compiled
+	Common::HashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _methodVarSlots;
+	Common::Array<Common::String> _methodSlotNames;
 
 	bool _hadError;
 
@@ -1803,6 +1803,77 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 	return result;
 }
 
+// Arguments and local variables referenced by slot, in the order of
+// argNames followed by varNames. See Lingo::pushContext().
+static Common::String localSlotName(const CFrame *fp, int slot) {
+	int argCount = fp->sp.argNames ? (int)fp->sp.argNames->size() : 0;
+	if (slot < argCount)
+		return (*fp->sp.argNames)[slot];
+	return (*fp->sp.varNames)[slot - argCount];
+}
+
+Datum Lingo::localSlotFetch(int slot) {
+	Common::Array<CFrame *> &callstack = _state->callstack;
+	if (callstack.empty() || slot < 0 || slot >= (int)callstack.back()->localSlots.size()) {
+		warning("localSlotFetch: invalid local variable slot %d", slot);
+		return Datum();
+	}
+	CFrame *fp = callstack.back();
+	g_debugger->varReadHook(localSlotName(fp, slot));
+	return *fp->localSlots[slot];
+}
+
+void Lingo::localSlotAssign(int slot, const Datum &value) {
+	Common::Array<CFrame *> &callstack = _state->callstack;
+	if (callstack.empty() || slot < 0 || slot >= (int)callstack.back()->localSlots.size()) {
+		warning("localSlotAssign: invalid local variable slot %d", slot);
+		return;
+	}
+	CFrame *fp = callstack.back();
+	*fp->localSlots[slot] = value;
+	g_debugger->varWriteHook(localSlotName(fp, slot));
+}
+
+int Lingo::getGlobalSlot(const Common::String &name) {
+	if (_globalSlotIds.contains(name))
+		return _globalSlotIds[name];
+
+	GlobalSlot slot;
+	slot.name = name;
+	slot.value = nullptr;
+	_globalSlots.push_back(slot);
+	_globalSlotIds[name] = _globalSlots.size() - 1;
+	return _globalSlots.size() - 1;
+}
+
+Datum Lingo::globalSlotFetch(int slot) {
+	GlobalSlot &global = _globalSlots[slot];
+	g_debugger->varReadHook(global.name);
+	if (!global.value) {
+		// Entries of _globalvars do not move, so keep a pointer to
+		// the variable once it exists
+		if (!_globalvars.contains(global.name)) {
+			debugC(1, kDebugLingoExec, "globalSlotFetch: global variable %s not defined", global.name.c_str());
+			return Datum();
+		}
+		global.value = &_globalvars.getVal(global.name);
+	}
+	return *global.value;
+}
+
+void Lingo::globalSlotAssign(int slot, const Datum &value) {
+	GlobalSlot &global = _globalSlots[slot];
+	if (!global.value)
+		global.value = &_globalvars.getOrCreateVal(global.name);
+	*global.value = value;
+}
+
+void Lingo::clearGlobalSlots() {
+	// Called whenever variables are removed from _globalvars
+	for (uint i = 0; i < _globalSlots.size(); i++)
+		_globalSlots[i].value = nullptr;
+}
+
 Common::U32String Lingo::evalChunkRef(const Datum &var) {
 	Common::U32String result;
 
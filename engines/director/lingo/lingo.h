@@ -258,6 +258,12 @@ struct CFrame {	/* proc/func call stack frame */
 	Datum			defaultRetVal;		/* default return value */
 	int				paramCount;			/* original number of arguments submitted */
 	Common::Array<Datum> paramList;		/* original argument list */
+	Common::Array<Datum *> localSlots;	/* args, then local vars, in the local var hash */
+};
+
+struct GlobalSlot {
+	Common::String name;
+	Datum *value;						/* entry in _globalvars, or nullptr if not looked up yet */
 };
 
 struct LingoEvent {
@@ -416,6 +422,12 @@ public:
 	Datum varFetch(const Datum &var, bool silent = false);
 	Common::U32String evalChunkRef(const Datum &var);
 	Datum findVarV4(int varType, const Datum &id);
+	Datum localSlotFetch(int slot);
+	void localSlotAssign(int slot, const Datum &value);
+	int getGlobalSlot(const Common::String &name);
+	Datum globalSlotFetch(int slot);
+	void globalSlotAssign(int slot, const Datum &value);
+	void clearGlobalSlots();
 	CastMemberID resolveCastMember(const Datum &memberID, const Datum &castLib, CastType type);
 	void exposeXObject(const char *name, Datum obj);
 
@@ -539,6 +551,10 @@ public:
 
 	DatumHash _globalvars;
 
+	// Globals referenced by slot from compiled scripts, see getGlobalSlot()
+	Common::Array<GlobalSlot> _globalSlots;
+	Common::HashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _globalSlotIds;
+
 	FuncHash _functions;
 
 	Common::HashMap<int, LingoV4Bytecode *> _lingoV4;
@@ -115,6 +115,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
@@ -163,6 +164,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -355,6 +357,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_cache - Shows the resource cache budget and hit, miss and eviction counters\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
@@ -398,6 +401,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows garbage collector timings and counters\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -1201,6 +1205,35 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		resMan->resetCacheStatistics();
+		debugPrintf("Resource cache statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows the resource cache budget and hit, miss and eviction counters.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const ResourceManager::CacheStatistics &stats = resMan->getCacheStatistics();
+	debugPrintf("Cached: %d KB of %d KB", resMan->getMemoryLRU() / 1024, resMan->getMaxMemoryLRU() / 1024);
+	if (resMan->isMemoryLRUAdaptive())
+		debugPrintf(" (adaptive, up to %d KB)\n", resMan->getMaxMemoryLRULimit() / 1024);
+	else
+		debugPrintf(" (fixed)\n");
+	debugPrintf("Locked: %d KB\n", resMan->getMemoryLocked() / 1024);
+
+	const uint32 requests = stats.hits + stats.misses;
+	debugPrintf("Requests: %d, hits: %d (%d%%), misses: %d\n", requests, stats.hits,
+		requests ? stats.hits * 100 / requests : 0, stats.misses);
+	debugPrintf("Evictions: %d, reloads of evicted resources: %d\n", stats.evictions, stats.reloads);
+	debugPrintf("Prefetched: %d, used afterwards: %d, queued: %d\n", stats.prefetches, stats.prefetchHits, resMan->getPrefetchQueueSize());
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2828,7 +2861,37 @@ bool Console::cmdIsSample(int argc, const char **argv) {
 
 bool Console::cmdGCInvoke(int argc, const char **argv) {
 	debugPrintf("Performing garbage collection...\n");
+	const GCStatistics &stats = _engine->_gamestate->_gc->getStatistics();
+	const uint32 freedBefore = stats.totalFreed;
 	run_gc(_engine->_gamestate);
+
+	debugPrintf("Marked %d reachable addresses in %d ms, freed %d objects\n",
+		stats.lastReachable, stats.lastMarkTime, stats.totalFreed - freedBefore);
+	return true;
+}
+
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GarbageCollector *gc = _engine->_gamestate->_gc;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		gc->resetStatistics();
+		debugPrintf("Garbage collector statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows garbage collector timings and counters.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const GCStatistics &stats = gc->getStatistics();
+	debugPrintf("Collections: %d, next one in %d kernel calls\n", stats.collections, _engine->_gamestate->gcCountDown);
+	if (stats.collections) {
+		debugPrintf("Mark time: last %d ms, max %d ms, average %d ms\n",
+			stats.lastMarkTime, stats.maxMarkTime, stats.totalMarkTime / stats.collections);
+	}
+	debugPrintf("Sweep time: %d ms in total\n", stats.totalSweepTime);
+	debugPrintf("Last collection: %d reachable addresses, %d unreachable objects\n", stats.lastReachable, stats.lastGarbage);
+	debugPrintf("Freed objects: %d, %d waiting to be freed\n", stats.totalFreed, gc->getPendingGarbage());
 	return true;
 }
 
@@ -21,6 +21,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -67,20 +68,16 @@ void WorklistManager::pushArray(const Common::Array<reg_t> &tmp) {
 		push(*it);
 }
 
-static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map) {
-	AddrSet *normal_map = new AddrSet();
-
+static void normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map, AddrSet &normal_map) {
 	for (AddrSet::const_iterator i = nonnormal_map.begin(); i != nonnormal_map.end(); ++i) {
 		reg_t reg = i->_key;
 		SegmentObj *mobj = segMan->getSegmentObj(reg.getSegment());
 
 		if (mobj) {
 			reg = mobj->findCanonicAddress(segMan, reg);
-			normal_map->setVal(reg, true);
+			normal_map.setVal(reg, true);
 		}
 	}
-
-	return normal_map;
 }
 
 static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap) {
@@ -98,11 +95,9 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void findActiveReferences(EngineState *s, WorklistManager &wm, AddrSet &activeRefs) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -175,55 +170,157 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->processEngineHunkList(wm);
 
-	return normalizeAddresses(s->_segMan, wm._map);
+	normalizeAddresses(s->_segMan, wm._map, activeRefs);
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+	AddrSet *activeRefs = new AddrSet();
+	findActiveReferences(s, wm, *activeRefs);
+	return activeRefs;
 }
 
 void run_gc(EngineState *s) {
+	s->_gc->collect(s);
+}
+
+void GCStatistics::reset() {
+	collections = 0;
+	lastMarkTime = 0;
+	maxMarkTime = 0;
+	totalMarkTime = 0;
+	totalSweepTime = 0;
+	lastReachable = 0;
+	lastGarbage = 0;
+	totalFreed = 0;
+}
+
+GarbageCollector::GarbageCollector() : _sweepPos(0) {
+}
+
+void GarbageCollector::reset() {
+	_garbage.clear();
+	_sweepPos = 0;
+}
+
+void GarbageCollector::startCollection(EngineState *s) {
+	// Garbage left over from the previous collection is freed first, so
+	// that it does not show up a second time
+	sweep(s->_segMan, getPendingGarbage());
+	mark(s);
+	sweep(s->_segMan, kSweepStep);
+}
+
+void GarbageCollector::collect(EngineState *s) {
+	sweep(s->_segMan, getPendingGarbage());
+	mark(s);
+	sweep(s->_segMan, getPendingGarbage());
+}
+
+void GarbageCollector::mark(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	const uint32 startTime = g_system->getMillis(true);
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
-#ifdef GC_DEBUG_CODE
-	const char *segnames[SEG_TYPE_MAX + 1];
-	int segcount[SEG_TYPE_MAX + 1];
-	memset(segnames, 0, sizeof(segnames));
-	memset(segcount, 0, sizeof(segcount));
-#endif
 
 	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	// The sets are cleared without shrinking them, as the next collection
+	// will need about the same amount of storage.
+	_wm._worklist.clear();
+	_wm._map.clear();
+	_activeRefs.clear();
+	findActiveReferences(s, _wm, _activeRefs);
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
+	_garbage.clear();
+	_sweepPos = 0;
+	uint freedScripts = 0;
+
 	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
 	for (uint seg = 1; seg < heap.size(); seg++) {
 		SegmentObj *mobj = heap[seg];
 
 		if (mobj != nullptr) {
-#ifdef GC_DEBUG_CODE
-			const SegmentType type = mobj->getType();
-			segnames[type] = segmentTypeNames[type];
-#endif
-
 			// Get a list of all deallocatable objects in this segment,
-			// then free any which are not referenced from somewhere.
+			// and remember any which are not referenced from somewhere.
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
-				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
-					// Not found -> we can free it
-					mobj->freeAtAddress(segMan, addr);
-					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
-#ifdef GC_DEBUG_CODE
-					segcount[type]++;
-#endif
+				if (_activeRefs.contains(*it))
+					continue;
+
+				if (mobj->getType() == SEG_TYPE_SCRIPT) {
+					// Deleted scripts are freed right away, since
+					// instantiateScript() may revive them before a
+					// deferred sweep. A script has a single entry.
+					mobj->freeAtAddress(segMan, *it);
+					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(*it));
+					_stats.totalFreed++;
+					freedScripts++;
+					break;
 				}
-			}
 
+				Garbage garbage;
+				garbage.addr = *it;
+				garbage.mobj = mobj;
+				_garbage.push_back(garbage);
+			}
 		}
 	}
 
-	delete activeRefs;
+	const uint32 markTime = g_system->getMillis(true) - startTime;
+	_stats.collections++;
+	_stats.lastMarkTime = markTime;
+	_stats.maxMarkTime = MAX(_stats.maxMarkTime, markTime);
+	_stats.totalMarkTime += markTime;
+	_stats.lastReachable = _activeRefs.size();
+	_stats.lastGarbage = _garbage.size() + freedScripts;
+
+	debugC(kDebugLevelGC, "[GC] Marked %d reachable addresses, found %d unreachable objects in %d ms",
+		_activeRefs.size(), _stats.lastGarbage, markTime);
+}
+
+void GarbageCollector::sweep(SegManager *segMan, uint maxObjects) {
+	if (!maxObjects)
+		return;
+
+	const uint32 startTime = g_system->getMillis(true);
+#ifdef GC_DEBUG_CODE
+	const char *segnames[SEG_TYPE_MAX + 1];
+	int segcount[SEG_TYPE_MAX + 1];
+	memset(segnames, 0, sizeof(segnames));
+	memset(segcount, 0, sizeof(segcount));
+#endif
+
+	const uint end = MIN<uint>(_garbage.size(), _sweepPos + maxObjects);
+	for (; _sweepPos < end; _sweepPos++) {
+		const reg_t addr = _garbage[_sweepPos].addr;
+		SegmentObj *mobj = segMan->getSegmentObj(addr.getSegment());
+
+		// Unreachable objects cannot be freed by scripts, but their whole
+		// segment may have been discarded in the meantime
+		if (mobj != _garbage[_sweepPos].mobj || !mobj->isValidOffset(addr.getOffset()))
+			continue;
+
+#ifdef GC_DEBUG_CODE
+		const SegmentType type = mobj->getType();
+		segnames[type] = segmentTypeNames[type];
+		segcount[type]++;
+#endif
+
+		// Not found -> we can free it
+		mobj->freeAtAddress(segMan, addr);
+		debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+		_stats.totalFreed++;
+	}
+
+	if (_sweepPos == _garbage.size()) {
+		_garbage.clear();
+		_sweepPos = 0;
+	}
+
+	_stats.totalSweepTime += g_system->getMillis(true) - startTime;
 
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
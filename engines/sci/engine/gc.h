@@ -23,7 +23,7 @@
 #ifndef SCI_ENGINE_GC_H
 #define SCI_ENGINE_GC_H
 
-#include "common/hashmap.h"
+#include "common/flat-hashmap.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/state.h"
 
@@ -38,8 +38,10 @@ struct reg_t_Hash {
 /*
  * The AddrSet is a "set" of reg_t values.
  * We don't have a HashSet type, so we abuse a HashMap for this.
+ * The garbage collector fills it with every reachable address, so it
+ * uses the open-addressing map, which has no per-entry allocations.
  */
-typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
+typedef Common::FlatHashMap<reg_t, bool, reg_t_Hash> AddrSet;
 
 /**
  * Finds all used references and normalises them to their memory addresses
@@ -62,6 +64,82 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+struct GCStatistics {
+	uint32 collections;    ///< Number of mark phases since the last reset
+	uint32 lastMarkTime;   ///< Duration of the last mark phase, in milliseconds
+	uint32 maxMarkTime;    ///< Longest mark phase, in milliseconds
+	uint32 totalMarkTime;  ///< Time spent in mark phases, in milliseconds
+	uint32 totalSweepTime; ///< Time spent freeing objects, in milliseconds
+	uint32 lastReachable;  ///< Number of reachable addresses found by the last mark phase
+	uint32 lastGarbage;    ///< Number of unreachable objects found by the last mark phase, including the scripts it freed
+	uint32 totalFreed;     ///< Number of objects freed
+
+	GCStatistics() { reset(); }
+	void reset();
+};
+
+/**
+ * The garbage collector of the VM.
+ *
+ * Scripts store references without notifying the collector, so reachable
+ * objects are always marked in one go. Unreachable objects can never become
+ * reachable again, though, so freeing them is spread over the following
+ * kernel calls instead of stalling the VM. The exception are deleted scripts,
+ * which SegManager::instantiateScript() may load again, so they are freed
+ * while marking. The address sets are kept between collections, so that
+ * their storage does not need to be allocated again.
+ */
+class GarbageCollector {
+public:
+	GarbageCollector();
+
+	/**
+	 * Marks all reachable objects and frees the first part of the garbage.
+	 * The rest is freed by subsequent calls to step().
+	 */
+	void startCollection(EngineState *s);
+
+	/**
+	 * Frees the next part of the garbage found by the last collection.
+	 * Called before each kernel call.
+	 */
+	void step(EngineState *s) {
+		if (_sweepPos < _garbage.size())
+			sweep(s->_segMan, kSweepStep);
+	}
+
+	/** Runs a whole collection at once, freeing all unreachable objects. */
+	void collect(EngineState *s);
+
+	/** Forgets pending garbage, for when the heap has been replaced. */
+	void reset();
+
+	/** Returns the number of unreachable objects which have not been freed yet. */
+	uint getPendingGarbage() const { return _garbage.size() - _sweepPos; }
+
+	const GCStatistics &getStatistics() const { return _stats; }
+	void resetStatistics() { _stats.reset(); }
+
+private:
+	enum {
+		kSweepStep = 64 ///< Number of unreachable objects freed per kernel call
+	};
+
+	struct Garbage {
+		reg_t addr;
+		SegmentObj *mobj;
+	};
+
+	void mark(EngineState *s);
+	void sweep(SegManager *segMan, uint maxObjects);
+
+	WorklistManager _wm;
+	AddrSet _activeRefs;
+	Common::Array<Garbage> _garbage;
+	uint _sweepPos;
+	GCStatistics _stats;
+};
+
 
 } // End of namespace Sci
 
@@ -243,6 +243,7 @@ reg_t kMemorySegment(EngineState *s, int argc, reg_t *argv) {
 
 reg_t kFlushResources(EngineState *s, int argc, reg_t *argv) {
 	run_gc(s);
+	g_sci->getResMan()->setCurrentRoom(argv[0].toUint16());
 	debugC(kDebugLevelRoom, "Entering room number %d", argv[0].toUint16());
 	return s->r_acc;
 }
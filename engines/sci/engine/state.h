@@ -45,6 +45,7 @@ namespace Sci {
 class FileHandle;
 class DirSeeker;
 class EventManager;
+class GarbageCollector;
 class MessageState;
 class SoundCommandParser;
 class VirtualIndexFile;
@@ -188,6 +189,7 @@ struct EngineState : public Common::Serializable {
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GarbageCollector *_gc;
 
 	MessageState *_msgState;
 
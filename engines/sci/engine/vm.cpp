@@ -850,7 +850,9 @@ void run_vm(EngineState *s) {
 			// Run the garbage collector, if needed
 			if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				s->_gc->startCollection(s);
+			} else {
+				s->_gc->step(s);
 			}
 
 			// Call kernel function
@@ -24,6 +24,7 @@
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
 #include "sci/graphics/celobj32.h"
+#include "sci/graphics/celobj32_rows.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/palette32.h"
 #include "sci/graphics/remap32.h"
@@ -33,6 +34,7 @@
 #include "graphics/larryScale.h"
 #include "common/config-manager.h"
 #include "common/gui_options.h"
+#include "common/system.h"
 
 namespace Sci {
 #pragma mark CelScaler
@@ -81,16 +83,123 @@ const CelScalerTable &CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 	return _scaleTables[_activeIndex];
 }
 
+#pragma mark -
+#pragma mark ScaledCelCache
+
+ScaledCelCache::ScaledCelCache(const uint maxEntries, const uint32 maxSize) :
+	_nextId(1),
+	_maxEntries(maxEntries),
+	_size(0),
+	_maxSize(maxSize) {}
+
+ScaledCelCache::~ScaledCelCache() {
+	clear();
+}
+
+void ScaledCelCache::clear() {
+	while (!_entries.empty()) {
+		remove(_entries.size() - 1);
+	}
+}
+
+int ScaledCelCache::findEntry(const CelInfo32 &celInfo, const Ratio &scaleX, const Ratio &scaleY, const bool mirrorX) {
+	for (uint i = 0; i < _entries.size(); ++i) {
+		Entry &entry = _entries[i];
+		if (entry.celInfo == celInfo && entry.scaleX == scaleX && entry.scaleY == scaleY && entry.mirrorX == mirrorX) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void ScaledCelCache::remove(const uint index) {
+	Buffer &bitmap = *_entries[index].bitmap;
+	_size -= bitmap.w * bitmap.h;
+	_entries.remove_at(index);
+}
+
+const Buffer *ScaledCelCache::find(const CelInfo32 &celInfo, const Ratio &scaleX, const Ratio &scaleY, const bool mirrorX, const int16 width, const int16 height) {
+	const int index = findEntry(celInfo, scaleX, scaleY, mirrorX);
+	if (index == -1) {
+		return nullptr;
+	}
+
+	Entry &entry = _entries[index];
+	if (entry.bitmap->w < width || entry.bitmap->h < height) {
+		return nullptr;
+	}
+
+	entry.id = ++_nextId;
+	return entry.bitmap.get();
+}
+
+Buffer *ScaledCelCache::insert(const CelInfo32 &celInfo, const Ratio &scaleX, const Ratio &scaleY, const bool mirrorX, const int16 width, const int16 height) {
+	const uint32 size = width * height;
+	if (size > _maxSize) {
+		return nullptr;
+	}
+
+	// A smaller bitmap of the same cel is replaced by the new one
+	const int index = findEntry(celInfo, scaleX, scaleY, mirrorX);
+	if (index != -1) {
+		remove(index);
+	}
+
+	while (!_entries.empty() && (_entries.size() >= _maxEntries || _size + size > _maxSize)) {
+		uint oldestIndex = 0;
+		for (uint i = 1; i < _entries.size(); ++i) {
+			if (_entries[i].id < _entries[oldestIndex].id) {
+				oldestIndex = i;
+			}
+		}
+		remove(oldestIndex);
+	}
+
+	Entry entry;
+	entry.id = ++_nextId;
+	entry.celInfo = celInfo;
+	entry.scaleX = scaleX;
+	entry.scaleY = scaleY;
+	entry.mirrorX = mirrorX;
+	entry.bitmap = Common::SharedPtr<Buffer>(new Buffer(), Graphics::SurfaceDeleter());
+	entry.bitmap->create(width, height, Graphics::PixelFormat::createFormatCLUT8());
+	_entries.push_back(entry);
+	_size += size;
+	return entry.bitmap.get();
+}
+
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
 
+/**
+ * The row kernels used to draw cels from the scaled cel cache.
+ */
+static CelRowKernels celRowKernels = { copyCelRowGeneric, copyCelRowBelowGeneric };
+
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
 	_nextCacheId = 1;
 	_scaler = new CelScaler();
 	_cache = new CelCache(100);
+	_scaledCache = new ScaledCelCache(64, 8 * 1024 * 1024);
+
+	celRowKernels.copy = copyCelRowGeneric;
+	celRowKernels.copyBelow = copyCelRowBelowGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		celRowKernels.copy = copyCelRowNEON;
+		celRowKernels.copyBelow = copyCelRowBelowNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		celRowKernels.copy = copyCelRowSSE2;
+		celRowKernels.copyBelow = copyCelRowBelowSSE2;
+	}
+#endif
 }
 
 void CelObj::deinit() {
@@ -98,6 +207,31 @@ void CelObj::deinit() {
 	_scaler = nullptr;
 	delete _cache;
 	_cache = nullptr;
+	delete _scaledCache;
+	_scaledCache = nullptr;
+}
+
+void copyCelRowGeneric(byte *target, const byte *source, int16 width, uint8 skipColor) {
+	for (int16 x = 0; x < width; ++x) {
+		if (source[x] != skipColor) {
+			target[x] = source[x];
+		}
+	}
+}
+
+bool copyCelRowBelowGeneric(byte *target, const byte *source, int16 width, uint8 skipColor, uint8 remapStart) {
+	bool hasRemap = false;
+	for (int16 x = 0; x < width; ++x) {
+		const byte pixel = source[x];
+		if (pixel != skipColor) {
+			if (pixel < remapStart) {
+				target[x] = pixel;
+			} else {
+				hasRemap = true;
+			}
+		}
+	}
+	return hasRemap;
 }
 
 #pragma mark -
@@ -468,6 +602,13 @@ struct MAPPER_NoMD {
 			*target = translateMacColor(isMacSource, pixel);
 		}
 	}
+
+	/**
+	 * Draws a row of source pixels which do not need Mac color translation.
+	 */
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
+		celRowKernels.copy(target, source, width, skipColor);
+	}
 };
 
 /**
@@ -478,6 +619,10 @@ struct MAPPER_NoMDNoSkip {
 	inline void draw(byte *target, const byte pixel, const uint8, const bool isMacSource) const {
 		*target = translateMacColor(isMacSource, pixel);
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8) const {
+		memcpy(target, source, width);
+	}
 };
 
 /**
@@ -496,6 +641,22 @@ struct MAPPER_Map {
 			}
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
+		const uint8 remapStart = g_sci->_gfxRemap32->getStartColor();
+		if (!celRowKernels.copyBelow(target, source, width, skipColor, remapStart)) {
+			return;
+		}
+
+		// Remapping depends on the target pixels, so remap pixels are still
+		// drawn one at a time
+		for (int16 x = 0; x < width; ++x) {
+			const byte pixel = source[x];
+			if (pixel != skipColor && pixel >= remapStart && g_sci->_gfxRemap32->remapEnabled(pixel)) {
+				target[x] = g_sci->_gfxRemap32->remapColor(pixel, target[x]);
+			}
+		}
+	}
 };
 
 /**
@@ -510,6 +671,10 @@ struct MAPPER_NoMap {
 			*target = translateMacColor(isMacSource, pixel);
 		}
 	}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor) const {
+		celRowKernels.copyBelow(target, source, width, skipColor, g_sci->_gfxRemap32->getStartColor());
+	}
 };
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
@@ -688,6 +853,7 @@ void CelObj::submitPalette() const {
 
 int CelObj::_nextCacheId = 1;
 CelCache *CelObj::_cache = nullptr;
+ScaledCelCache *CelObj::_scaledCache = nullptr;
 
 int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
 	*nextInsertIndex = -1;
@@ -778,6 +944,9 @@ void CelObj::render(Buffer &target, const Common::Rect &targetRect, const Common
 
 template<typename MAPPER, typename SCALER>
 void CelObj::render(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const {
+	if (renderScaledFromCache<MAPPER>(target, targetRect, scaledPosition, scaleX, scaleY)) {
+		return;
+	}
 
 	MAPPER mapper;
 	SCALER scaler(*this, targetRect, scaledPosition, scaleX, scaleY);
@@ -790,6 +959,113 @@ void CelObj::render(Buffer &target, const Common::Rect &targetRect, const Common
 	}
 }
 
+template<typename READER>
+static void buildScaledBitmap(const CelObj &celObj, const CelScalerTable &table, const bool mirrorX, Buffer &bitmap) {
+	READER reader(celObj, celObj._width);
+	const int lastIndex = celObj._width - 1;
+	for (int16 y = 0; y < bitmap.h; ++y) {
+		const byte *sourceRow = reader.getRow(table.valuesY[y]);
+		byte *targetRow = (byte *)bitmap.getBasePtr(0, y);
+		if (mirrorX) {
+			for (int16 x = 0; x < bitmap.w; ++x) {
+				targetRow[x] = sourceRow[lastIndex - table.valuesX[x]];
+			}
+		} else {
+			for (int16 x = 0; x < bitmap.w; ++x) {
+				targetRow[x] = sourceRow[table.valuesX[x]];
+			}
+		}
+	}
+}
+
+const Buffer *CelObj::getScaledBitmap(const Ratio &scaleX, const Ratio &scaleY, const int16 width, const int16 height) const {
+	const Buffer *cachedBitmap = _scaledCache->find(_info, scaleX, scaleY, _drawMirrored, width, height);
+	if (cachedBitmap) {
+		return cachedBitmap;
+	}
+
+	const CelScalerTable &table = _scaler->getScalerTable(scaleX, scaleY);
+
+	// Scale the whole cel rather than only the requested area, so that later
+	// draws of other parts of the same screen item hit the cache too
+	int16 scaledWidth = width;
+	while (scaledWidth < kCelScalerTableSize && table.valuesX[scaledWidth] < _width) {
+		++scaledWidth;
+	}
+	int16 scaledHeight = height;
+	while (scaledHeight < kCelScalerTableSize && table.valuesY[scaledHeight] < _height) {
+		++scaledHeight;
+	}
+
+	Buffer *bitmap = _scaledCache->insert(_info, scaleX, scaleY, _drawMirrored, scaledWidth, scaledHeight);
+	if (!bitmap) {
+		return nullptr;
+	}
+
+	if (_compressionType == kCelCompressionNone) {
+		buildScaledBitmap<READER_Uncompressed>(*this, table, _drawMirrored, *bitmap);
+	} else {
+		buildScaledBitmap<READER_Compressed>(*this, table, _drawMirrored, *bitmap);
+	}
+
+	return bitmap;
+}
+
+template<typename MAPPER>
+bool CelObj::renderScaledFromCache(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const {
+	// The pixels of cels in memory may change at any time
+	if (_info.type != kCelTypeView && _info.type != kCelTypePic) {
+		return false;
+	}
+
+	// With global scaling, the scaled pixels depend on the position of the cel
+	// on the screen, and LarryScale works on the scaled size instead of the
+	// scaling tables, so only cels scaled by the tables relative to their own
+	// origin can be cached
+	if (g_sci->_gfxFrameout->getScriptWidth() == kLowResX) {
+		return false;
+	}
+	if (Common::checkGameGUIOption(GAMEOPTION_LARRYSCALE, ConfMan.get("guioptions")) && ConfMan.getBool("enable_larryscale")) {
+		return false;
+	}
+
+	if (targetRect.isEmpty() || targetRect.left < scaledPosition.x || targetRect.top < scaledPosition.y) {
+		return false;
+	}
+
+	const int16 width = targetRect.right - scaledPosition.x;
+	const int16 height = targetRect.bottom - scaledPosition.y;
+	if (width > kCelScalerTableSize || height > kCelScalerTableSize) {
+		return false;
+	}
+
+	const Buffer *bitmap = getScaledBitmap(scaleX, scaleY, width, height);
+	if (!bitmap) {
+		return false;
+	}
+
+	MAPPER mapper;
+	const int16 targetWidth = targetRect.width();
+	for (int16 y = targetRect.top; y < targetRect.bottom; ++y) {
+		byte *targetPixel = (byte *)target.getBasePtr(targetRect.left, y);
+		if (_drawBlackLines && ((y - targetRect.top) % 2) == 0) {
+			memset(targetPixel, 0, targetWidth);
+			continue;
+		}
+
+		const byte *sourcePixel = (const byte *)bitmap->getBasePtr(targetRect.left - scaledPosition.x, y - scaledPosition.y);
+		if (_isMacSource) {
+			for (int16 x = 0; x < targetWidth; ++x) {
+				mapper.draw(targetPixel++, *sourcePixel++, _skipColor, _isMacSource);
+			}
+		} else {
+			mapper.drawRow(targetPixel, sourcePixel, targetWidth, _skipColor);
+		}
+	}
+
+	return true;
+}
+
 void CelObj::drawHzFlip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
 	render<MAPPER_NoMap, SCALER_NoScale<true, READER_Compressed> >(target, targetRect, scaledPosition);
 }
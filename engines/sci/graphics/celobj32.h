@@ -22,6 +22,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/ptr.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -148,6 +149,55 @@ struct CelCacheEntry {
 
 typedef Common::Array<CelCacheEntry> CelCache;
 
+#pragma mark -
+#pragma mark ScaledCelCache
+
+/**
+ * A cache of scaled cel bitmaps. Decompressing and scaling a cel is repeated
+ * every time a scaled screen item is drawn, so cels which stay at the same
+ * scale are kept here in their scaled and mirrored form, and drawing them
+ * only needs to apply the pixel mapper.
+ */
+class ScaledCelCache {
+public:
+	ScaledCelCache(const uint maxEntries, const uint32 maxSize);
+	~ScaledCelCache();
+
+	/**
+	 * Returns the cached bitmap of the given cel, if it is at least as large as
+	 * the given dimensions, or null.
+	 */
+	const Buffer *find(const CelInfo32 &celInfo, const Ratio &scaleX, const Ratio &scaleY, const bool mirrorX, const int16 width, const int16 height);
+
+	/**
+	 * Creates an uninitialised bitmap of the given dimensions for the given
+	 * cel, evicting the least recently used bitmaps to make room for it.
+	 * Returns null if the bitmap is larger than the whole cache.
+	 */
+	Buffer *insert(const CelInfo32 &celInfo, const Ratio &scaleX, const Ratio &scaleY, const bool mirrorX, const int16 width, const int16 height);
+
+	void clear();
+
+private:
+	struct Entry {
+		int id;
+		CelInfo32 celInfo;
+		Ratio scaleX;
+		Ratio scaleY;
+		bool mirrorX;
+		Common::SharedPtr<Buffer> bitmap;
+	};
+
+	int findEntry(const CelInfo32 &celInfo, const Ratio &scaleX, const Ratio &scaleY, const bool mirrorX);
+	void remove(const uint index);
+
+	Common::Array<Entry> _entries;
+	int _nextId;
+	uint _maxEntries;
+	uint32 _size;
+	uint32 _maxSize;
+};
+
 #pragma mark -
 #pragma mark CelScaler
 
@@ -420,6 +470,19 @@ private:
 	template<typename MAPPER, typename SCALER>
 	void render(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const;
 
+	/**
+	 * Draws the cel from the scaled cel cache, creating the scaled bitmap
+	 * first if needed. Returns false if the cel cannot be drawn this way.
+	 */
+	template<typename MAPPER>
+	bool renderScaledFromCache(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const;
+
+	/**
+	 * Returns the scaled bitmap of this cel from the scaled cel cache, at least
+	 * as large as the given dimensions, or null if it cannot be cached.
+	 */
+	const Buffer *getScaledBitmap(const Ratio &scaleX, const Ratio &scaleY, const int16 width, const int16 height) const;
+
 	void drawHzFlip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const;
 	void drawNoFlip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const;
 	void drawUncompNoFlip(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const;
@@ -462,6 +525,12 @@ protected:
 	 */
 	static CelCache *_cache;
 
+	/**
+	 * A cache of scaled cel bitmaps used to avoid decompressing and scaling
+	 * the same cels every frame.
+	 */
+	static ScaledCelCache *_scaledCache;
+
 	/**
 	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
 	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
@@ -0,0 +1,62 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sci/graphics/celobj32_rows.h"
+
+#include <arm_neon.h>
+
+namespace Sci {
+
+void copyCelRowNEON(byte *target, const byte *source, int16 width, uint8 skipColor) {
+	const uint8x16_t skip = vdupq_n_u8(skipColor);
+
+	int16 x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t src = vld1q_u8(source + x);
+		const uint8x16_t dst = vld1q_u8(target + x);
+		const uint8x16_t isSkip = vceqq_u8(src, skip);
+		vst1q_u8(target + x, vbslq_u8(isSkip, dst, src));
+	}
+
+	copyCelRowGeneric(target + x, source + x, width - x, skipColor);
+}
+
+bool copyCelRowBelowNEON(byte *target, const byte *source, int16 width, uint8 skipColor, uint8 remapStart) {
+	const uint8x16_t skip = vdupq_n_u8(skipColor);
+	const uint8x16_t start = vdupq_n_u8(remapStart);
+	uint8x16_t remapPixels = vdupq_n_u8(0);
+
+	int16 x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t src = vld1q_u8(source + x);
+		const uint8x16_t dst = vld1q_u8(target + x);
+		const uint8x16_t isSkip = vceqq_u8(src, skip);
+		const uint8x16_t isRemap = vcgeq_u8(src, start);
+		vst1q_u8(target + x, vbslq_u8(vorrq_u8(isSkip, isRemap), dst, src));
+		remapPixels = vorrq_u8(remapPixels, vbicq_u8(isRemap, isSkip));
+	}
+
+	const bool hasRemap = copyCelRowBelowGeneric(target + x, source + x, width - x, skipColor, remapStart);
+	const uint64x2_t remapLanes = vreinterpretq_u64_u8(remapPixels);
+	return hasRemap || (vgetq_lane_u64(remapLanes, 0) | vgetq_lane_u64(remapLanes, 1)) != 0;
+}
+
+} // End of namespace Sci
@@ -0,0 +1,64 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCI_GRAPHICS_CELOBJ32_ROWS_H
+#define SCI_GRAPHICS_CELOBJ32_ROWS_H
+
+#include "common/scummsys.h"
+
+namespace Sci {
+
+/**
+ * Row kernels used by CelObj to draw rows of already scaled cels. The SIMD
+ * versions produce exactly the same output as the generic ones and are
+ * selected at runtime by CelObj::init.
+ */
+struct CelRowKernels {
+	/**
+	 * Copies the pixels of a row which are not the skip color.
+	 */
+	void (*copy)(byte *target, const byte *source, int16 width, uint8 skipColor);
+
+	/**
+	 * Copies the pixels of a row which are neither the skip color nor remap
+	 * pixels (pixels at or above `remapStart`).
+	 *
+	 * @return true if the row contains remap pixels, which were not copied
+	 */
+	bool (*copyBelow)(byte *target, const byte *source, int16 width, uint8 skipColor, uint8 remapStart);
+};
+
+void copyCelRowGeneric(byte *target, const byte *source, int16 width, uint8 skipColor);
+bool copyCelRowBelowGeneric(byte *target, const byte *source, int16 width, uint8 skipColor, uint8 remapStart);
+
+#ifdef SCUMMVM_SSE2
+void copyCelRowSSE2(byte *target, const byte *source, int16 width, uint8 skipColor);
+bool copyCelRowBelowSSE2(byte *target, const byte *source, int16 width, uint8 skipColor, uint8 remapStart);
+#endif
+
+#ifdef SCUMMVM_NEON
+void copyCelRowNEON(byte *target, const byte *source, int16 width, uint8 skipColor);
+bool copyCelRowBelowNEON(byte *target, const byte *source, int16 width, uint8 skipColor, uint8 remapStart);
+#endif
+
+} // End of namespace Sci
+
+#endif
@@ -0,0 +1,79 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sci/graphics/celobj32_rows.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Sci {
+
+void copyCelRowSSE2(byte *target, const byte *source, int16 width, uint8 skipColor) {
+	const __m128i skip = _mm_set1_epi8((char)skipColor);
+
+	int16 x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(source + x));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(target + x));
+		const __m128i isSkip = _mm_cmpeq_epi8(src, skip);
+		const __m128i result = _mm_or_si128(_mm_and_si128(isSkip, dst), _mm_andnot_si128(isSkip, src));
+		_mm_storeu_si128((__m128i *)(target + x), result);
+	}
+
+	copyCelRowGeneric(target + x, source + x, width - x, skipColor);
+}
+
+bool copyCelRowBelowSSE2(byte *target, const byte *source, int16 width, uint8 skipColor, uint8 remapStart) {
+	const __m128i skip = _mm_set1_epi8((char)skipColor);
+	const __m128i start = _mm_set1_epi8((char)remapStart);
+	__m128i remapPixels = _mm_setzero_si128();
+
+	int16 x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(source + x));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(target + x));
+		const __m128i isSkip = _mm_cmpeq_epi8(src, skip);
+		// There is no unsigned byte comparison, but max(src, start) == src
+		// exactly when src >= start
+		const __m128i isRemap = _mm_cmpeq_epi8(_mm_max_epu8(src, start), src);
+		const __m128i keep = _mm_or_si128(isSkip, isRemap);
+		const __m128i result = _mm_or_si128(_mm_and_si128(keep, dst), _mm_andnot_si128(keep, src));
+		_mm_storeu_si128((__m128i *)(target + x), result);
+		remapPixels = _mm_or_si128(remapPixels, _mm_andnot_si128(isSkip, isRemap));
+	}
+
+	const bool hasRemap = copyCelRowBelowGeneric(target + x, source + x, width - x, skipColor, remapStart);
+	return hasRemap || _mm_movemask_epi8(remapPixels) != 0;
+}
+
+} // End of namespace Sci
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
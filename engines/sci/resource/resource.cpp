@@ -207,6 +207,8 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_fileOffset = 0;
 	_status = kResStatusNoMalloc;
 	_lockers = 0;
+	_evicted = false;
+	_prefetched = false;
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
@@ -1006,6 +1008,12 @@ void ResourceManager::init() {
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	_reloadedMemoryLRU = 0;
+	resetCacheStatistics();
+	_currentRoom = -1;
+	_roomResources.clear();
+	_currentRoomResources.clear();
+	_prefetchQueue.clear();
 	_resMap.clear();
 	_audioMapSCI1 = nullptr;
 #ifdef ENABLE_SCI32
@@ -1079,6 +1087,18 @@ void ResourceManager::init() {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
 	}
 
+	// A user configured cache size is used as is. Otherwise the defaults
+	// above are only a starting point: the budget grows when resources keep
+	// getting evicted and reloaded, up to a multiple of its initial size.
+	if (ConfMan.hasKey("sci_resource_cache_size") && ConfMan.getInt("sci_resource_cache_size") > 0) {
+		_maxMemoryLRU = ConfMan.getInt("sci_resource_cache_size") * 1024;
+		_maxMemoryLRULimit = _maxMemoryLRU;
+		_adaptiveMemoryLRU = false;
+	} else {
+		_maxMemoryLRULimit = _maxMemoryLRU * 8;
+		_adaptiveMemoryLRU = true;
+	}
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -1145,18 +1165,51 @@ void ResourceManager::addToLRU(Resource *res) {
 	res->_status = kResStatusEnqueued;
 }
 
+void ResourceManager::evictResource(Resource *goner) {
+	removeFromLRU(goner);
+	goner->unalloc();
+	goner->_evicted = true;
+	goner->_prefetched = false;
+	_cacheStats.evictions++;
+#ifdef SCI_VERBOSE_RESMAN
+	debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
+#endif
+}
+
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
 		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
-		removeFromLRU(goner);
-		goner->unalloc();
-#ifdef SCI_VERBOSE_RESMAN
-		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
-#endif
+		evictResource(_LRU.back());
 	}
 }
 
+bool ResourceManager::makeRoomForPrefetch(uint32 size) {
+	if (_memoryLRU + (int)size <= _maxMemoryLRU)
+		return true;
+
+	// Only resources which the current room is not known to use may make
+	// way, oldest first. Check that enough of them can go before evicting
+	// anything.
+	Common::Array<Resource *> goners;
+	int freed = 0;
+	for (Common::List<Resource *>::const_iterator it = _LRU.reverse_begin(); it != _LRU.end(); --it) {
+		if (_currentRoomResources.contains((*it)->_id))
+			continue;
+
+		goners.push_back(*it);
+		freed += (*it)->size();
+		if (_memoryLRU - freed + (int)size <= _maxMemoryLRU)
+			break;
+	}
+
+	if (_memoryLRU - freed + (int)size > _maxMemoryLRU)
+		return false;
+
+	for (uint i = 0; i < goners.size(); ++i)
+		evictResource(goners[i]);
+	return true;
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1193,6 +1246,9 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return nullptr;
 
+	trackResourceRequest(retval);
+	recordRoomResource(id);
+
 	if (retval->_status == kResStatusNoMalloc)
 		loadResource(retval);
 	else if (retval->_status == kResStatusEnqueued)
@@ -1228,6 +1284,136 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	}
 }
 
+void ResourceManager::resetCacheStatistics() {
+	_cacheStats.hits = 0;
+	_cacheStats.misses = 0;
+	_cacheStats.reloads = 0;
+	_cacheStats.evictions = 0;
+	_cacheStats.prefetches = 0;
+	_cacheStats.prefetchHits = 0;
+}
+
+void ResourceManager::trackResourceRequest(Resource *res) {
+	if (res->_prefetched) {
+		res->_prefetched = false;
+		_cacheStats.prefetchHits++;
+	}
+
+	if (res->_status != kResStatusNoMalloc) {
+		_cacheStats.hits++;
+		return;
+	}
+
+	_cacheStats.misses++;
+	if (!res->_evicted)
+		return;
+
+	_cacheStats.reloads++;
+	if (!_adaptiveMemoryLRU || _maxMemoryLRU >= _maxMemoryLRULimit)
+		return;
+
+	// The working set does not fit into the budget: once resources worth
+	// half of it were thrown away and read back, double the budget
+	_reloadedMemoryLRU += res->size();
+	if (_reloadedMemoryLRU > _maxMemoryLRU / 2) {
+		_maxMemoryLRU = MIN(_maxMemoryLRU * 2, _maxMemoryLRULimit);
+		_reloadedMemoryLRU = 0;
+		debugC(1, kDebugLevelResMan, "resMan: Raising resource cache size to %d KB", _maxMemoryLRU / 1024);
+	}
+}
+
+static bool isPrefetchableResourceType(ResourceType type) {
+	// Audio, sync and video resources are streamed, can be very large and
+	// are usually only played once, so only prefetch what rooms are built of
+	switch (type) {
+	case kResourceTypeView:
+	case kResourceTypePic:
+	case kResourceTypeScript:
+	case kResourceTypeText:
+	case kResourceTypeSound:
+	case kResourceTypeFont:
+	case kResourceTypeCursor:
+	case kResourceTypePatch:
+	case kResourceTypeBitmap:
+	case kResourceTypePalette:
+	case kResourceTypeHeap:
+	case kResourceTypeMessage:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void ResourceManager::recordRoomResource(const ResourceId &id) {
+	// Upper bound for the remembered resources of a single room
+	const uint kMaxRoomResources = 256;
+
+	if (_currentRoom < 0 || !isPrefetchableResourceType(id.getType()))
+		return;
+
+	if (_currentRoomResources.contains(id))
+		return;
+
+	Common::Array<ResourceId> &resources = _roomResources[_currentRoom];
+	if (resources.size() >= kMaxRoomResources)
+		return;
+
+	resources.push_back(id);
+	_currentRoomResources[id] = true;
+}
+
+void ResourceManager::setCurrentRoom(uint16 roomNumber) {
+	if (_currentRoom == roomNumber)
+		return;
+
+	_currentRoom = roomNumber;
+	_currentRoomResources.clear();
+	_prefetchQueue.clear();
+
+	RoomResourceMap::const_iterator it = _roomResources.find(roomNumber);
+	if (it == _roomResources.end())
+		return;
+
+	const Common::Array<ResourceId> &resources = it->_value;
+	for (uint i = 0; i < resources.size(); ++i) {
+		_currentRoomResources[resources[i]] = true;
+		_prefetchQueue.push_back(resources[i]);
+	}
+}
+
+bool ResourceManager::prefetchNextResource() {
+	while (!_prefetchQueue.empty()) {
+		ResourceId id = _prefetchQueue.front();
+		_prefetchQueue.pop_front();
+
+		Resource *res = testResource(id);
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		// Prefetching may only evict resources the current room does not
+		// use. Skip resources which would not fit, and avoid reading them
+		// when the resource map already tells their size.
+		if (res->size() && !makeRoomForPrefetch(res->size()))
+			continue;
+
+		loadResource(res);
+		if (res->_status != kResStatusAllocated)
+			continue;
+
+		if (!makeRoomForPrefetch(res->size())) {
+			res->unalloc();
+			continue;
+		}
+
+		addToLRU(res);
+		res->_prefetched = true;
+		_cacheStats.prefetches++;
+		return true;
+	}
+
+	return false;
+}
+
 void ResourceManager::unlockResource(Resource *res) {
 	assert(res);
 
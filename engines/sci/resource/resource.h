@@ -309,6 +309,8 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	bool _evicted; /**< Resource was freed by the LRU cache at least once */
+	bool _prefetched; /**< Resource was loaded by prefetching and not requested since */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -407,6 +409,45 @@ public:
 	 */
 	bool hasResourceType(ResourceType type);
 
+	/**
+	 * Statistics of the cache of unlocked resources, shown by the
+	 * `resource_cache` debugger command.
+	 */
+	struct CacheStatistics {
+		uint32 hits;         ///< Requests for resources which were still in memory
+		uint32 misses;       ///< Requests for resources which had to be loaded
+		uint32 reloads;      ///< Misses for resources which had been evicted before
+		uint32 evictions;    ///< Resources freed to stay within the memory budget
+		uint32 prefetches;   ///< Resources loaded ahead of time
+		uint32 prefetchHits; ///< Prefetched resources which were requested afterwards
+	};
+
+	const CacheStatistics &getCacheStatistics() const { return _cacheStats; }
+	void resetCacheStatistics();
+
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMemoryLocked() const { return _memoryLocked; }
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+	int getMaxMemoryLRULimit() const { return _maxMemoryLRULimit; }
+	bool isMemoryLRUAdaptive() const { return _adaptiveMemoryLRU; }
+
+	/**
+	 * Notifies the resource manager that a new room is being entered.
+	 * Resources which the room requested on previous visits are queued for
+	 * prefetching.
+	 */
+	void setCurrentRoom(uint16 roomNumber);
+
+	/**
+	 * Loads the next queued prefetch resource which fits into the memory
+	 * budget, evicting only resources which the current room does not use.
+	 * Called while the engine idles.
+	 * @return true if a resource was loaded
+	 */
+	bool prefetchNextResource();
+
+	uint getPrefetchQueueSize() const { return _prefetchQueue.size(); }
+
 	void setAudioLanguage(int language);
 	int getAudioLanguage() const;
 	void changeAudioDirectory(const Common::Path &path);
@@ -495,6 +536,23 @@ protected:
 	// issued whenever this limit is exceeded.
 	int _maxMemoryLRU;
 
+	/**
+	 * Upper bound for the adaptive growth of `_maxMemoryLRU`. When the user
+	 * configures a fixed cache size, the budget is never adapted.
+	 */
+	int _maxMemoryLRULimit;
+	bool _adaptiveMemoryLRU;
+	int _reloadedMemoryLRU; ///< Bytes reloaded after eviction since the budget last changed
+
+	CacheStatistics _cacheStats;
+
+	typedef Common::HashMap<uint16, Common::Array<ResourceId> > RoomResourceMap;
+	typedef Common::HashMap<ResourceId, bool, ResourceIdHash> ResourceIdSet;
+	int _currentRoom;               ///< Room set by kFlushResources, or -1
+	RoomResourceMap _roomResources; ///< Resources requested by each visited room
+	ResourceIdSet _currentRoomResources; ///< Resources known to be used by the current room
+	Common::List<ResourceId> _prefetchQueue;
+
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	typedef Common::List<ResourceSource *> SourcesList;
 	SourcesList _sources;
@@ -561,7 +619,24 @@ protected:
 	Common::SeekableReadStream *getVolumeFile(ResourceSource *source);
 	void disposeVolumeFileStream(Common::SeekableReadStream *fileStream, ResourceSource *source);
 	void loadResource(Resource *res);
+	void evictResource(Resource *goner);
 	void freeOldResources();
+
+	/**
+	 * Evicts resources which the current room is not known to use until
+	 * a prefetched resource of the given size fits into the memory budget.
+	 * @return false, without evicting anything, if it cannot fit
+	 */
+	bool makeRoomForPrefetch(uint32 size);
+
+	/**
+	 * Updates the cache statistics for a request of the given resource and
+	 * grows the memory budget if evicted resources keep getting reloaded.
+	 */
+	void trackResourceRequest(Resource *res);
+
+	/** Remembers that the current room requested the given resource. */
+	void recordRoomResource(const ResourceId &id);
 	bool validateResource(const ResourceId &resourceId, const Common::Path &sourceMapLocation, const Common::Path &sourceName, const uint32 offset, const uint32 size, const uint32 sourceSize) const;
 	Resource *addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
 	Resource *updateResource(ResourceId resId, ResourceSource *src, uint32 size, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
@@ -32,6 +32,7 @@
 #include "sci/console.h"
 #include "sci/event.h"
 
+#include "sci/engine/gc.h"
 #include "sci/engine/features.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/message.h"
@@ -729,6 +730,7 @@ void SciEngine::runGame() {
 			// on the next iteration, but set the gameIsRestarting flag so
 			// that scripts can detect the restart with kGameIsRestarting.
 			_gamestate->_segMan->resetSegMan();
+			_gamestate->_gc->reset();
 			initGame();
 			initStackBaseWithSelector(SELECTOR(play));
 			_guestAdditions->patchGameSaveRestore();
@@ -1012,7 +1014,10 @@ void SciEngine::sleep(uint32 msecs) {
 #endif
 		uint32 time = _system->getMillis();
 		if (time + 10 < wakeUpTime) {
-			_system->delayMillis(10);
+			// Use the idle time to load resources the current room is
+			// likely to request, and only sleep when there is nothing left
+			if (!_resMan->prefetchNextResource())
+				_system->delayMillis(10);
 		} else {
 			if (time < wakeUpTime)
 				_system->delayMillis(wakeUpTime - time);
@@ -51,16 +51,20 @@ typedef Std::list<Item *> item_list;
 const int INT_MAX_VALUE = 0x7fffffff;
 const int INT_MIN_VALUE = -INT_MAX_VALUE - 1;
 
-CurrentMap::CurrentMap() : _currentMap(0), _eggHatcher(0),
+CurrentMap::CurrentMap() : _currentMap(0), _itemIndex(MAP_NUM_CHUNKS),
+	  _maxFootpad(0), _eggHatcher(0),
 	  _fastXMin(-1), _fastYMin(-1), _fastXMax(-1), _fastYMax(-1) {
 	for (unsigned int i = 0; i < MAP_NUM_CHUNKS; i++) {
 		memset(_fast[i], false, sizeof(uint32)*MAP_NUM_CHUNKS / 32);
 	}
 
+	// Footpad sizes are limited by the bits available in the typeflags
 	if (GAME_IS_U8) {
 		_mapChunkSize = 512;
+		_maxFootpad = 0xF * 32;
 	} else if (GAME_IS_CRUSADER) {
 		_mapChunkSize = 1024;
+		_maxFootpad = 0x1F * 32;
 	} else {
 		warning("Unknown game type in CurrentMap constructor.");
 	}
@@ -85,6 +89,7 @@ void CurrentMap::clear() {
 		}
 		memset(_fast[i], false, sizeof(uint32)*MAP_NUM_CHUNKS / 32);
 	}
+	_itemIndex.clear();
 
 	_fastXMin =  _fastYMin = _fastXMax = _fastYMax = -1;
 	_currentMap = nullptr;
@@ -152,6 +157,7 @@ void CurrentMap::writeback() {
 			_items[i][j].clear();
 		}
 	}
+	_itemIndex.clear();
 
 	// delete _eggHatcher
 	Process *ehp = Kernel::get_instance()->getProcess(_eggHatcher);
@@ -257,6 +263,7 @@ void CurrentMap::addItem(Item *item) {
 #endif
 
 	_items[cx][cy].push_front(item);
+	_itemIndex.addToStart(cx, cy, item, pt.x, pt.y);
 	item->setExtFlag(Item::EXT_INCURMAP);
 
 	Egg *egg = dynamic_cast<Egg *>(item);
@@ -294,6 +301,7 @@ void CurrentMap::addItemToEnd(Item *item) {
 #endif
 
 	_items[cx][cy].push_back(item);
+	_itemIndex.addToEnd(cx, cy, item, pt.x, pt.y);
 	item->setExtFlag(Item::EXT_INCURMAP);
 
 	Egg *egg = dynamic_cast<Egg *>(item);
@@ -405,9 +413,36 @@ void CurrentMap::removeItemFromList(Item *item, int32 oldx, int32 oldy) {
 	int32 cy = oldy / _mapChunkSize;
 
 	_items[cx][cy].remove(item);
+	_itemIndex.remove(cx, cy, item);
 	item->clearExtFlag(Item::EXT_INCURMAP);
 }
 
+void CurrentMap::updateItemLocation(const Item *item, int32 oldx, int32 oldy) {
+	Point3 pt = item->getLocation();
+
+	// The item is normally still in the chunk of its old location, but
+	// Item::setLocation is also used to probe locations in other chunks
+	// before moving the item back, so look around a bit if it isn't.
+	int cx = oldx / _mapChunkSize;
+	int cy = oldy / _mapChunkSize;
+	if (oldx >= 0 && oldy >= 0 && cx < MAP_NUM_CHUNKS && cy < MAP_NUM_CHUNKS &&
+	        _itemIndex.setLocation(cx, cy, item, pt.x, pt.y))
+		return;
+
+	int minx = cx - 1;
+	int maxx = cx + 1;
+	int miny = cy - 1;
+	int maxy = cy + 1;
+	clipMapChunks(minx, maxx, miny, maxy);
+
+	for (int ccy = miny; ccy <= maxy; ccy++) {
+		for (int ccx = minx; ccx <= maxx; ccx++) {
+			if (_itemIndex.setLocation(ccx, ccy, item, pt.x, pt.y))
+				return;
+		}
+	}
+}
+
 // Check to see if the chunk is on the screen
 static inline bool ChunkOnScreen(int32 cx, int32 cy, int32 sleft, int32 stop, int32 sright, int32 sbot, int mapChunkSize) {
 	int32 scx = (cx * mapChunkSize - cy * mapChunkSize) / 4;
@@ -592,31 +627,29 @@ void CurrentMap::areaSearch(UCList *itemlist, const uint8 *loopscript,
 	//
 	for (int cy = miny; cy <= maxy; cy++) {
 		for (int cx = minx; cx <= maxx; cx++) {
-			item_list::const_iterator iter;
-			for (iter = _items[cx][cy].begin();
-			        iter != _items[cx][cy].end(); ++iter) {
+			const MapItemIndex::EntryArray &entries = _itemIndex.getChunk(cx, cy);
+			for (uint i = 0; i < entries.size(); i++) {
+				// check if item is in range
+				if (!searchrange.containsXY(entries[i]._x, entries[i]._y))
+					continue;
 
-				const Item *item = *iter;
+				const Item *item = entries[i]._item;
 
 				if (item->hasExtFlags(Item::EXT_SPRITE))
 					continue;
 
-				// check if item is in range
-				Point3 pt = item->getLocation();
-				if (searchrange.containsXY(pt.x, pt.y)) {
-					// check item against loopscript
-					if (item->checkLoopScript(loopscript, scriptsize)) {
-						assert(itemlist->getElementSize() == 2);
-						itemlist->appenduint16(item->getObjId());
-					}
+				// check item against loopscript
+				if (item->checkLoopScript(loopscript, scriptsize)) {
+					assert(itemlist->getElementSize() == 2);
+					itemlist->appenduint16(item->getObjId());
+				}
 
-					if (recurse) {
-						// recurse into child-containers
-						const Container *container = dynamic_cast<const Container *>(item);
-						if (container)
-							container->containerSearch(itemlist, loopscript,
-													   scriptsize, recurse);
-					}
+				if (recurse) {
+					// recurse into child-containers
+					const Container *container = dynamic_cast<const Container *>(item);
+					if (container)
+						container->containerSearch(itemlist, loopscript,
+												   scriptsize, recurse);
 				}
 			}
 		}
@@ -639,11 +672,12 @@ void CurrentMap::surfaceSearch(UCList *itemlist, const uint8 *loopscript,
 
 	for (int cy = miny; cy <= maxy; cy++) {
 		for (int cx = minx; cx <= maxx; cx++) {
-			item_list::const_iterator iter;
-			for (iter = _items[cx][cy].begin();
-			        iter != _items[cx][cy].end(); ++iter) {
+			const MapItemIndex::EntryArray &entries = _itemIndex.getChunk(cx, cy);
+			for (uint i = 0; i < entries.size(); i++) {
+				if (!entries[i].mayOverlapXY(searchrange, _maxFootpad, 0))
+					continue;
 
-				const Item *item = *iter;
+				const Item *item = entries[i]._item;
 
 				if (item->getObjId() == check->getObjId())
 					continue;
@@ -738,10 +772,13 @@ PositionInfo CurrentMap::getPositionInfo(const Box &target, const Box &start, ui
 
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			item_list::const_iterator iter;
-			for (iter = _items[cx][cy].begin();
-				 iter != _items[cx][cy].end(); ++iter) {
-				const Item *item = *iter;
+			const MapItemIndex::EntryArray &entries = _itemIndex.getChunk(cx, cy);
+			for (uint i = 0; i < entries.size(); i++) {
+				// the bottom center check can match items just touching the target
+				if (!entries[i].mayOverlapXY(target, _maxFootpad, 1))
+					continue;
+
+				const Item *item = entries[i]._item;
 				if (item->getObjId() == id)
 					continue;
 				if (item->hasExtFlags(Item::EXT_SPRITE))
@@ -850,11 +887,17 @@ bool CurrentMap::scanForValidPosition(int32 x, int32 y, int32 z, const Item *ite
 	int maxy = (y / _mapChunkSize) + 1;
 	clipMapChunks(minx, maxx, miny, maxy);
 
+	// only items within scansize of the footpad can change the masks
+	const Box scanrange(x, y, z, xd, yd, zd);
+
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			for (item_list::const_iterator iter = _items[cx][cy].begin();
-			        iter != _items[cx][cy].end(); ++iter) {
-				const Item *citem = *iter;
+			const MapItemIndex::EntryArray &entries = _itemIndex.getChunk(cx, cy);
+			for (uint e = 0; e < entries.size(); e++) {
+				if (!entries[e].mayOverlapXY(scanrange, _maxFootpad, scansize))
+					continue;
+
+				const Item *citem = entries[e]._item;
 				if (citem->getObjId() == item->getObjId())
 					continue;
 				if (citem->hasExtFlags(Item::EXT_SPRITE))
@@ -1034,12 +1077,22 @@ bool CurrentMap::sweepTest(const Point3 &start, const Point3 &end,
 	Std::list<SweepItem>::iterator sw_it;
 	if (hit) sw_it = hit->end();
 
+	// Area covered by the whole move. Items merely touching it are hit too,
+	// and the rounding of the extents below can be a few units off.
+	const int32 sweepx = MAX(start.x, end.x);
+	const int32 sweepy = MAX(start.y, end.y);
+	const Box sweeprange(sweepx, sweepy, 0,
+						 sweepx - MIN(start.x, end.x) + dims[0],
+						 sweepy - MIN(start.y, end.y) + dims[1], 0);
+
 	for (int cx = minx; cx <= maxx; cx++) {
 		for (int cy = miny; cy <= maxy; cy++) {
-			item_list::const_iterator iter;
-			for (iter = _items[cx][cy].begin();
-			        iter != _items[cx][cy].end(); ++iter) {
-				const Item *other_item = *iter;
+			const MapItemIndex::EntryArray &entries = _itemIndex.getChunk(cx, cy);
+			for (uint e = 0; e < entries.size(); e++) {
+				if (!entries[e].mayOverlapXY(sweeprange, _maxFootpad, 4))
+					continue;
+
+				const Item *other_item = entries[e]._item;
 				if (other_item->getObjId() == item)
 					continue;
 				if (other_item->hasExtFlags(Item::EXT_SPRITE))
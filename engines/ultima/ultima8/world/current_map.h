@@ -25,6 +25,7 @@
 #include "ultima/shared/std/containers.h"
 #include "ultima/ultima8/usecode/intrinsics.h"
 #include "ultima/ultima8/world/position_info.h"
+#include "ultima/ultima8/world/map_item_index.h"
 #include "ultima/ultima8/misc/direction.h"
 #include "ultima/ultima8/misc/point3.h"
 
@@ -73,6 +74,10 @@ public:
 	void removeItemFromList(Item *item, int32 oldx, int32 oldy);
 	void removeItem(Item *item);
 
+	//! Update the search index after an item in the map changed its
+	//! location without being removed from its chunk
+	void updateItemLocation(const Item *item, int32 oldx, int32 oldy);
+
 	//! Add an item to the list of possible targets (in Crusader)
 	void addTargetItem(const Item *item);
 	//! Remove an item from the list of possible targets (in Crusader)
@@ -205,6 +210,12 @@ private:
 	// items[x][y]
 	Std::list<Item *> _items[MAP_NUM_CHUNKS][MAP_NUM_CHUNKS];
 
+	// locations of the items in the item lists, used for searches
+	MapItemIndex _itemIndex;
+
+	// largest footpad of any shape, in world coordinates
+	int32 _maxFootpad;
+
 	ProcId _eggHatcher;
 
 	// Fast area bit masks -> fast[ry][rx/32]&(1<<(rx&31));
@@ -146,15 +146,19 @@ const Item *Item::getTopItem() const {
 }
 
 void Item::setLocation(int32 X, int32 Y, int32 Z) {
+	int32 oldx = _x;
+	int32 oldy = _y;
+
 	_x = X;
 	_y = Y;
 	_z = Z;
+
+	if (_extendedFlags & EXT_INCURMAP)
+		World::get_instance()->getCurrentMap()->updateItemLocation(this, oldx, oldy);
 }
 
 void Item::setLocation(const Point3 &pt) {
-	_x = pt.x;
-	_y = pt.y;
-	_z = pt.z;
+	setLocation(pt.x, pt.y, pt.z);
 }
 
 void Item::move(const Point3 &pt) {
@@ -211,6 +215,8 @@ void Item::move(int32 X, int32 Y, int32 Z) {
 	_flags &= ~(FLG_CONTAINED | FLG_EQUIPPED | FLG_ETHEREAL);
 
 	// Set the location
+	int32 oldx = _x;
+	int32 oldy = _y;
 	_x = X;
 	_y = Y;
 	_z = Z;
@@ -223,6 +229,9 @@ void Item::move(int32 X, int32 Y, int32 Z) {
 			map->addItemToEnd(this);
 		else
 			map->addItem(this);
+	} else {
+		// Still in the same chunk
+		map->updateItemLocation(this, oldx, oldy);
 	}
 
 	// Call just moved
@@ -48,7 +48,7 @@ static const uint32 HIGHLIGHT_COLOR = TEX32_PACK_RGBA(0xFF, 0xFF, 0x00, 0x1F);
 ItemSorter::ItemSorter(int capacity) :
 	_shapes(nullptr), _clipWindow(0, 0, 0, 0), _items(nullptr), _itemsTail(nullptr),
 	_itemsUnused(nullptr), _painted(nullptr), _camSx(0), _camSy(0),
-	_sortLimit(0), _sortLimitChanged(false) {
+	_sortLimit(0), _sortLimitChanged(false), _addedCount(0), _reusing(false) {
 	int i = capacity;
 	while (i--) {
 		SortItem *next = _itemsUnused;
@@ -76,6 +76,25 @@ void ItemSorter::BeginDisplayList(const Rect &clipWindow, const Point3 &cam) {
 	// Get the _shapes, if required
 	if (!_shapes) _shapes = GameData::get_instance()->getMainShapes();
 
+	// Screenspace bounding box bottom x coord (RNB x coord)
+	int32 camSx = (cam.x - cam.y) / 4;
+	// Screenspace bounding box bottom extent  (RNB y coord)
+	int32 camSy = (cam.x + cam.y) / 8 - cam.z;
+
+	_painted = nullptr;
+	_addedCount = 0;
+
+#ifndef SORTITEM_OCCLUSION_EXPERIMENTAL
+	// If the view is unchanged, keep the list until an added item differs
+	// from the previous frame
+	if (clipWindow == _clipWindow && camSx == _camSx && camSy == _camSy) {
+		_reusing = true;
+		for (SortItem *si = _items; si != nullptr; si = si->_next)
+			si->_order = -1;
+		return;
+	}
+#endif
+
 	// Set the clip window, and reset the item list
 	_clipWindow = clipWindow;
 
@@ -86,12 +105,8 @@ void ItemSorter::BeginDisplayList(const Rect &clipWindow, const Point3 &cam) {
 
 	_items = nullptr;
 	_itemsTail = nullptr;
-	_painted = nullptr;
-
-	// Screenspace bounding box bottom x coord (RNB x coord)
-	int32 camSx = (cam.x - cam.y) / 4;
-	// Screenspace bounding box bottom extent  (RNB y coord)
-	int32 camSy = (cam.x + cam.y) / 8 - cam.z;
+	_added.clear();
+	_reusing = false;
 
 	if (camSx != _camSx || camSy != _camSy) {
 		_camSx = camSx;
@@ -102,7 +117,74 @@ void ItemSorter::BeginDisplayList(const Rect &clipWindow, const Point3 &cam) {
 	}
 }
 
+void ItemSorter::EndReuse() {
+	if (!_reusing)
+		return;
+
+	// Items from the previous frame which were not added again
+	if (_addedCount < _added.size())
+		RollbackDisplayList(_addedCount);
+	_reusing = false;
+}
+
+void ItemSorter::RollbackDisplayList(uint addNum) {
+	// Adding items only ever inserts into the list and the dependency
+	// lists, and occludes items which aren't occluded yet. So removing
+	// the later items and their effects gives exactly the list we had
+	// after adding the first addNum items.
+	SortItem *si = _items;
+	_itemsTail = nullptr;
+	while (si != nullptr) {
+		SortItem *next = si->_next;
+
+		if (si->_addNum >= (int32)addNum) {
+			if (si->_prev)
+				si->_prev->_next = next;
+			else
+				_items = next;
+			if (next)
+				next->_prev = si->_prev;
+
+			si->_next = _itemsUnused;
+			_itemsUnused = si;
+		} else {
+			si->_depends.removeAddedFrom(addNum);
+			if (si->_occluded && si->_occludedBy >= (int32)addNum)
+				si->_occluded = false;
+			_itemsTail = si;
+		}
+
+		si = next;
+	}
+
+	_added.resize(addNum);
+}
+
 void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, uint32 flags, uint32 ext_flags, uint16 itemNum) {
+	AddedItem added;
+	added._x = pt.x;
+	added._y = pt.y;
+	added._z = pt.z;
+	added._shapeNum = shapeNum;
+	added._frameNum = frame_num;
+	added._flags = flags;
+	added._extFlags = ext_flags;
+	added._itemNum = itemNum;
+
+	if (_reusing) {
+		// Same item as in the previous frame, so it's already in the list
+		if (_addedCount < _added.size() && _added[_addedCount] == added) {
+			_addedCount++;
+			return;
+		}
+
+		// Build the rest of the list from here
+		RollbackDisplayList(_addedCount);
+		_reusing = false;
+	}
+
+	const int32 addNum = _addedCount++;
+	_added.push_back(added);
 
 	// First thing, get a SortItem to use (first of unused)
 	if (!_itemsUnused)
@@ -179,7 +261,9 @@ void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, ui
 		si->_invitem = info->is_invitem();
 	}
 
+	si->_addNum = addNum;
 	si->_occluded = false;
+	si->_occludedBy = -1;
 	si->_order = -1;
 
 	// We will clear all the vector memory
@@ -226,6 +310,7 @@ void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, ui
 				if (si2->_occl && si2->occludes(*si)) {
 					// No need to do any more checks, this isn't visible
 					si->_occluded = true;
+					si->_occludedBy = addNum;
 					break;
 				} else {
 					// si1 is behind si2, so add it to si2's dependency list
@@ -235,6 +320,7 @@ void ItemSorter::AddItem(const Point3 &pt, uint32 shapeNum, uint32 frame_num, ui
 				if (si->_occl && si->occludes(*si2)) {
 					// Occluded, but we can't remove it from the list
 					si2->_occluded = true;
+					si2->_occludedBy = addNum;
 				} else {
 					// si2 is behind si1, so add it to si1's dependency list
 					si->_depends.insert_sorted(si2);
@@ -275,6 +361,8 @@ void ItemSorter::AddItem(const Item *add) {
 }
 
 void ItemSorter::PaintDisplayList(RenderSurface *surf, bool item_highlight, bool showFootpads) {
+	EndReuse();
+
 	if (_sortLimit) {
 		// Clear the surface when debugging the sorter
 		uint32 color = TEX32_PACK_RGB(0, 0, 0);
@@ -507,6 +595,8 @@ uint16 ItemSorter::Trace(int32 x, int32 y, HitFace *face, bool item_highlight) {
 	SortItem *it;
 	SortItem *selected;
 
+	EndReuse();
+
 	if (!_painted) { // If no painted item found, we need to sort the items
 		it = _items;
 		_painted = nullptr;
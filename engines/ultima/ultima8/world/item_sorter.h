@@ -22,6 +22,7 @@
 #ifndef ULTIMA8_WORLD_ITEMSORTER_H
 #define ULTIMA8_WORLD_ITEMSORTER_H
 
+#include "common/array.h"
 #include "ultima/ultima8/misc/rect.h"
 
 namespace Ultima {
@@ -46,6 +47,27 @@ class ItemSorter {
 	int32       _sortLimit;
 	bool        _sortLimitChanged;
 
+	// The arguments of every AddItem call since BeginDisplayList.
+	// If a frame adds the same items as the previous one, the sorted list
+	// and its dependencies are kept instead of being built again.
+	struct AddedItem {
+		int32 _x, _y, _z;
+		uint32 _shapeNum;
+		uint32 _frameNum;
+		uint32 _flags;
+		uint32 _extFlags;
+		uint16 _itemNum;
+
+		bool operator==(const AddedItem &o) const {
+			return _x == o._x && _y == o._y && _z == o._z && _shapeNum == o._shapeNum && _frameNum == o._frameNum &&
+				   _flags == o._flags && _extFlags == o._extFlags && _itemNum == o._itemNum;
+		}
+	};
+
+	Common::Array<AddedItem> _added;
+	uint        _addedCount;
+	bool        _reusing;
+
 public:
 	ItemSorter(int capacity);
 	~ItemSorter();
@@ -71,6 +93,12 @@ public:
 
 private:
 	bool PaintSortItem(RenderSurface *surf, SortItem *si, bool showFootpad);
+
+	// Remove everything the items added at or after addNum did to the list
+	void RollbackDisplayList(uint addNum);
+
+	// Stop reusing the previous display list
+	void EndReuse();
 };
 
 } // End of namespace Ultima8
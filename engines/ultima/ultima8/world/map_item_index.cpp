@@ -0,0 +1,74 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ultima/ultima8/world/map_item_index.h"
+
+namespace Ultima {
+namespace Ultima8 {
+
+MapItemIndex::MapItemIndex(int numChunks) : _numChunks(numChunks) {
+	_chunks.resize(numChunks * numChunks);
+}
+
+void MapItemIndex::clear() {
+	for (uint i = 0; i < _chunks.size(); i++)
+		_chunks[i].clear();
+}
+
+void MapItemIndex::addToStart(int cx, int cy, Item *item, int32 x, int32 y) {
+	chunk(cx, cy).insert_at(0, Entry(x, y, item));
+}
+
+void MapItemIndex::addToEnd(int cx, int cy, Item *item, int32 x, int32 y) {
+	chunk(cx, cy).push_back(Entry(x, y, item));
+}
+
+bool MapItemIndex::remove(int cx, int cy, const Item *item) {
+	int i = find(cx, cy, item);
+	if (i < 0)
+		return false;
+
+	chunk(cx, cy).remove_at(i);
+	return true;
+}
+
+bool MapItemIndex::setLocation(int cx, int cy, const Item *item, int32 x, int32 y) {
+	int i = find(cx, cy, item);
+	if (i < 0)
+		return false;
+
+	Entry &entry = chunk(cx, cy)[i];
+	entry._x = x;
+	entry._y = y;
+	return true;
+}
+
+int MapItemIndex::find(int cx, int cy, const Item *item) const {
+	const EntryArray &entries = getChunk(cx, cy);
+	for (uint i = 0; i < entries.size(); i++) {
+		if (entries[i]._item == item)
+			return i;
+	}
+	return -1;
+}
+
+} // End of namespace Ultima8
+} // End of namespace Ultima
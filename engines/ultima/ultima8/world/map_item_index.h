@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ULTIMA8_WORLD_MAPITEMINDEX_H
+#define ULTIMA8_WORLD_MAPITEMINDEX_H
+
+#include "common/array.h"
+#include "ultima/ultima8/misc/box.h"
+
+namespace Ultima {
+namespace Ultima8 {
+
+class Item;
+
+/**
+ * Locations of the items in each chunk of the current map, stored in
+ * contiguous arrays in the same order as the CurrentMap item lists.
+ *
+ * CurrentMap searches walk these arrays instead of the item lists so most
+ * items can be rejected by their location without touching the items
+ * themselves. The index never dereferences the item pointers.
+ */
+class MapItemIndex {
+public:
+	struct Entry {
+		Entry() : _x(0), _y(0), _item(nullptr) {}
+		Entry(int32 x, int32 y, Item *item) : _x(x), _y(y), _item(item) {}
+
+		int32 _x, _y;
+		Item *_item;
+
+		//! Check if an item located here can overlap the XY of the given
+		//! box, if the item's footpad is at most maxFootpad in x and y.
+		//! Boxes closer than slop are also considered overlapping.
+		bool mayOverlapXY(const Box &box, int32 maxFootpad, int32 slop) const {
+			return _x > box._x - box._xd - slop && _x < box._x + maxFootpad + slop &&
+				   _y > box._y - box._yd - slop && _y < box._y + maxFootpad + slop;
+		}
+	};
+
+	typedef Common::Array<Entry> EntryArray;
+
+	MapItemIndex(int numChunks);
+
+	//! Remove all items from all chunks
+	void clear();
+
+	//! Add an item to the start of the chunk
+	void addToStart(int cx, int cy, Item *item, int32 x, int32 y);
+
+	//! Add an item to the end of the chunk
+	void addToEnd(int cx, int cy, Item *item, int32 x, int32 y);
+
+	//! Remove an item from the chunk
+	//! \return false if the item was not in the chunk
+	bool remove(int cx, int cy, const Item *item);
+
+	//! Update the location of an item in the chunk
+	//! \return false if the item was not in the chunk
+	bool setLocation(int cx, int cy, const Item *item, int32 x, int32 y);
+
+	const EntryArray &getChunk(int cx, int cy) const {
+		return _chunks[cy * _numChunks + cx];
+	}
+
+private:
+	EntryArray &chunk(int cx, int cy) {
+		return _chunks[cy * _numChunks + cx];
+	}
+
+	int find(int cx, int cy, const Item *item) const;
+
+	int _numChunks;
+	Common::Array<EntryArray> _chunks;
+};
+
+} // End of namespace Ultima8
+} // End of namespace Ultima
+
+#endif
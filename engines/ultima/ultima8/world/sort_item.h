@@ -43,7 +43,7 @@ class Shape;
 struct SortItem {
 	SortItem() : _next(nullptr), _prev(nullptr), _itemNum(0),
 			_shape(nullptr), _order(-1), _depends(), _shapeNum(0),
-			_frame(0), _flags(0), _extFlags(0), _sr(),
+			_frame(0), _flags(0), _extFlags(0), _addNum(-1), _occludedBy(-1), _sr(),
 			_x(0), _y(0), _z(0), _xLeft(0),
 			_yFar(0), _zTop(0), _sxLeft(0), _sxRight(0), _sxTop(0),
 			_syTop(0), _sxBot(0), _syBot(0),_fbigsq(false), _flat(false),
@@ -63,6 +63,9 @@ struct SortItem {
 	uint32                  _flags;     // Item flags
 	uint32                  _extFlags;  // Item extended flags
 
+	int32                   _addNum;     // Position in the order items were added to the display list
+	int32                   _occludedBy; // _addNum of the item being added when this got occluded
+
 	Rect                    _sr; // Screenspace rect for shape frame
 	/*
 	            Bounding Box layout
@@ -208,6 +211,24 @@ struct SortItem {
 			tail = nn;
 		}
 
+		// Remove all the items added to the display list at or after addNum
+		void removeAddedFrom(int32 addNum) {
+			Node *n = list;
+			while (n != nullptr) {
+				Node *next = n->_next;
+				if (n->val->_addNum >= addNum) {
+					if (n->_prev) n->_prev->_next = next;
+					else list = next;
+					if (next) next->_prev = n->_prev;
+					else tail = n->_prev;
+
+					n->_next = unused;
+					unused = n;
+				}
+				n = next;
+			}
+		}
+
 		DependsList() : list(nullptr), tail(nullptr), unused(nullptr) { }
 
 		~DependsList() {
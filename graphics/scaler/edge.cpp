@@ -3618,6 +3618,7 @@ public:
 
 	bool canDrawCursor() const override { return false; }
 	bool useOldSource() const override { return true; }
+	bool canScaleInParallel() const override { return false; }
 	uint extraPixels() const override { return 1; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
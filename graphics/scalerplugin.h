@@ -199,6 +199,13 @@ public:
 	 */
 	virtual bool useOldSource() const { return false; }
 
+	/**
+	 * Indicates whether separate parts of a surface can be scaled at the
+	 * same time on different threads, using the same scaler instance.
+	 * Scalers which keep state between calls must return false.
+	 */
+	virtual bool canScaleInParallel() const { return true; }
+
 protected:
 	Common::Array<uint> _factors;
 };
@@ -27,6 +27,7 @@
 
 #include "common/singleton.h"
 #include "common/array.h"
+#include "common/config-manager.h"
 
 #include "graphics/tinygl/tinygl.h"
 #include "graphics/tinygl/zgl.h"
@@ -164,7 +165,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 
 	// allocate GLVertex array
 	vertex_max = POLYGON_MAX_VERTEX;
-	vertex = (GLVertex *)gl_malloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
+	vertex = (GLVertex *)gl_zalloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
 
 	// viewport
 	v = &viewport;
@@ -358,12 +359,15 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
 
+	_tiledRasterizationEnabled = ConfMan.hasKey("tinygl_tiled_rasterization") && ConfMan.getBool("tinygl_tiled_rasterization");
+
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
 
 void GLContext::deinit() {
 	disposeDrawCallLists();
 	disposeResources();
+	disposeRasterizationWorkers();
 
 	specbuf_cleanup();
 	for (int i = 0; i < 3; i++)
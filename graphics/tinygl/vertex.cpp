@@ -213,6 +213,9 @@ void GLContext::glopVertex(GLParam *p) {
 		if (!newarray) {
 			error("unable to allocate GLVertex array.");
 		}
+		// Unused fields are compared by the dirty rectangles code
+		for (int i = vertex_max / 2; i < vertex_max; i++)
+			newarray[i] = GLVertex();
 		vertex = newarray;
 	}
 	// new vertex entry
@@ -56,15 +56,31 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_currentTexture = nullptr;
 
 	_enableScissor = false;
+	_isView = false;
 }
 
 FrameBuffer::~FrameBuffer() {
+	// Views do not own the buffers they draw into
+	if (_isView)
+		return;
 	gl_free(_pbuf);
 	gl_free(_zbuf);
 	if (_sbuf)
 		gl_free(_sbuf);
 }
 
+FrameBuffer *FrameBuffer::createView() const {
+	FrameBuffer *view = new FrameBuffer(*this);
+	view->_isView = true;
+	return view;
+}
+
+void FrameBuffer::updateView(FrameBuffer *view) const {
+	assert(view->_isView);
+	*view = *this;
+	view->_isView = true;
+}
+
 Buffer *FrameBuffer::genOffscreenBuffer() {
 	Buffer *buf = (Buffer *)gl_malloc(sizeof(Buffer));
 	buf->pbuf = (byte *)gl_zalloc(_pbufHeight * _pbufPitch);
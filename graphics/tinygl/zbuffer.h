@@ -107,6 +107,19 @@ struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
 	~FrameBuffer();
 
+	/**
+	 * Create a framebuffer which draws into the same color, depth and stencil
+	 * buffers as this one, but keeps its own rasterization state. This allows
+	 * several threads to rasterize disjoint regions of the screen at once.
+	 */
+	FrameBuffer *createView() const;
+
+	/**
+	 * Make a view created by createView() use the current buffers and
+	 * rasterization state of this framebuffer.
+	 */
+	void updateView(FrameBuffer *view) const;
+
 	Graphics::PixelFormat getPixelFormat() {
 		return _pbufFormat;
 	}
@@ -764,6 +777,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _isView;
 
 	bool _enableStencil;
 	int _textureSize;
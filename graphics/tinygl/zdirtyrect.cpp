@@ -24,6 +24,7 @@
 #include "graphics/tinygl/gl.h"
 
 #include "common/debug.h"
+#include "common/thread.h"
 
 namespace TinyGL {
 
@@ -192,12 +193,20 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		if (useTiledRasterization()) {
+			Common::List<Common::Rect> clippingRectangles;
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+				clippingRectangles.push_back((*itRect).rectangle);
+			}
+			executeDrawCallsTiled(&clippingRectangles);
+		} else {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -239,9 +248,16 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 
 	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
 
-	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
-		delete *it;
+	if (useTiledRasterization()) {
+		executeDrawCallsTiled(nullptr);
+		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+			delete *it;
+		}
+	} else {
+		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+			(*it)->execute(true);
+			delete *it;
+		}
 	}
 
 	_drawCallsQueue.clear();
@@ -251,6 +267,152 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	_drawCallAllocator[_currentAllocatorIndex].reset();
 }
 
+// Height in pixels of the horizontal bands the screen is split into by the tiled rasterizer
+static const int kRasterizationTileHeight = 32;
+
+// Private context of a rasterization thread. The context is not a full
+// GLContext: it only holds what is needed to rasterize a draw call, copied
+// from the main context before every batch.
+struct RasterizationWorker {
+	GLContext context;
+	FrameBuffer *fb;
+	Common::Array<GLVertex> vertexBuffer;
+
+	RasterizationWorker(GLContext *parent) : fb(parent->fb->createView()) {
+		syncState(parent);
+	}
+
+	~RasterizationWorker() {
+		delete fb;
+	}
+
+	void syncState(GLContext *parent) {
+		parent->fb->updateView(fb);
+		context.fb = fb;
+		RasterizationDrawCall::copyState(&context, parent);
+	}
+};
+
+struct TiledRasterizationParams {
+	GLContext *context;
+	const Common::Array<const RasterizationDrawCall *> *drawCalls;
+	const Common::List<Common::Rect> *clippingRectangles;
+	uint workerCount;
+	int tileCount;
+};
+
+static void rasterizeTiles(void *param, uint job) {
+	const TiledRasterizationParams *params = (const TiledRasterizationParams *)param;
+	RasterizationWorker *worker = params->context->_rasterizationWorkers[job];
+	const Common::Array<const RasterizationDrawCall *> &drawCalls = *params->drawCalls;
+	const int fbWidth = worker->fb->getPixelBufferWidth();
+	const int fbHeight = worker->fb->getPixelBufferHeight();
+
+	// Every pixel belongs to exactly one tile, and each tile runs the draw
+	// calls in their original order, so the result matches serial rendering.
+	for (int tile = job; tile < params->tileCount; tile += params->workerCount) {
+		const Common::Rect tileRect(0, tile * kRasterizationTileHeight, fbWidth,
+		                            MIN((tile + 1) * kRasterizationTileHeight, fbHeight));
+
+		for (uint i = 0; i < drawCalls.size(); i++) {
+			const Common::Rect drawCallRegion = drawCalls[i]->getDirtyRegion();
+			if (!tileRect.intersects(drawCallRegion))
+				continue;
+
+			if (!params->clippingRectangles) {
+				drawCalls[i]->rasterize(&worker->context, tileRect, worker->vertexBuffer);
+				continue;
+			}
+
+			typedef Common::List<Common::Rect>::const_iterator RectangleIterator;
+			for (RectangleIterator itRect = params->clippingRectangles->begin(); itRect != params->clippingRectangles->end(); ++itRect) {
+				Common::Rect clippingRectangle = tileRect.findIntersectingRect(*itRect);
+				if (!clippingRectangle.isEmpty() && clippingRectangle.intersects(drawCallRegion))
+					drawCalls[i]->rasterize(&worker->context, clippingRectangle, worker->vertexBuffer);
+			}
+		}
+	}
+}
+
+bool GLContext::useTiledRasterization() {
+	if (!_tiledRasterizationEnabled)
+		return false;
+
+	if (_rasterizationWorkers.empty()) {
+		uint workerCount = Common::getWorkerThreadCount();
+		// Workers are only created once, so this check is done only once as well
+		if (workerCount <= 1) {
+			_tiledRasterizationEnabled = false;
+			return false;
+		}
+		for (uint i = 0; i < workerCount; i++) {
+			_rasterizationWorkers.push_back(new RasterizationWorker(this));
+		}
+	}
+	return true;
+}
+
+void GLContext::disposeRasterizationWorkers() {
+	for (uint i = 0; i < _rasterizationWorkers.size(); i++) {
+		delete _rasterizationWorkers[i];
+	}
+	_rasterizationWorkers.clear();
+}
+
+void GLContext::executeDrawCallsTiled(const Common::List<Common::Rect> *clippingRectangles) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+	typedef Common::List<Common::Rect>::const_iterator RectangleIterator;
+
+	Common::Array<const RasterizationDrawCall *> batch;
+
+	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+		const DrawCall *drawCall = *it;
+
+		// Consecutive rasterization draw calls are rendered together by the tile workers
+		if (drawCall->getType() == DrawCall::DrawCall_Rasterization &&
+		    !((const RasterizationDrawCall *)drawCall)->isSelection()) {
+			batch.push_back((const RasterizationDrawCall *)drawCall);
+			continue;
+		}
+
+		if (!batch.empty()) {
+			rasterizeTiled(batch, clippingRectangles);
+			batch.clear();
+		}
+
+		// Blitting and clearing rely on global state, they stay on this thread
+		if (!clippingRectangles) {
+			drawCall->execute(true);
+			continue;
+		}
+		Common::Rect drawCallRegion = drawCall->getDirtyRegion();
+		for (RectangleIterator itRect = clippingRectangles->begin(); itRect != clippingRectangles->end(); ++itRect) {
+			if ((*itRect).intersects(drawCallRegion)) {
+				drawCall->execute(*itRect, true);
+			}
+		}
+	}
+
+	if (!batch.empty()) {
+		rasterizeTiled(batch, clippingRectangles);
+	}
+}
+
+void GLContext::rasterizeTiled(const Common::Array<const RasterizationDrawCall *> &drawCalls, const Common::List<Common::Rect> *clippingRectangles) {
+	for (uint i = 0; i < _rasterizationWorkers.size(); i++) {
+		_rasterizationWorkers[i]->syncState(this);
+	}
+
+	TiledRasterizationParams params;
+	params.context = this;
+	params.drawCalls = &drawCalls;
+	params.clippingRectangles = clippingRectangles;
+	params.workerCount = _rasterizationWorkers.size();
+	params.tileCount = (fb->getPixelBufferHeight() + kRasterizationTileHeight - 1) / kRasterizationTileHeight;
+
+	Common::runParallelJobs(params.workerCount, rasterizeTiles, &params);
+}
+
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas) {
 	GLContext *c = gl_get_context();
 	if (c->_enableDirtyRectangles) {
@@ -293,8 +455,9 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
-	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	_state = captureState(c);
+	// The tiled rasterizer bins draw calls using their dirty region
+	if (c->_enableDirtyRectangles || c->_tiledRasterizationEnabled) {
 		computeDirtyRegion();
 	}
 }
@@ -337,19 +500,55 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
+	}
+	applyState(c, _state);
+
+	drawPrimitives(c, _vertex);
+
+	if (restoreState) {
+		applyState(c, backupState);
 	}
-	applyState(_state);
+}
+
+void RasterizationDrawCall::rasterize(GLContext *c, const Common::Rect &clippingRectangle, Common::Array<GLVertex> &vertexBuffer) const {
+	vertexBuffer.resize(_vertexCount);
+	memcpy(vertexBuffer.begin(), _vertex, sizeof(GLVertex) * _vertexCount);
+
+	applyState(c, _state);
+	c->fb->setScissorRectangle(clippingRectangle);
+	drawPrimitives(c, vertexBuffer.begin());
+	c->fb->resetScissorRectangle();
+}
 
+void RasterizationDrawCall::copyState(GLContext *dst, GLContext *src) {
+	applyState(dst, captureState(src));
+
+	dst->render_mode = src->render_mode;
+	dst->draw_triangle_front = src->draw_triangle_front;
+	dst->draw_triangle_back = src->draw_triangle_back;
+	dst->vertex = nullptr;
+	dst->vertex_n = 0;
+	dst->vertex_cnt = 0;
+	// Profiling counters are not thread safe
+	dst->_profilingEnabled = false;
+}
+
+bool RasterizationDrawCall::isSelection() const {
+	return _drawTriangleFront == GLContext::gl_draw_triangle_select;
+}
+
+void RasterizationDrawCall::drawPrimitives(GLContext *c, GLVertex *vertex) const {
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	c->vertex = vertex;
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
 
-	int n = c->vertex_n;
+	// The vertex count of a draw call is the vertex_n it was recorded with
+	int n = _vertexCount;
 	int cnt = c->vertex_cnt;
 
 	switch (c->begin_type) {
@@ -426,15 +625,10 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 
 	c->vertex = prevVertex;
 	c->vertex_cnt = prevVertexCount;
-
-	if (restoreState) {
-		applyState(backupState);
-	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(GLContext *c) {
 	RasterizationState state;
-	GLContext *c = gl_get_context();
 	state.enableBlending = c->blending_enabled;
 	state.sfactor = c->source_blending_factor;
 	state.dfactor = c->destination_blending_factor;
@@ -458,6 +652,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	state.offsetUnits = c->offset_units;
 
 	state.cullFaceEnabled = c->cull_face_enabled;
+	state.currentCullFace = c->current_cull_face;
 	state.beginType = c->begin_type;
 	state.colorMaskRed = c->color_mask_red;
 	state.colorMaskGreen = c->color_mask_green;
@@ -485,8 +680,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state) {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTestEnabled);
@@ -529,6 +723,7 @@ void RasterizationDrawCall::applyState(const RasterizationDrawCall::Rasterizatio
 
 	c->lighting_enabled = state.lightingEnabled;
 	c->cull_face_enabled = state.cullFaceEnabled;
+	c->current_cull_face = state.currentCullFace;
 	c->begin_type = state.beginType;
 	c->color_mask_red = state.colorMaskRed;
 	c->color_mask_green = state.colorMaskGreen;
@@ -748,6 +943,7 @@ bool RasterizationDrawCall::RasterizationState::operator==(const RasterizationSt
 		offsetUnits == other.offsetUnits &&
 		lightingEnabled == other.lightingEnabled &&
 		cullFaceEnabled == other.cullFaceEnabled &&
+		currentCullFace == other.currentCullFace &&
 		beginType == other.beginType &&
 		colorMaskRed == other.colorMaskRed &&
 		colorMaskGreen == other.colorMaskGreen &&
@@ -90,6 +90,21 @@ public:
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
 
+	/**
+	 * Rasterize the draw call using the given context, which may be
+	 * a worker context of the tiled rasterizer rather than the current one.
+	 * The vertices are copied to @p vertexBuffer first, so that several
+	 * threads can rasterize the same draw call at once.
+	 */
+	void rasterize(GLContext *c, const Common::Rect &clippingRectangle, Common::Array<GLVertex> &vertexBuffer) const;
+	bool isSelection() const;
+
+	/**
+	 * Copy the whole rasterization state of @p src to @p dst, whose
+	 * framebuffer must already be set.
+	 */
+	static void copyState(GLContext *dst, GLContext *src);
+
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
 	}
@@ -97,6 +112,7 @@ public:
 	void operator delete(void *p) { }
 private:
 	void computeDirtyRegion();
+	void drawPrimitives(GLContext *c, GLVertex *vertex) const;
 	typedef void (*gl_draw_triangle_func_ptr)(GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
 	int _vertexCount;
 	GLVertex *_vertex;
@@ -106,6 +122,7 @@ private:
 		int beginType;
 		int currentFrontFace;
 		int cullFaceEnabled;
+		int currentCullFace;
 		bool colorMaskRed;
 		bool colorMaskGreen;
 		bool colorMaskBlue;
@@ -152,8 +169,8 @@ private:
 
 	RasterizationState _state;
 
-	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	static RasterizationState captureState(GLContext *c);
+	static void applyState(GLContext *c, const RasterizationState &state);
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
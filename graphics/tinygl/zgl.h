@@ -275,6 +275,7 @@ private:
 };
 
 struct GLContext;
+struct RasterizationWorker;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 
@@ -467,6 +468,10 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Tiled rasterization
+	bool _tiledRasterizationEnabled;
+	Common::Array<RasterizationWorker *> _rasterizationWorkers;
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
@@ -524,6 +529,11 @@ public:
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
 
+	bool useTiledRasterization();
+	void executeDrawCallsTiled(const Common::List<Common::Rect> *clippingRectangles);
+	void rasterizeTiled(const Common::Array<const RasterizationDrawCall *> &drawCalls, const Common::List<Common::Rect> *clippingRectangles);
+	void disposeRasterizationWorkers();
+
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
 	GLSpecBuf *specbuf_get_buffer(const int shininess_i, const float shininess);
@@ -229,6 +229,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		p2 = tp;
 	}
 
+	// nothing to draw if the triangle is above or below the scissor rectangle
+	if (kEnableScissor && (p2->y < _clipRectangle.top || p0->y >= _clipRectangle.bottom))
+		return;
+
 	// we compute dXdx and dXdy for all interpolated values
 
 	fdx1 = (float)(p1->x - p0->x);
@@ -445,8 +449,15 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
+			// the scan lines below the scissor rectangle are not walked at all
+			if (kEnableScissor && y >= _clipRectangle.bottom)
+				return;
+
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && y < _clipRectangle.top) {
+				// only step the edges up to the scissor rectangle, so the
+				// interpolated values match those of an unclipped triangle
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -82,8 +82,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_rows.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -181,6 +184,9 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	}
 }
 
+YUVToRGBManager::RowFunc YUVToRGBManager::_rowFunc = nullptr;
+bool YUVToRGBManager::_rowFuncSelected = false;
+
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
 }
@@ -198,6 +204,52 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+void YUVToRGBManager::setRowFunc(RowFunc func) {
+	_rowFunc = func;
+	_rowFuncSelected = true;
+}
+
+YUVToRGBManager::RowFunc YUVToRGBManager::getRowFunc() {
+	// If no kernel has been selected yet, detect and select. Without SIMD,
+	// the lookup tables are faster than the fixed point arithmetic.
+	if (!_rowFuncSelected) {
+		_rowFuncSelected = true;
+		if (g_system) {
+#ifdef SCUMMVM_NEON
+			if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) _rowFunc = convertRowNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+			if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) _rowFunc = convertRowSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+			if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) _rowFunc = convertRowAVX2;
+#endif
+		}
+	}
+
+	return _rowFunc;
+}
+
+/**
+ * Convert an image one row at a time with a row kernel. The chroma planes
+ * have half the height of the image if @p halfHeight is set, and half its
+ * width if @p halfWidth is set.
+ */
+static void convertRows(YUVToRGBManager::RowFunc rowFunc, Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, bool halfWidth, bool halfHeight) {
+	const YUVToRGBRowFormat format(dst->format, scale);
+	byte *dstPtr = (byte *)dst->getPixels();
+
+	for (int y = 0; y < yHeight; y++) {
+		const int uvOffset = (halfHeight ? (y >> 1) : y) * uvPitch;
+		rowFunc(dstPtr, ySrc, uSrc + uvOffset, vSrc + uvOffset, aSrc, yWidth, halfWidth, format);
+
+		dstPtr += dst->pitch;
+		ySrc += yPitch;
+		if (aSrc)
+			aSrc += yPitch;
+	}
+}
+
 #define PUT_PIXEL(s, d) \
 	L = &clipTable[(s)]; \
 	*((PixelInt *)(d)) = ((L[cr_r] << r_shift) | (L[crb_g] << g_shift) | (L[cb_b] << b_shift) | a_mask)
@@ -244,6 +296,12 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	RowFunc rowFunc = getRowFunc();
+	if (rowFunc) {
+		convertRows(rowFunc, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, false, false);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -301,6 +359,12 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(ySrc && uSrc && vSrc);
 	assert((yWidth & 1) == 0);
 
+	RowFunc rowFunc = getRowFunc();
+	if (rowFunc) {
+		convertRows(rowFunc, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, true, false);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -362,6 +426,12 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	RowFunc rowFunc = getRowFunc();
+	if (rowFunc) {
+		convertRows(rowFunc, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, true, true);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -431,6 +501,12 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	RowFunc rowFunc = getRowFunc();
+	if (rowFunc) {
+		convertRows(rowFunc, dst, scale, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, true, true);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -513,6 +589,44 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
 
+/**
+ * Convert a YUV410 image with a row kernel, interpolating the chroma of
+ * each row the same way as convertYUV410ToRGB.
+ */
+static void convertRows410(YUVToRGBManager::RowFunc rowFunc, Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const YUVToRGBRowFormat format(dst->format, scale);
+	byte *dstPtr = (byte *)dst->getPixels();
+
+	byte *uRow = new byte[yWidth * 2];
+	byte *vRow = uRow + yWidth;
+
+	for (int y = 0; y < yHeight; y++) {
+		const int yDiff = y & 3;
+		const byte *uQuad = uSrc + (y >> 2) * uvPitch;
+		const byte *vQuad = vSrc + (y >> 2) * uvPitch;
+
+		for (int x = 0; x < yWidth; x++) {
+			const int xDiff = x & 3;
+			const int index = x >> 2;
+
+			const int wA = (4 - xDiff) * (4 - yDiff);
+			const int wB = xDiff * (4 - yDiff);
+			const int wC = yDiff * (4 - xDiff);
+			const int wD = xDiff * yDiff;
+
+			uRow[x] = (uQuad[index] * wA + uQuad[index + 1] * wB + uQuad[index + uvPitch] * wC + uQuad[index + uvPitch + 1] * wD) >> 4;
+			vRow[x] = (vQuad[index] * wA + vQuad[index + 1] * wB + vQuad[index + uvPitch] * wC + vQuad[index + uvPitch + 1] * wD) >> 4;
+		}
+
+		rowFunc(dstPtr, ySrc, uRow, vRow, nullptr, yWidth, false, format);
+
+		dstPtr += dst->pitch;
+		ySrc += yPitch;
+	}
+
+	delete[] uRow;
+}
+
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -521,6 +635,12 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
+	RowFunc rowFunc = getRowFunc();
+	if (rowFunc) {
+		convertRows410(rowFunc, dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
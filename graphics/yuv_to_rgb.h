@@ -44,6 +44,7 @@
 namespace Graphics {
 
 class YUVToRGBLookup;
+struct YUVToRGBRowFormat;
 
 class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
 public:
@@ -53,6 +54,42 @@ public:
 		kScaleITU   /** Luminance values range from [16, 235], the range from ITU-R BT.601 */
 	};
 
+	/**
+	 * A kernel converting a row of pixels with fixed point arithmetic
+	 * instead of the lookup tables.
+	 *
+	 * @param dst        the destination pixels
+	 * @param ySrc       the source of the y component
+	 * @param uSrc       the source of the u component
+	 * @param vSrc       the source of the v component
+	 * @param aSrc       the source of the a component, or nullptr for opaque pixels
+	 * @param width      the number of pixels to convert
+	 * @param halfChroma whether there is one u and v sample for every two pixels
+	 * @param format     the destination pixel format and the luminance scale
+	 */
+	typedef void (*RowFunc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, bool halfChroma, const YUVToRGBRowFormat &format);
+
+#ifdef SCUMMVM_NEON
+	static void convertRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, bool halfChroma, const YUVToRGBRowFormat &format);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void convertRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, bool halfChroma, const YUVToRGBRowFormat &format);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void convertRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, bool halfChroma, const YUVToRGBRowFormat &format);
+#endif
+
+	/**
+	 * Select the row kernel used by the conversions. By default, the
+	 * fastest SIMD kernel supported by the CPU is used. With nullptr,
+	 * or if the CPU has no supported SIMD extension, the lookup tables
+	 * are used.
+	 *
+	 * The results of the kernels may differ from the lookup tables by
+	 * at most one for each color component.
+	 */
+	static void setRowFunc(RowFunc func);
+
 	/**
 	 * Convert a YUV444 image to an RGB surface
 	 *
@@ -142,7 +179,13 @@ private:
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
+	/** Return the selected row kernel, or nullptr to use the lookup tables. */
+	static RowFunc getRowFunc();
+
 	YUVToRGBLookup *_lookup;
+
+	static RowFunc _rowFunc;
+	static bool _rowFuncSelected;
 };
  /** @} */
 } // End of namespace Graphics
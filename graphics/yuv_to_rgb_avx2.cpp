@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_rows.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+/** Multiply signed chroma samples by a coefficient, truncating towards zero. */
+static inline __m256i chromaAVX2(__m256i c, int coef) {
+	const __m256i t = _mm256_mulhi_epu16(_mm256_slli_epi16(_mm256_abs_epi16(c), 2), _mm256_set1_epi16(coef));
+	return _mm256_sign_epi16(t, c);
+}
+
+static inline __m256i clipAVX2(__m256i x, bool fullScale) {
+	if (fullScale)
+		return _mm256_min_epi16(_mm256_max_epi16(x, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+
+	x = _mm256_sub_epi16(_mm256_min_epi16(_mm256_max_epi16(x, _mm256_set1_epi16(16)), _mm256_set1_epi16(235)), _mm256_set1_epi16(16));
+	const __m256i frac = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(x, _mm256_set1_epi16(36)), _mm256_set1_epi16((int16)38305)), 7);
+	return _mm256_add_epi16(x, frac);
+}
+
+/** Load 16 chroma samples minus 128, repeating each sample twice for half width chroma. */
+static inline __m256i loadChromaAVX2(const byte *src, int x, bool halfChroma) {
+	__m256i c;
+	if (halfChroma) {
+		const __m128i half = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(src + (x >> 1))));
+		c = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(half, half)), _mm_unpackhi_epi16(half, half), 1);
+	} else {
+		c = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + x)));
+	}
+	return _mm256_sub_epi16(c, _mm256_set1_epi16(128));
+}
+
+/** Widen 16 16-bit components to 32 bits and shift them into place. */
+static inline void shiftComponentAVX2(__m256i c, __m128i shift, __m256i &lo, __m256i &hi) {
+	lo = _mm256_or_si256(lo, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(c)), shift));
+	hi = _mm256_or_si256(hi, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(c, 1)), shift));
+}
+
+void YUVToRGBManager::convertRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, bool halfChroma, const YUVToRGBRowFormat &format) {
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss), rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss), gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss), bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m128i aLoss = _mm_cvtsi32_si128(format.aLoss), aShift = _mm_cvtsi32_si128(format.aShift);
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		const __m256i u = loadChromaAVX2(uSrc, x, halfChroma);
+		const __m256i v = loadChromaAVX2(vSrc, x, halfChroma);
+
+		__m256i r = _mm256_add_epi16(y, chromaAVX2(v, kYUVToRGBCrR));
+		__m256i g = _mm256_sub_epi16(_mm256_sub_epi16(y, chromaAVX2(v, kYUVToRGBCrG)), chromaAVX2(u, kYUVToRGBCbG));
+		__m256i b = _mm256_add_epi16(y, chromaAVX2(u, kYUVToRGBCbB));
+		__m256i a = aSrc ? _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(aSrc + x))) : _mm256_set1_epi16(0xFF);
+
+		r = _mm256_srl_epi16(clipAVX2(r, format.fullScale), rLoss);
+		g = _mm256_srl_epi16(clipAVX2(g, format.fullScale), gLoss);
+		b = _mm256_srl_epi16(clipAVX2(b, format.fullScale), bLoss);
+		a = _mm256_srl_epi16(a, aLoss);
+
+		if (format.bytesPerPixel == 2) {
+			const __m256i pixels = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(r, rShift), _mm256_sll_epi16(g, gShift)),
+			                                       _mm256_or_si256(_mm256_sll_epi16(b, bShift), _mm256_sll_epi16(a, aShift)));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), pixels);
+		} else {
+			__m256i lo = _mm256_setzero_si256();
+			__m256i hi = _mm256_setzero_si256();
+			shiftComponentAVX2(r, rShift, lo, hi);
+			shiftComponentAVX2(g, gShift, lo, hi);
+			shiftComponentAVX2(b, bShift, lo, hi);
+			shiftComponentAVX2(a, aShift, lo, hi);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4), lo);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4 + 32), hi);
+		}
+	}
+
+	yuvToRGBRowTail(dst, ySrc, uSrc, vSrc, aSrc, x, width, halfChroma, format);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,134 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "common/endian.h"
+
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_rows.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Graphics {
+
+/** Multiply signed chroma samples by a coefficient, truncating towards zero. */
+static inline int16x8_t chromaNEON(int16x8_t c, uint16 coef) {
+	const uint16x8_t abs = vreinterpretq_u16_s16(vabsq_s16(c));
+	const uint16x4_t lo = vshrn_n_u32(vmull_n_u16(vget_low_u16(abs), coef), 14);
+	const uint16x4_t hi = vshrn_n_u32(vmull_n_u16(vget_high_u16(abs), coef), 14);
+	const int16x8_t t = vreinterpretq_s16_u16(vcombine_u16(lo, hi));
+	return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(t), t);
+}
+
+static inline uint16x8_t clipNEON(int16x8_t x, bool fullScale) {
+	if (fullScale)
+		return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(x, vdupq_n_s16(0)), vdupq_n_s16(255)));
+
+	const uint16x8_t c = vreinterpretq_u16_s16(vsubq_s16(vminq_s16(vmaxq_s16(x, vdupq_n_s16(16)), vdupq_n_s16(235)), vdupq_n_s16(16)));
+	const uint16x8_t m = vmulq_n_u16(c, 36);
+	const uint16x4_t lo = vshrn_n_u32(vmull_n_u16(vget_low_u16(m), 38305), 16);
+	const uint16x4_t hi = vshrn_n_u32(vmull_n_u16(vget_high_u16(m), 38305), 16);
+	return vaddq_u16(c, vshrq_n_u16(vcombine_u16(lo, hi), 7));
+}
+
+/** Load 8 chroma samples minus 128, repeating each sample twice for half width chroma. */
+static inline int16x8_t loadChromaNEON(const byte *src, int x, bool halfChroma) {
+	uint16x8_t c;
+	if (halfChroma) {
+		const uint16x4_t half = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(READ_UINT32(src + (x >> 1))))));
+		const uint16x4x2_t twice = vzip_u16(half, half);
+		c = vcombine_u16(twice.val[0], twice.val[1]);
+	} else {
+		c = vmovl_u8(vld1_u8(src + x));
+	}
+	return vsubq_s16(vreinterpretq_s16_u16(c), vdupq_n_s16(128));
+}
+
+/** Widen 8 16-bit components to 32 bits and shift them into place. */
+static inline void shiftComponentNEON(uint16x8_t c, int32x4_t shift, uint32x4_t &lo, uint32x4_t &hi) {
+	lo = vorrq_u32(lo, vshlq_u32(vmovl_u16(vget_low_u16(c)), shift));
+	hi = vorrq_u32(hi, vshlq_u32(vmovl_u16(vget_high_u16(c)), shift));
+}
+
+void YUVToRGBManager::convertRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, bool halfChroma, const YUVToRGBRowFormat &format) {
+	// Shifting by a negative count shifts to the right
+	const int16x8_t rLoss = vdupq_n_s16(-format.rLoss), rShift16 = vdupq_n_s16(format.rShift);
+	const int16x8_t gLoss = vdupq_n_s16(-format.gLoss), gShift16 = vdupq_n_s16(format.gShift);
+	const int16x8_t bLoss = vdupq_n_s16(-format.bLoss), bShift16 = vdupq_n_s16(format.bShift);
+	const int16x8_t aLoss = vdupq_n_s16(-format.aLoss), aShift16 = vdupq_n_s16(format.aShift);
+	const int32x4_t rShift32 = vdupq_n_s32(format.rShift), gShift32 = vdupq_n_s32(format.gShift);
+	const int32x4_t bShift32 = vdupq_n_s32(format.bShift), aShift32 = vdupq_n_s32(format.aShift);
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+		const int16x8_t u = loadChromaNEON(uSrc, x, halfChroma);
+		const int16x8_t v = loadChromaNEON(vSrc, x, halfChroma);
+
+		const int16x8_t r = vaddq_s16(y, chromaNEON(v, kYUVToRGBCrR));
+		const int16x8_t g = vsubq_s16(vsubq_s16(y, chromaNEON(v, kYUVToRGBCrG)), chromaNEON(u, kYUVToRGBCbG));
+		const int16x8_t b = vaddq_s16(y, chromaNEON(u, kYUVToRGBCbB));
+		const uint16x8_t a = aSrc ? vmovl_u8(vld1_u8(aSrc + x)) : vdupq_n_u16(0xFF);
+
+		const uint16x8_t rc = vshlq_u16(clipNEON(r, format.fullScale), rLoss);
+		const uint16x8_t gc = vshlq_u16(clipNEON(g, format.fullScale), gLoss);
+		const uint16x8_t bc = vshlq_u16(clipNEON(b, format.fullScale), bLoss);
+		const uint16x8_t ac = vshlq_u16(a, aLoss);
+
+		if (format.bytesPerPixel == 2) {
+			const uint16x8_t pixels = vorrq_u16(vorrq_u16(vshlq_u16(rc, rShift16), vshlq_u16(gc, gShift16)),
+			                                    vorrq_u16(vshlq_u16(bc, bShift16), vshlq_u16(ac, aShift16)));
+			vst1q_u8(dst + x * 2, vreinterpretq_u8_u16(pixels));
+		} else {
+			uint32x4_t lo = vdupq_n_u32(0);
+			uint32x4_t hi = vdupq_n_u32(0);
+			shiftComponentNEON(rc, rShift32, lo, hi);
+			shiftComponentNEON(gc, gShift32, lo, hi);
+			shiftComponentNEON(bc, bShift32, lo, hi);
+			shiftComponentNEON(ac, aShift32, lo, hi);
+			vst1q_u8(dst + x * 4, vreinterpretq_u8_u32(lo));
+			vst1q_u8(dst + x * 4 + 16, vreinterpretq_u8_u32(hi));
+		}
+	}
+
+	yuvToRGBRowTail(dst, ySrc, uSrc, vSrc, aSrc, x, width, halfChroma, format);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif // __GNUC__
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,109 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_YUV_TO_RGB_ROWS_H
+#define GRAPHICS_YUV_TO_RGB_ROWS_H
+
+#include "common/util.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/yuv_to_rgb.h"
+
+namespace Graphics {
+
+/**
+ * The chroma coefficients of the conversion, multiplied by 2^14. Each of
+ * them truncates to the same values as the lookup tables for every
+ * chroma sample.
+ */
+enum {
+	kYUVToRGBCrR = 22950, // 0.419 / 0.299
+	kYUVToRGBCrG = 11692, // 0.299 / 0.419
+	kYUVToRGBCbG = 5642,  // 0.114 / 0.331
+	kYUVToRGBCbB = 29055  // 0.587 / 0.331
+};
+
+/** The destination format of the row kernels. */
+struct YUVToRGBRowFormat {
+	uint bytesPerPixel;
+	bool fullScale; ///< Whether the luminance values range from [0, 255] instead of [16, 235]
+
+	byte rLoss, gLoss, bLoss, aLoss;
+	byte rShift, gShift, bShift, aShift;
+
+	uint32 aMask; ///< The alpha bits of opaque pixels
+
+	YUVToRGBRowFormat(const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) :
+			bytesPerPixel(format.bytesPerPixel), fullScale(scale == YUVToRGBManager::kScaleFull),
+			rLoss(format.rLoss), gLoss(format.gLoss), bLoss(format.bLoss), aLoss(format.aLoss),
+			rShift(format.rShift), gShift(format.gShift), bShift(format.bShift), aShift(format.aShift) {
+		aMask = (0xFF >> aLoss) << aShift;
+	}
+};
+
+/** Multiply a chroma sample minus 128 by a coefficient, truncating towards zero. */
+static inline int yuvToRGBChroma(int c, int coef) {
+	const int t = ((c < 0 ? -c : c) * coef) >> 14;
+	return c < 0 ? -t : t;
+}
+
+/** Clip a color component, and scale it to [0, 255] for ITU luminance values. */
+static inline int yuvToRGBClip(int x, bool fullScale) {
+	if (fullScale)
+		return CLIP(x, 0, 255);
+
+	x = CLIP(x, 16, 235) - 16;
+	return x + ((x * 36 * 38305) >> 23); // x * 255 / 219
+}
+
+/** Convert a single pixel with the arithmetic of the row kernels. */
+static inline void yuvToRGBPixel(byte *dst, int y, int u, int v, int a, const YUVToRGBRowFormat &format) {
+	u -= 128;
+	v -= 128;
+
+	const int r = yuvToRGBClip(y + yuvToRGBChroma(v, kYUVToRGBCrR), format.fullScale);
+	const int g = yuvToRGBClip(y - yuvToRGBChroma(v, kYUVToRGBCrG) - yuvToRGBChroma(u, kYUVToRGBCbG), format.fullScale);
+	const int b = yuvToRGBClip(y + yuvToRGBChroma(u, kYUVToRGBCbB), format.fullScale);
+
+	const uint32 pixel = ((r >> format.rLoss) << format.rShift) | ((g >> format.gLoss) << format.gShift) |
+	                     ((b >> format.bLoss) << format.bShift) | ((a >> format.aLoss) << format.aShift);
+
+	if (format.bytesPerPixel == 2)
+		*(uint16 *)dst = pixel;
+	else
+		*(uint32 *)dst = pixel;
+}
+
+/**
+ * Convert the pixels of a row from @p start on, one at a time. Used by the
+ * kernels for the pixels after the last full vector.
+ */
+static inline void yuvToRGBRowTail(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int start, int width, bool halfChroma, const YUVToRGBRowFormat &format) {
+	for (int x = start; x < width; x++) {
+		const int c = halfChroma ? (x >> 1) : x;
+		yuvToRGBPixel(dst + x * format.bytesPerPixel, ySrc[x], uSrc[c], vSrc[c], aSrc ? aSrc[x] : 0xFF, format);
+	}
+}
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+#include "common/endian.h"
+
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_rows.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Graphics {
+
+/** Multiply signed chroma samples by a coefficient, truncating towards zero. */
+static inline __m128i chromaSSE2(__m128i c, int coef) {
+	const __m128i sign = _mm_srai_epi16(c, 15);
+	const __m128i abs = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	const __m128i t = _mm_mulhi_epu16(_mm_slli_epi16(abs, 2), _mm_set1_epi16(coef));
+	return _mm_sub_epi16(_mm_xor_si128(t, sign), sign);
+}
+
+static inline __m128i clipSSE2(__m128i x, bool fullScale) {
+	if (fullScale)
+		return _mm_min_epi16(_mm_max_epi16(x, _mm_setzero_si128()), _mm_set1_epi16(255));
+
+	x = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(x, _mm_set1_epi16(16)), _mm_set1_epi16(235)), _mm_set1_epi16(16));
+	const __m128i frac = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(x, _mm_set1_epi16(36)), _mm_set1_epi16((int16)38305)), 7);
+	return _mm_add_epi16(x, frac);
+}
+
+/** Load 8 chroma samples minus 128, repeating each sample twice for half width chroma. */
+static inline __m128i loadChromaSSE2(const byte *src, int x, bool halfChroma) {
+	__m128i c;
+	if (halfChroma) {
+		c = _mm_unpacklo_epi8(_mm_cvtsi32_si128(READ_UINT32(src + (x >> 1))), _mm_setzero_si128());
+		c = _mm_unpacklo_epi16(c, c);
+	} else {
+		c = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + x)), _mm_setzero_si128());
+	}
+	return _mm_sub_epi16(c, _mm_set1_epi16(128));
+}
+
+void YUVToRGBManager::convertRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, bool halfChroma, const YUVToRGBRowFormat &format) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss), rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss), gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss), bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m128i aLoss = _mm_cvtsi32_si128(format.aLoss), aShift = _mm_cvtsi32_si128(format.aShift);
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+		const __m128i u = loadChromaSSE2(uSrc, x, halfChroma);
+		const __m128i v = loadChromaSSE2(vSrc, x, halfChroma);
+
+		__m128i r = _mm_add_epi16(y, chromaSSE2(v, kYUVToRGBCrR));
+		__m128i g = _mm_sub_epi16(_mm_sub_epi16(y, chromaSSE2(v, kYUVToRGBCrG)), chromaSSE2(u, kYUVToRGBCbG));
+		__m128i b = _mm_add_epi16(y, chromaSSE2(u, kYUVToRGBCbB));
+		__m128i a = aSrc ? _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(aSrc + x)), zero) : _mm_set1_epi16(0xFF);
+
+		r = _mm_srl_epi16(clipSSE2(r, format.fullScale), rLoss);
+		g = _mm_srl_epi16(clipSSE2(g, format.fullScale), gLoss);
+		b = _mm_srl_epi16(clipSSE2(b, format.fullScale), bLoss);
+		a = _mm_srl_epi16(a, aLoss);
+
+		if (format.bytesPerPixel == 2) {
+			const __m128i pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift)),
+			                                    _mm_or_si128(_mm_sll_epi16(b, bShift), _mm_sll_epi16(a, aShift)));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), pixels);
+		} else {
+			const __m128i lo = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift)),
+			                                _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift), _mm_sll_epi32(_mm_unpacklo_epi16(a, zero), aShift)));
+			const __m128i hi = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift)),
+			                                _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift), _mm_sll_epi32(_mm_unpackhi_epi16(a, zero), aShift)));
+			_mm_storeu_si128((__m128i *)(dst + x * 4), lo);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	yuvToRGBRowTail(dst, ySrc, uSrc, vSrc, aSrc, x, width, halfChroma, format);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
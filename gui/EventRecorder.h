@@ -38,7 +38,11 @@
 #include "backends/mixer/mixer.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#ifdef SDL_BACKEND
 #include "backends/timer/sdl/sdl-timer.h"
+#else
+#include "backends/timer/default/default-timer.h"
+#endif
 #include "common/config-manager.h"
 #include "common/recorderfile.h"
 #include "backends/saves/recorder/recorder-saves.h"
@@ -77,7 +81,16 @@ public:
 		kRecorderUpdate = 4			/**< kRecorderUpdate, playback existing recording and update all hashes */
 	};
 
-	void init(const Common::String &recordFileName, RecordMode mode);
+	/**
+	 * Start recording or playing back.
+	 *
+	 * @param recordFileName Name of the record file
+	 * @param mode           Operation mode
+	 * @param benchmark      Play back as fast as possible, without drawing
+	 *                       the control panel, so the backend can measure
+	 *                       the replayed frames
+	 */
+	void init(const Common::String &recordFileName, RecordMode mode, bool benchmark = false);
 	void deinit();
 	bool processDelayMillis();
 	uint32 getRandomSeed(const Common::String &name);
@@ -173,11 +186,35 @@ public:
 		return _recordMode;
 	}
 
+	/** Return true if a recording is played back as a benchmark */
+	bool isBenchmark() const {
+		return _benchmark && _initialized;
+	}
+
+	/** Count the result of comparing a screenshot with the recorded one */
+	void processScreenshotCheck(bool match) {
+		_screenshotChecks++;
+		if (!match)
+			_screenshotFailures++;
+	}
+
+	/** Number of screenshots compared during playback */
+	uint32 getScreenshotChecks() const {
+		return _screenshotChecks;
+	}
+
+	/** Number of screenshots which differed from the recorded ones */
+	uint32 getScreenshotFailures() const {
+		return _screenshotFailures;
+	}
+
 	Common::StringArray listSaveFiles(const Common::String &pattern);
 	Common::String generateRecordFileName(const Common::String &target);
 
 	Common::SaveFileManager *getSaveManager(Common::SaveFileManager *realSaveManager);
+#ifdef SDL_BACKEND
 	SDL_Surface *getSurface(int width, int height);
+#endif
 	void RegisterEventSource();
 
 	/** Retrieve game screenshot and compute its checksum for comparison */
@@ -247,6 +284,9 @@ private:
 	volatile RecordMode _recordMode;
 	Common::String _recordFileName;
 	bool _fastPlayback;
+	bool _benchmark;
+	uint32 _screenshotChecks;
+	uint32 _screenshotFailures;
 	bool _needRedraw;
 	bool _processingMillis;
 };
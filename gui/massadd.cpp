@@ -25,6 +25,7 @@
 #include "common/debug.h"
 #include "common/system.h"
 #include "common/taskbar.h"
+#include "common/thread.h"
 #include "common/translation.h"
 
 #include "engines/advancedDetector.h"
@@ -46,7 +47,11 @@ enum {
 	// Upper bound (im milliseconds) we want to spend in handleTickle.
 	// Setting this low makes the GUI more responsive but also slows
 	// down the scanning.
-	kMaxScanTime = 50
+	kMaxScanTime = 50,
+
+	// Number of directories listed in parallel when worker threads
+	// are available
+	kScanBatchSize = 8
 };
 
 enum {
@@ -70,6 +75,9 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	// The dir we start our scan at
 	_scanStack.push(startDir);
 
+	// Write the detection cache once the scan is over, not for every directory
+	ADCacheMan.setPersistentCacheSaveDeferred(true);
+
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
 
@@ -109,6 +117,24 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	}
 }
 
+struct ScanEntry {
+	Common::FSNode dir;
+	Common::FSList files;
+	bool listed;
+
+	ScanEntry() : listed(false) {}
+};
+
+static void listDirectoryJob(void *param, uint job) {
+	ScanEntry &entry = (*(Common::Array<ScanEntry> *)param)[job];
+	entry.listed = entry.dir.getChildren(entry.files, Common::FSNode::kListAll);
+}
+
+MassAddDialog::~MassAddDialog() {
+	// Store what was detected before the scan was cancelled
+	ADCacheMan.setPersistentCacheSaveDeferred(false);
+}
+
 struct GameTargetLess {
 	bool operator()(const DetectedGame &x, const DetectedGame &y) const {
 		return x.preferredTarget.compareToIgnoreCase(y.preferredTarget) < 0;
@@ -183,93 +209,106 @@ void MassAddDialog::updateGameList() {
 	}
 }
 
-void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
-		return;	// We have finished scanning
+void MassAddDialog::scanDirectory(const Common::FSNode &dir, const Common::FSList &files) {
+	// Run the detector on the dir
+	DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED), true);
 
-	uint32 t = g_system->getMillis();
+	if (detectionResults.foundUnknownGames()) {
+		Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
+		g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
+	}
 
-	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
+	// Just add all detected games / game variants. If we get more than one,
+	// that either means the directory contains multiple games, or the detector
+	// could not fully determine which game variant it was seeing. In either
+	// case, let the user choose which entries he wants to keep.
+	//
+	// However, we only add games which are not already in the config file.
+	DetectedGames candidates = detectionResults.listRecognizedGames();
+	for (DetectedGames::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
+		const DetectedGame &result = *cand;
+
+		Common::Path path = dir.getPath();
+		path.removeTrailingSeparators();
 
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
+		// Check for existing config entries for this path/engineid/gameid/lang/platform combination
+		if (_pathToTargets.contains(path)) {
+			Common::String resultPlatformCode = Common::getPlatformCode(result.platform);
+			Common::String resultLanguageCode = Common::getLanguageCode(result.language);
+
+			bool duplicate = false;
+			const Common::StringArray &targets = _pathToTargets[path];
+			for (Common::StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
+				// If the engineid, gameid, platform and language match -> skip it
+				Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
+				assert(dom);
+
+				if ((!dom->contains("engineid") || (*dom)["engineid"] == result.engineId) &&
+					(*dom)["gameid"] == result.gameId &&
+				    dom->getValOrDefault("platform") == resultPlatformCode &&
+					parseLanguage(dom->getValOrDefault("language")) == parseLanguage(resultLanguageCode)) {
+					duplicate = true;
+					break;
+				}
+			}
+			if (duplicate) {
+				_oldGamesCount++;
+				continue;	// Skip duplicates
+			}
 		}
+		_games.push_back(result);
 
-		// Run the detector on the dir
-		DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED), true);
+		_list->append(result.description);
+	}
 
-		if (detectionResults.foundUnknownGames()) {
-			Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
-			g_system->logMessage(LogMessageType::kInfo, report.encode().c_str());
-		}
+	for (DetectedGame &game : _games) {
+		game.isSelected = true;
+	}
 
-		// Just add all detected games / game variants. If we get more than one,
-		// that either means the directory contains multiple games, or the detector
-		// could not fully determine which game variant it was seeing. In either
-		// case, let the user choose which entries he wants to keep.
-		//
-		// However, we only add games which are not already in the config file.
-		DetectedGames candidates = detectionResults.listRecognizedGames();
-		for (DetectedGames::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
-			const DetectedGame &result = *cand;
-
-			Common::Path path = dir.getPath();
-			path.removeTrailingSeparators();
-
-			// Check for existing config entries for this path/engineid/gameid/lang/platform combination
-			if (_pathToTargets.contains(path)) {
-				Common::String resultPlatformCode = Common::getPlatformCode(result.platform);
-				Common::String resultLanguageCode = Common::getLanguageCode(result.language);
-
-				bool duplicate = false;
-				const Common::StringArray &targets = _pathToTargets[path];
-				for (Common::StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
-					// If the engineid, gameid, platform and language match -> skip it
-					Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
-					assert(dom);
-
-					if ((!dom->contains("engineid") || (*dom)["engineid"] == result.engineId) &&
-						(*dom)["gameid"] == result.gameId &&
-					    dom->getValOrDefault("platform") == resultPlatformCode &&
-						parseLanguage(dom->getValOrDefault("language")) == parseLanguage(resultLanguageCode)) {
-						duplicate = true;
-						break;
-					}
-				}
-				if (duplicate) {
-					_oldGamesCount++;
-					continue;	// Skip duplicates
-				}
-			}
-			_games.push_back(result);
+	updateGameList();
 
-			_list->append(result.description);
-		}
+	// Recurse into all subdirs
+	for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+		if (file->isDirectory()) {
+			_scanStack.push(*file);
 
-		for (DetectedGame &game : _games) {
-			game.isSelected = true;
+			_dirTotal++;
 		}
+	}
 
-		updateGameList();
+	_dirsScanned++;
 
-		// Recurse into all subdirs
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
+#if defined(USE_TASKBAR)
+	g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
+	g_system->getTaskbarManager()->setCount(_games.size());
+#endif
+}
 
-				_dirTotal++;
-			}
+void MassAddDialog::handleTickle() {
+	if (_scanStack.empty())
+		return;	// We have finished scanning
+
+	uint32 t = g_system->getMillis();
+
+	// Listing directories is slow on network shares, so when worker threads
+	// are available, take several directories at once and list them in
+	// parallel. Detection then runs on them in the order they were taken.
+	uint batchSize = Common::getWorkerThreadCount() > 1 ? kScanBatchSize : 1;
+
+	// Perform a breadth-first scan of the filesystem.
+	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
+		Common::Array<ScanEntry> batch;
+		while (!_scanStack.empty() && batch.size() < batchSize) {
+			batch.push_back(ScanEntry());
+			batch.back().dir = _scanStack.pop();
 		}
 
-		_dirsScanned++;
+		Common::runParallelJobs(batch.size(), listDirectoryJob, &batch);
 
-#if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
-		g_system->getTaskbarManager()->setCount(_games.size());
-#endif
+		for (uint i = 0; i < batch.size(); i++) {
+			if (batch[i].listed)
+				scanDirectory(batch[i].dir, batch[i].files);
+		}
 	}
 
 
@@ -277,6 +316,8 @@ void MassAddDialog::handleTickle() {
 	Common::U32String buf;
 
 	if (_scanStack.empty()) {
+		ADCacheMan.setPersistentCacheSaveDeferred(false);
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
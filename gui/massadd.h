@@ -37,6 +37,7 @@ class MassAddListWidget;
 class MassAddDialog : public Dialog {
 public:
 	MassAddDialog(const Common::FSNode &startDir);
+	~MassAddDialog() override;
 
 	//void open();
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
@@ -54,6 +55,9 @@ private:
 
 	void updateGameList();
 
+	/** Run the detector on @p dir and queue its subdirectories for scanning. */
+	void scanDirectory(const Common::FSNode &dir, const Common::FSList &files);
+
 	/**
 	 * Map each path occurring in the config file to the target(s) using that path.
 	 * Used to detect whether a potential new target is already present in the
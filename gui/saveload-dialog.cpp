@@ -36,13 +36,276 @@
 #include "gui/widgets/edittext.h"
 
 #include "graphics/scaler.h"
+#include "graphics/thumbnail.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/memstream.h"
 #include "common/savefile.h"
+#include "common/system.h"
 #include "engines/engine.h"
 
+namespace Common {
+DECLARE_SINGLETON(GUI::SaveMetaInfoCache);
+}
+
 namespace GUI {
 
 #define SCALEVALUE(val) ((val) * g_gui.getScaleFactor())
 
+#define SAVE_META_CACHE_VERSION 2
+
+SaveMetaInfoCache::~SaveMetaInfoCache() {
+	saveCacheFile();
+}
+
+void SaveMetaInfoCache::setTarget(const Common::String &target) {
+	if (target != _target) {
+		saveCacheFile();
+		_entries.clear();
+		_target = target;
+		loadCacheFile();
+		return;
+	}
+
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (!i->_value.hasStats)
+			_entries.erase(i);
+	}
+}
+
+bool SaveMetaInfoCache::lookup(const MetaEngine *metaEngine, int slot, SaveStateDescriptor &desc) {
+	EntryMap::iterator i = _entries.find(slot);
+	if (i == _entries.end())
+		return false;
+
+	if (i->_value.hasStats) {
+		int64 size, mtime;
+		if (!getStats(metaEngine, slot, size, mtime) || size != i->_value.size || mtime != i->_value.mtime)
+			return false;
+	}
+
+	if (i->_value.thumbnailSize)
+		loadThumbnail(i->_value);
+
+	desc = i->_value.desc;
+	return true;
+}
+
+void SaveMetaInfoCache::store(const MetaEngine *metaEngine, int slot, const SaveStateDescriptor &desc) {
+	Entry &entry = _entries[slot];
+	entry.desc = desc;
+	entry.hasStats = getStats(metaEngine, slot, entry.size, entry.mtime);
+	entry.thumbnailSize = 0;
+	_dirty |= entry.hasStats;
+}
+
+void SaveMetaInfoCache::remove(int slot) {
+	EntryMap::iterator i = _entries.find(slot);
+	if (i == _entries.end())
+		return;
+
+	_dirty |= i->_value.hasStats;
+	_entries.erase(i);
+}
+
+bool SaveMetaInfoCache::getStats(const MetaEngine *metaEngine, int slot, int64 &size, int64 &mtime) const {
+	const Common::String filename = metaEngine->getSavegameFile(slot, _target.c_str());
+	return g_system->getSavefileManager()->getSavefileStats(filename, size, mtime);
+}
+
+void SaveMetaInfoCache::loadThumbnail(Entry &entry) const {
+	const uint32 offset = entry.thumbnailOffset;
+	entry.thumbnailSize = 0;
+
+	Common::FSNode node(getCacheFilePath());
+	Common::ScopedPtr<Common::SeekableReadStream> in(node.createReadStream());
+	if (!in || !in->seek(offset))
+		return;
+
+	Graphics::Surface *thumbnail = nullptr;
+	if (Graphics::loadThumbnail(*in, thumbnail))
+		entry.desc.setThumbnail(thumbnail);
+}
+
+Common::Path SaveMetaInfoCache::getCacheFilePath() const {
+	if (_target.empty())
+		return Common::Path();
+
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+	if (configFile.empty())
+		return Common::Path();
+
+	return configFile.getParent().appendComponent("savemeta").appendComponent(_target + ".cache");
+}
+
+void SaveMetaInfoCache::loadCacheFile() {
+	_dirty = false;
+
+	Common::Path path = getCacheFilePath();
+	if (path.empty())
+		return;
+
+	Common::FSNode node(path);
+	if (!node.exists())
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> in(node.createReadStream());
+	if (!in || in->readUint32BE() != MKTAG('S', 'M', 'E', 'T') || in->readUint32LE() != SAVE_META_CACHE_VERSION)
+		return;
+
+	// Each entry is: <slot> <save size> <save mtime> <description> <flags>
+	// <date> <time> <play time> <thumbnail size> <thumbnail>. Thumbnails are
+	// skipped here and decoded when their slot is looked up.
+	const uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count && !in->eos() && !in->err(); i++) {
+		const int slot = in->readSint32LE();
+
+		Entry entry;
+		entry.hasStats = true;
+		entry.size = in->readSint64LE();
+		entry.mtime = in->readSint64LE();
+
+		SaveStateDescriptor &desc = entry.desc;
+		desc.setSaveSlot(slot);
+		desc.setDescription(in->readString().decode());
+
+		const byte flags = in->readByte();
+		desc.setDeletableFlag(flags & 1);
+		desc.setWriteProtectedFlag(flags & 2);
+		if (flags & 8)
+			desc.setAutosave(true);
+
+		int year, month, day, hour, minutes;
+		const Common::String date = in->readString();
+		if (sscanf(date.c_str(), "%d-%d-%d", &year, &month, &day) == 3)
+			desc.setSaveDate(year, month, day);
+		const Common::String time = in->readString();
+		if (sscanf(time.c_str(), "%d:%d", &hour, &minutes) == 2)
+			desc.setSaveTime(hour, minutes);
+
+		const uint32 playTime = in->readUint32LE();
+		if (flags & 16)
+			desc.setPlayTime(playTime);
+
+		entry.thumbnailSize = in->readUint32LE();
+		entry.thumbnailOffset = in->pos();
+		if (!in->skip(entry.thumbnailSize))
+			break;
+
+		if (in->eos() || in->err())
+			break;
+
+		_entries[slot] = entry;
+	}
+}
+
+void SaveMetaInfoCache::saveCacheFile() {
+	if (!_dirty)
+		return;
+
+	_dirty = false;
+
+	Common::Path path = getCacheFilePath();
+	if (path.empty())
+		return;
+
+	Common::FSNode directory(path.getParent());
+	if (!directory.exists() && !directory.createDirectory())
+		return;
+
+	Common::Array<Entry *> entries;
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		// Only entries which can be validated are kept. Locked saves are
+		// being synced, and thumbnails can only be written with 16 or 32
+		// bits per pixel.
+		const SaveStateDescriptor &desc = i->_value.desc;
+		const Graphics::Surface *thumbnail = desc.getThumbnail();
+		if (i->_value.hasStats && !desc.getLocked() &&
+			(!thumbnail || thumbnail->format.bytesPerPixel == 2 || thumbnail->format.bytesPerPixel == 4))
+			entries.push_back(&i->_value);
+	}
+
+	// Thumbnails which were never decoded are copied from the old file, so
+	// the new one is put together in memory before overwriting it
+	Common::ScopedPtr<Common::SeekableReadStream> oldFile;
+	Common::FSNode node(path);
+	if (node.exists())
+		oldFile.reset(node.createReadStream());
+
+	Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+	Common::Array<uint32> thumbnailOffsets;
+
+	out.writeUint32BE(MKTAG('S', 'M', 'E', 'T'));
+	out.writeUint32LE(SAVE_META_CACHE_VERSION);
+	out.writeUint32LE(entries.size());
+
+	for (uint i = 0; i < entries.size(); i++) {
+		Entry &entry = *entries[i];
+		const SaveStateDescriptor &desc = entry.desc;
+
+		Common::MemoryWriteStreamDynamic thumbnail(DisposeAfterUse::YES);
+		if (desc.getThumbnail()) {
+			Graphics::saveThumbnail(thumbnail, *desc.getThumbnail());
+		} else if (entry.thumbnailSize && oldFile && oldFile->seek(entry.thumbnailOffset)) {
+			byte *data = new byte[entry.thumbnailSize];
+			if (oldFile->read(data, entry.thumbnailSize) == entry.thumbnailSize)
+				thumbnail.write(data, entry.thumbnailSize);
+			delete[] data;
+		}
+		if (!thumbnail.size())
+			entry.thumbnailSize = 0;
+
+		out.writeSint32LE(desc.getSaveSlot());
+		out.writeSint64LE(entry.size);
+		out.writeSint64LE(entry.mtime);
+		out.writeString(desc.getDescription().encode());
+		out.writeByte(0);
+
+		byte flags = 0;
+		if (desc.getDeletableFlag())
+			flags |= 1;
+		if (desc.getWriteProtectedFlag())
+			flags |= 2;
+		if (desc.isAutosave())
+			flags |= 8;
+		if (!desc.getPlayTime().empty())
+			flags |= 16;
+		if (thumbnail.size())
+			flags |= 32;
+		out.writeByte(flags);
+
+		out.writeString(desc.getSaveDate());
+		out.writeByte(0);
+		out.writeString(desc.getSaveTime());
+		out.writeByte(0);
+		out.writeUint32LE(desc.getPlayTimeMSecs());
+
+		out.writeUint32LE(thumbnail.size());
+		thumbnailOffsets.push_back(out.pos());
+		out.write(thumbnail.getData(), thumbnail.size());
+	}
+
+	oldFile.reset();
+
+	Common::DumpFile file;
+	if (!file.open(node)) {
+		warning("SaveMetaInfoCache: Unable to write '%s'", path.toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	file.write(out.getData(), out.size());
+	file.finalize();
+	file.close();
+
+	// Undecoded thumbnails moved within the file
+	for (uint i = 0; i < entries.size(); i++) {
+		if (entries[i]->thumbnailSize)
+			entries[i]->thumbnailOffset = thumbnailOffsets[i];
+	}
+}
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 
 enum {
@@ -229,6 +492,8 @@ int SaveLoadChooserDialog::run(const Common::String &target, const MetaEngine *m
 	_saveDateSupport = _metaInfoSupport && _metaEngine->hasFeature(MetaEngine::kSavesSupportCreationDate);
 	_playTimeSupport = _metaInfoSupport && _metaEngine->hasFeature(MetaEngine::kSavesSupportPlayTime);
 
+	SaveMetaInfoCache::instance().setTarget(_target);
+
 	return runIntern();
 }
 
@@ -359,13 +624,43 @@ void SaveLoadChooserDialog::listSaves() {
 void SaveLoadChooserDialog::activate(int slot, const Common::U32String &description) {
 	if (!_saveList.empty() && slot < int(_saveList.size())) {
 		const SaveStateDescriptor &desc = _saveList[slot];
-		if (_saveMode)
+		if (_saveMode) {
 			_resultString = description.empty() ? desc.getDescription() : description;
+			// The save is about to be overwritten
+			SaveMetaInfoCache::instance().remove(desc.getSaveSlot());
+		}
 		setResult(desc.getSaveSlot());
 	}
 	close();
 }
 
+bool SaveLoadChooserDialog::getCachedMetaInfo(uint index, SaveStateDescriptor &desc) {
+	if (_saveList[index].getLocked()) {
+		desc = _saveList[index];
+		return true;
+	}
+
+	if (!SaveMetaInfoCache::instance().lookup(_metaEngine, _saveList[index].getSaveSlot(), desc))
+		return false;
+
+	if (desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
+		_saveList[index] = desc;
+	return true;
+}
+
+SaveStateDescriptor SaveLoadChooserDialog::queryMetaInfo(uint index) {
+	if (_saveList[index].getLocked())
+		return _saveList[index];
+
+	const int slot = _saveList[index].getSaveSlot();
+	SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), slot);
+	SaveMetaInfoCache::instance().store(_metaEngine, slot, desc);
+
+	if (desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
+		_saveList[index] = desc;
+	return desc;
+}
+
 #ifndef DISABLE_SAVELOADCHOOSER_GRID
 void SaveLoadChooserDialog::addChooserButtons() {
 	if (_listButton) {
@@ -540,6 +835,7 @@ void SaveLoadChooserSimple::handleCommand(CommandSender *sender, uint32 cmd, uin
 								_("Delete"), _("Cancel"));
 			if (alert.runModal() == kMessageOK) {
 				_metaEngine->removeSaveState(_target.c_str(), _saveList[selItem].getSaveSlot());
+				SaveMetaInfoCache::instance().remove(_saveList[selItem].getSaveSlot());
 
 				setResult(-1);
 				int scrollPos = _list->getCurrentScrollPos();
@@ -643,9 +939,9 @@ void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	_playtime->setLabel(_("No playtime saved"));
 
 	if (selItem >= 0 && _metaInfoSupport) {
-		SaveStateDescriptor desc = (_saveList[selItem].getLocked() ? _saveList[selItem] : _metaEngine->querySaveMetaInfos(_target.c_str(), _saveList[selItem].getSaveSlot()));
-		if (!_saveList[selItem].getLocked() && desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
-			_saveList[selItem] = desc;
+		SaveStateDescriptor desc;
+		if (!getCachedMetaInfo(selItem, desc))
+			desc = queryMetaInfo(selItem);
 
 		isDeletable = _saveList[selItem].getDeletableFlag() && _delSupport;
 		isWriteProtected = desc.getWriteProtectedFlag() ||
@@ -809,6 +1105,12 @@ enum {
 	kNewSaveCmd = 'SAVE'
 };
 
+enum {
+	// Upper bound (in milliseconds) we want to spend loading meta infos
+	// of saves in handleTickle.
+	kMaxMetaInfoLoadTime = 30
+};
+
 SaveLoadChooserGrid::SaveLoadChooserGrid(const Common::U32String &title, bool saveMode)
 	: SaveLoadChooserDialog("SaveLoadChooser", saveMode), _lines(0), _columns(0), _entriesPerPage(0),
 	_curPage(0), _newSaveContainer(nullptr), _nextFreeSaveSlot(0), _buttons() {
@@ -865,6 +1167,7 @@ void SaveLoadChooserGrid::handleCommand(CommandSender *sender, uint32 cmd, uint3
 		break;
 
 	case kNewSaveCmd:
+		SaveMetaInfoCache::instance().remove(_nextFreeSaveSlot);
 		setResult(_nextFreeSaveSlot);
 		close();
 		break;
@@ -1079,6 +1382,24 @@ void SaveLoadChooserGrid::close() {
 
 	SaveLoadChooserDialog::close();
 	hideButtons();
+	_pendingSaves.clear();
+}
+
+void SaveLoadChooserGrid::handleTickle() {
+	// Load the meta infos of the saves shown on the current page a few at a
+	// time, so that the dialog stays responsive when there are many saves
+	// or the storage is slow.
+	if (!_pendingSaves.empty()) {
+		const uint32 start = g_system->getMillis();
+		do {
+			const uint index = _pendingSaves.remove_at(0);
+			updateSaveButton(index - _curPage * _entriesPerPage, index, queryMetaInfo(index), true);
+		} while (!_pendingSaves.empty() && g_system->getMillis() - start < kMaxMetaInfoLoadTime);
+
+		g_gui.scheduleTopDialogRedraw();
+	}
+
+	SaveLoadChooserDialog::handleTickle();
 }
 
 int SaveLoadChooserGrid::runIntern() {
@@ -1140,63 +1461,18 @@ void SaveLoadChooserGrid::hideButtons() {
 
 void SaveLoadChooserGrid::updateSaves() {
 	hideButtons();
-
-	bool isWriteProtected = false;
+	_pendingSaves.clear();
 
 	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
-		const uint saveSlot = _saveList[i].getSaveSlot();
-
-		SaveStateDescriptor desc =  (_saveList[i].getLocked() ? _saveList[i] : _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot));
-		if (!_saveList[i].getLocked() && desc.getSaveSlot() >= 0 && !desc.getDescription().empty())
-			_saveList[i] = desc;
-		SlotButton &curButton = _buttons[curNum];
-		curButton.setVisible(true);
-		const Graphics::Surface *thumbnail = desc.getThumbnail();
-		if (thumbnail) {
-			curButton.button->setGfx(desc.getThumbnail());
-		} else {
-			curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
-		}
-		curButton.description->setLabel(Common::U32String(Common::String::format("%d. ", saveSlot)) + _saveList[i].getDescription());
-
-		Common::U32String tooltip(_("Name: "));
-		tooltip += _saveList[i].getDescription();
-
-		if (_saveDateSupport) {
-			const Common::U32String &saveDate = desc.getSaveDate();
-			if (!saveDate.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip +=  _("Date: ") + saveDate;
-			}
-
-			const Common::U32String &saveTime = desc.getSaveTime();
-			if (!saveTime.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip += _("Time: ") + saveTime;
-			}
-		}
-
-		if (_playTimeSupport) {
-			const Common::U32String &playTime = desc.getPlayTime();
-			if (!playTime.empty()) {
-				tooltip += Common::U32String("\n");
-				tooltip += _("Playtime: ") + playTime;
-			}
-		}
-
-		curButton.button->setTooltip(tooltip);
-
-		// In save mode we disable the button, when it's write protected.
-		// TODO: Maybe we should not display it at all then?
-		// We also disable and description the button if slot is locked
-		isWriteProtected = desc.getWriteProtectedFlag() ||
-			_saveList[i].getWriteProtectedFlag();
-		if ((_saveMode && isWriteProtected) || desc.getLocked()) {
-			curButton.button->setEnabled(false);
+		SaveStateDescriptor desc;
+		if (getCachedMetaInfo(i, desc)) {
+			updateSaveButton(curNum, i, desc, true);
 		} else {
-			curButton.button->setEnabled(true);
+			// Show the save list entry until handleTickle() loads the
+			// meta info
+			updateSaveButton(curNum, i, _saveList[i], false);
+			_pendingSaves.push_back(i);
 		}
-		curButton.description->setEnabled(!desc.getLocked());
 	}
 
 	const uint numPages = (_entriesPerPage != 0 && !_saveList.empty()) ? ((_saveList.size() + _entriesPerPage - 1) / _entriesPerPage) : 1;
@@ -1213,6 +1489,59 @@ void SaveLoadChooserGrid::updateSaves() {
 		_nextButton->setEnabled(false);
 }
 
+void SaveLoadChooserGrid::updateSaveButton(uint button, uint index, const SaveStateDescriptor &desc, bool loaded) {
+	const uint saveSlot = _saveList[index].getSaveSlot();
+	SlotButton &curButton = _buttons[button];
+	curButton.setVisible(true);
+	const Graphics::Surface *thumbnail = desc.getThumbnail();
+	if (thumbnail) {
+		curButton.button->setGfx(desc.getThumbnail());
+	} else {
+		curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+	}
+	curButton.description->setLabel(Common::U32String(Common::String::format("%d. ", saveSlot)) + _saveList[index].getDescription());
+
+	Common::U32String tooltip(_("Name: "));
+	tooltip += _saveList[index].getDescription();
+
+	if (_saveDateSupport) {
+		const Common::U32String &saveDate = desc.getSaveDate();
+		if (!saveDate.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip +=  _("Date: ") + saveDate;
+		}
+
+		const Common::U32String &saveTime = desc.getSaveTime();
+		if (!saveTime.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip += _("Time: ") + saveTime;
+		}
+	}
+
+	if (_playTimeSupport) {
+		const Common::U32String &playTime = desc.getPlayTime();
+		if (!playTime.empty()) {
+			tooltip += Common::U32String("\n");
+			tooltip += _("Playtime: ") + playTime;
+		}
+	}
+
+	curButton.button->setTooltip(tooltip);
+
+	// In save mode we disable the button, when it's write protected, or
+	// until we know whether it is.
+	// TODO: Maybe we should not display it at all then?
+	// We also disable and description the button if slot is locked
+	const bool isWriteProtected = !loaded || desc.getWriteProtectedFlag() ||
+		_saveList[index].getWriteProtectedFlag();
+	if ((_saveMode && isWriteProtected) || desc.getLocked()) {
+		curButton.button->setEnabled(false);
+	} else {
+		curButton.button->setEnabled(true);
+	}
+	curButton.description->setEnabled(!desc.getLocked());
+}
+
 SavenameDialog::SavenameDialog()
 	: Dialog("SavenameDialog") {
 	_title = new StaticTextWidget(this, "SavenameDialog.DescriptionText", Common::String());
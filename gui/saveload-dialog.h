@@ -25,10 +25,81 @@
 #include "gui/dialog.h"
 #include "gui/widgets/list.h"
 
+#include "common/hashmap.h"
+#include "common/singleton.h"
+
 #include "engines/metaengine.h"
 
 namespace GUI {
 
+/**
+ * Meta infos of the saves of the last game shown in a save/load chooser.
+ *
+ * The cache is kept between choosers, so that the save files do not have to
+ * be opened and decoded again every time one is shown. Entries are only used
+ * while the size and modification time of their save file are unchanged.
+ * When the savefile manager cannot provide these, entries are only used
+ * until the next chooser is run.
+ *
+ * Entries with a known size and modification time are also written to a
+ * cache file per target, in the "savemeta" directory next to the
+ * configuration file, so that they are kept across restarts.
+ */
+class SaveMetaInfoCache : public Common::Singleton<SaveMetaInfoCache> {
+public:
+	/**
+	 * Start using the cache for the saves of @p target. This drops the
+	 * entries of any other target, and those that cannot be validated.
+	 */
+	void setTarget(const Common::String &target);
+
+	/**
+	 * Look up the meta info of @p slot. Thumbnails are only decoded from
+	 * the cache file when they are looked up for the first time.
+	 *
+	 * @return True if a valid entry was found and copied to @p desc.
+	 */
+	bool lookup(const MetaEngine *metaEngine, int slot, SaveStateDescriptor &desc);
+
+	/** Store the meta info of @p slot. */
+	void store(const MetaEngine *metaEngine, int slot, const SaveStateDescriptor &desc);
+
+	/** Drop the entry of @p slot, e.g. because the save is overwritten. */
+	void remove(int slot);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	SaveMetaInfoCache() : _dirty(false) {}
+	~SaveMetaInfoCache() override;
+
+	struct Entry {
+		SaveStateDescriptor desc;
+		bool hasStats;
+		int64 size;
+		int64 mtime;
+		uint32 thumbnailOffset; ///< Position of the thumbnail in the cache file, if not decoded yet
+		uint32 thumbnailSize;   ///< Size of the thumbnail in the cache file, 0 once decoded
+
+		Entry() : hasStats(false), size(0), mtime(0), thumbnailOffset(0), thumbnailSize(0) {}
+	};
+	typedef Common::HashMap<int, Entry> EntryMap;
+
+	bool getStats(const MetaEngine *metaEngine, int slot, int64 &size, int64 &mtime) const;
+	/** Decode the thumbnail of @p entry from the cache file. */
+	void loadThumbnail(Entry &entry) const;
+
+	/** Return the path of the cache file of the current target, or an empty path. */
+	Common::Path getCacheFilePath() const;
+	/** Load the entries of the current target from its cache file. */
+	void loadCacheFile();
+	/** Write the entries of the current target to its cache file, if they changed. */
+	void saveCacheFile();
+
+	Common::String _target;
+	EntryMap _entries;
+	bool _dirty; ///< Do the entries differ from the cache file?
+};
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 class SaveLoadChooserDialog;
 
@@ -114,6 +185,20 @@ protected:
 
 	void activate(int slot, const Common::U32String &description);
 
+	/**
+	 * Get the meta info of the save at @p index in the save list, if it is
+	 * locked or in the meta info cache.
+	 *
+	 * @return True if the meta info was copied to @p desc.
+	 */
+	bool getCachedMetaInfo(uint index, SaveStateDescriptor &desc);
+
+	/**
+	 * Query the meta info of the save at @p index in the save list from the
+	 * MetaEngine, and add it to the meta info cache.
+	 */
+	SaveStateDescriptor queryMetaInfo(uint index);
+
 	const bool					_saveMode;
 	const MetaEngine		    *_metaEngine;
 	bool						_delSupport;
@@ -216,6 +301,8 @@ public:
 	SaveLoadChooserType getType() const override { return kSaveLoadDialogGrid; }
 
 	void close() override;
+
+	void handleTickle() override;
 protected:
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
 	void handleMouseWheel(int x, int y, int direction) override;
@@ -256,6 +343,16 @@ private:
 	void destroyButtons();
 	void hideButtons();
 	void updateSaves();
+
+	/**
+	 * Show the save at @p index in the save list on button @p button. When
+	 * @p loaded is false, @p desc is the save list entry, and the button
+	 * is updated again once the meta info has been loaded.
+	 */
+	void updateSaveButton(uint button, uint index, const SaveStateDescriptor &desc, bool loaded);
+
+	/** Saves on the current page whose meta info still has to be loaded. */
+	Common::Array<uint> _pendingSaves;
 };
 
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
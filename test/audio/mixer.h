@@ -0,0 +1,113 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/audiostream.h"
+#include "audio/decoders/raw.h"
+#include "common/memstream.h"
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+	static Audio::AudioStream *makeConstantStream(int16 value, int numSamples) {
+		int16 *data = (int16 *)malloc(numSamples * sizeof(int16));
+		for (int i = 0; i < numSamples; i++)
+			data[i] = value;
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, numSamples * sizeof(int16), DisposeAfterUse::YES);
+#ifdef SCUMM_LITTLE_ENDIAN
+		return Audio::makeRawStream(stream, 11025, Audio::FLAG_16BITS | Audio::FLAG_STEREO | Audio::FLAG_LITTLE_ENDIAN);
+#else
+		return Audio::makeRawStream(stream, 11025, Audio::FLAG_16BITS | Audio::FLAG_STEREO);
+#endif
+	}
+
+public:
+	void test_channel_commands() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixerImpl(11025);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, makeConstantStream(1000, 4096), 42);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 42);
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kPlainSoundType));
+
+		// Queries see the changes before the audio callback applies them
+		mixer.setChannelVolume(handle, 51);
+		mixer.setChannelBalance(handle, -127);
+		mixer.setChannelRate(handle, 22050);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 51);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), -127);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 22050u);
+		mixer.resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 11025u);
+
+		int16 samples[64];
+		mixerImpl.mixCallback((byte *)samples, sizeof(samples));
+
+		// Full left, 51/255 of the volume
+		TS_ASSERT_EQUALS(samples[0], 1000 * (256 * 51 / 255) / 256);
+		TS_ASSERT_EQUALS(samples[1], 0);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+#endif
+	}
+
+	void test_command_queue_overflow() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixerImpl(11025);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, makeConstantStream(1000, 4096));
+
+		// Many more commands than the queue holds, without any callback
+		for (int i = 0; i < 1000; i++)
+			mixer.setChannelVolume(handle, i & 0xff);
+		mixer.setChannelVolume(handle, 255);
+
+		int16 samples[64];
+		mixerImpl.mixCallback((byte *)samples, sizeof(samples));
+
+		// The last change wins
+		TS_ASSERT_EQUALS(samples[0], 1000);
+		TS_ASSERT_EQUALS(samples[1], 1000);
+#endif
+	}
+
+	void test_pause_only_existing_sounds() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::MixerImpl mixerImpl(11025);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		Audio::SoundHandle oldHandle, newHandle;
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &oldHandle, makeConstantStream(1000, 4096), 7);
+		mixer.pauseAll(true);
+		mixer.pauseID(7, true);
+		mixer.stopHandle(oldHandle);
+
+		// Started after the pauses, before the next callback
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &newHandle, makeConstantStream(1000, 4096), 7);
+
+		int16 samples[64];
+		mixerImpl.mixCallback((byte *)samples, sizeof(samples));
+
+		TS_ASSERT_EQUALS(samples[0], 1000);
+		TS_ASSERT_EQUALS(samples[1], 1000);
+#endif
+	}
+};
@@ -0,0 +1,206 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/rate_mix.h"
+
+#include "common/memstream.h"
+
+#include "helper.h"
+
+class RateTestSuite : public CxxTest::TestSuite
+{
+	// Cover every alignment and the scalar tail of the kernels
+	static const uint kNumFrames = 67;
+
+	static void fillBuffers(Audio::st_sample_t *in, Audio::st_sample_t *out, uint32 seed) {
+		for (uint i = 0; i < kNumFrames * 2; i++) {
+			seed = seed * 1103515245 + 12345;
+			in[i] = (Audio::st_sample_t)(seed >> 16);
+			seed = seed * 1103515245 + 12345;
+			out[i] = (Audio::st_sample_t)(seed >> 16);
+		}
+
+		// Make sure the extremes are always covered
+		in[0] = -32768;
+		in[1] = 32767;
+		out[2] = 32767;
+		out[3] = -32768;
+	}
+
+	static void checkKernel(Audio::RateMix::MixFunc mixFunc) {
+		const Audio::st_volume_t volumes[] = { 0, 1, 127, 128, 200, 255, 256, 300 };
+
+		for (uint l = 0; l < ARRAYSIZE(volumes); l++) {
+			for (uint r = 0; r < ARRAYSIZE(volumes); r++) {
+				for (uint offset = 0; offset < 8; offset++) {
+					Audio::st_sample_t in[kNumFrames * 2], expected[kNumFrames * 2], out[kNumFrames * 2];
+					fillBuffers(in, expected, l * 1000 + r * 10 + offset);
+					memcpy(out, expected, sizeof(out));
+
+					const uint numFrames = kNumFrames - offset;
+					Audio::RateMix::mixGeneric(expected + offset * 2, in + offset * 2, numFrames, volumes[l], volumes[r]);
+					mixFunc(out + offset * 2, in + offset * 2, numFrames, volumes[l], volumes[r]);
+
+					TS_ASSERT_SAME_DATA(out, expected, sizeof(out));
+				}
+			}
+		}
+	}
+
+	static void checkFilterKernel(Audio::RateMix::FilterFunc filterFunc) {
+		Audio::st_sample_t inL[kNumFrames * 2], inR[kNumFrames * 2], coefs[kNumFrames * 2];
+
+		for (uint32 seed = 0; seed < 64; seed++) {
+			Audio::st_sample_t dummy[kNumFrames * 2];
+			fillBuffers(dummy, inL, seed);
+			fillBuffers(dummy, inR, seed + 1000);
+			fillBuffers(dummy, coefs, seed + 2000);
+
+			// Keep the coefficients in the range of real filters
+			for (uint i = 0; i < Audio::RateMix::kSincTaps; i++)
+				coefs[i] /= 16;
+
+			int expectedL, expectedR, outL, outR;
+			Audio::RateMix::filterGeneric(inL, inR, coefs, expectedL, expectedR);
+			filterFunc(inL, inR, coefs, outL, outR);
+
+			TS_ASSERT_EQUALS(outL, expectedL);
+			TS_ASSERT_EQUALS(outR, expectedR);
+		}
+	}
+
+public:
+	void test_mix_generic() {
+		Audio::st_sample_t in[4] = { 1000, -1000, -32768, 32767 };
+		Audio::st_sample_t out[4] = { 0, 0, -32000, 32000 };
+
+		Audio::RateMix::mixGeneric(out, in, 2, 128, 255);
+
+		TS_ASSERT_EQUALS(out[0], 500);
+		// Division rounds towards zero
+		TS_ASSERT_EQUALS(out[1], -996);
+		TS_ASSERT_EQUALS(out[2], -32768);
+		TS_ASSERT_EQUALS(out[3], 32767);
+	}
+
+	// cxxtestgen does not preprocess, so the test functions have to exist
+	// even when the kernels are not built
+	void test_mix_neon() {
+#ifdef SCUMMVM_NEON
+		checkKernel(Audio::RateMix::mixNEON);
+#endif
+	}
+
+	void test_filter_neon() {
+#ifdef SCUMMVM_NEON
+		checkFilterKernel(Audio::RateMix::filterNEON);
+#endif
+	}
+
+	void test_mix_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernel(Audio::RateMix::mixSSE2);
+#endif
+	}
+
+	void test_filter_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkFilterKernel(Audio::RateMix::filterSSE2);
+#endif
+	}
+
+	void test_mix_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernel(Audio::RateMix::mixAVX2);
+#endif
+	}
+
+	void test_convert_reverse_stereo() {
+		const int time = 1;
+		int16 *sine = nullptr;
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(11025, time, &sine, false, true);
+
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 11025, true, true, true);
+		const int numFrames = 11025 * time;
+		Audio::st_sample_t *out = new Audio::st_sample_t[numFrames * 2];
+		memset(out, 0, numFrames * 2 * sizeof(Audio::st_sample_t));
+
+		TS_ASSERT_EQUALS(converter->convert(*stream, out, numFrames, 256, 128), numFrames);
+
+		for (int i = 0; i < numFrames; i++) {
+			TS_ASSERT_EQUALS(out[i * 2 + 1], sine[i * 2]);
+			TS_ASSERT_EQUALS(out[i * 2], (Audio::st_sample_t)((sine[i * 2 + 1] * 128) / 256));
+		}
+
+		delete[] out;
+		delete converter;
+		delete stream;
+		delete[] sine;
+	}
+
+	void test_convert_sinc() {
+		const int time = 1;
+		int16 *sine = nullptr;
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(11025, time, &sine, false, false);
+
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 44100, false, true, false, Audio::kResamplerSinc);
+		const int numFrames = 44100 * time - 64;
+		Audio::st_sample_t *out = new Audio::st_sample_t[numFrames * 2];
+		memset(out, 0, numFrames * 2 * sizeof(Audio::st_sample_t));
+
+		TS_ASSERT_EQUALS(converter->convert(*stream, out, numFrames, 256, 256), numFrames);
+
+		// The filter delays the output by half its length
+		const int delay = Audio::RateMix::kSincTaps / 2 * 4;
+		for (int i = delay; i < numFrames; i++) {
+			const double expected = sin((double)(i - delay) / 44100 * 2 * M_PI) * 32767;
+			TS_ASSERT_DELTA(out[i * 2], expected, 64);
+			TS_ASSERT_EQUALS(out[i * 2], out[i * 2 + 1]);
+		}
+
+		delete[] out;
+		delete converter;
+		delete stream;
+		delete[] sine;
+	}
+
+	void test_convert_sinc_attenuates_above_nyquist() {
+		// A 19 kHz tone does not exist at 22050 Hz, where it would alias to
+		// 3050 Hz. Without filtering, it keeps its full amplitude.
+		const int numFrames = 44100;
+		const int amplitude = 16384;
+		byte *tone = (byte *)malloc(numFrames * 2);
+		for (int i = 0; i < numFrames; i++)
+			WRITE_LE_UINT16(tone + i * 2, (int16)(sin((double)i / 44100 * 19000 * 2 * M_PI) * amplitude));
+
+		Audio::SeekableAudioStream *stream = Audio::makeRawStream(tone, numFrames * 2, 44100,
+			Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, DisposeAfterUse::YES);
+
+		Audio::RateConverter *converter = Audio::makeRateConverter(44100, 22050, false, true, false, Audio::kResamplerSinc);
+		const int outFrames = 22050 - 64;
+		Audio::st_sample_t *out = new Audio::st_sample_t[outFrames * 2];
+		memset(out, 0, outFrames * 2 * sizeof(Audio::st_sample_t));
+
+		TS_ASSERT_EQUALS(converter->convert(*stream, out, outFrames, 256, 256), outFrames);
+
+		// Skip the start of the filter, then require at least 20 dB of attenuation
+		int peak = 0;
+		for (int i = Audio::RateMix::kSincTaps; i < outFrames; i++)
+			peak = MAX<int>(peak, ABS<int>(out[i * 2]));
+		TS_ASSERT_LESS_THAN(peak, amplitude / 10);
+
+		delete[] out;
+		delete converter;
+		delete stream;
+	}
+};
@@ -0,0 +1,133 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/fs/posix/posix-mmapstream.h"
+#include "common/fs.h"
+#include "common/stream.h"
+
+#include "../../null_osystem.h"
+
+class PosixMmapStreamTestSuite : public CxxTest::TestSuite {
+#ifdef HAS_MMAP
+	// Written next to the test runner, removed by "make clean-test"
+	static const char *getTestFilePath() { return "test/posix-mmapstream.tmp"; }
+
+	static Common::FSNode getTestFile() {
+		return Common::FSNode(Common::Path(getTestFilePath()));
+	}
+
+	static byte getTestByte(uint32 pos) {
+		return (byte)(pos * 7 + (pos >> 8));
+	}
+
+	static bool writeTestFile(uint32 size) {
+		Common::WriteStream *file = getTestFile().createWriteStream();
+		if (!file)
+			return false;
+
+		for (uint32 i = 0; i < size; i++)
+			file->writeByte(getTestByte(i));
+		bool ok = file->flush() && !file->err();
+		delete file;
+		return ok;
+	}
+#endif
+
+public:
+	void test_read_seek() {
+#if defined(HAS_MMAP) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const uint32 size = 100 * 1024;
+		TS_ASSERT(writeTestFile(size));
+
+		PosixMmapStream *stream = PosixMmapStream::makeFromPath(getTestFilePath());
+		TS_ASSERT(stream != nullptr);
+		if (!stream)
+			return;
+
+		TS_ASSERT_EQUALS(stream->size(), (int64)size);
+		TS_ASSERT_EQUALS(stream->pos(), 0);
+		TS_ASSERT(!stream->eos());
+
+		// The whole file is accessible without reading it
+		const byte *data = stream->getMemoryData();
+		TS_ASSERT(data != nullptr);
+		bool sameData = data != nullptr;
+		for (uint32 i = 0; sameData && i < size; i++)
+			sameData = data[i] == getTestByte(i);
+		TS_ASSERT(sameData);
+
+		byte buffer[16];
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), sizeof(buffer));
+		TS_ASSERT_EQUALS(buffer[15], getTestByte(15));
+		TS_ASSERT_EQUALS(stream->pos(), 16);
+
+		TS_ASSERT(stream->seek(70000));
+		TS_ASSERT_EQUALS(stream->readByte(), getTestByte(70000));
+		TS_ASSERT(stream->seek(-2, SEEK_CUR));
+		TS_ASSERT_EQUALS(stream->readByte(), getTestByte(69999));
+
+		// Reading past the end stops at the end and sets eos
+		TS_ASSERT(stream->seek(-10, SEEK_END));
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), 10u);
+		TS_ASSERT_EQUALS(buffer[9], getTestByte(size - 1));
+		TS_ASSERT(stream->eos());
+		TS_ASSERT_EQUALS(stream->pos(), (int64)size);
+
+		// Seeking clears eos, but not outside of the file
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT(!stream->seek(size + 1));
+		TS_ASSERT(!stream->seek(-1));
+		TS_ASSERT_EQUALS(stream->pos(), 0);
+
+		delete stream;
+
+		// Small files are left to stdio
+		TS_ASSERT(writeTestFile(1000));
+		TS_ASSERT(PosixMmapStream::makeFromPath(getTestFilePath()) == nullptr);
+#endif
+	}
+
+	void test_mapping_is_opt_in() {
+#if defined(HAS_MMAP) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		TS_ASSERT(writeTestFile(64 * 1024));
+		Common::FSNode node = getTestFile();
+
+		// Files which may be written to, such as savefiles, are never mapped
+		Common::SeekableReadStream *stream = node.createReadStream();
+		TS_ASSERT(stream != nullptr && stream->getMemoryData() == nullptr);
+		delete stream;
+
+		stream = node.createMappedReadStream();
+		TS_ASSERT(stream != nullptr && stream->getMemoryData() != nullptr);
+		TS_ASSERT(stream != nullptr && stream->readByte() == getTestByte(0));
+		delete stream;
+#endif
+	}
+
+	void test_directory_mapping_is_opt_in() {
+#if defined(HAS_MMAP) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		TS_ASSERT(writeTestFile(64 * 1024));
+		Common::FSDirectory dir(getTestFile().getParent());
+		const Common::Path name(getTestFile().getName());
+
+		Common::SeekableReadStream *stream = dir.createReadStreamForMember(name);
+		TS_ASSERT(stream != nullptr && stream->getMemoryData() == nullptr);
+		delete stream;
+
+		dir.setMapFiles(true);
+		stream = dir.createReadStreamForMember(name);
+		TS_ASSERT(stream != nullptr && stream->getMemoryData() != nullptr);
+		delete stream;
+
+		stream = dir.getMember(name)->createReadStream();
+		TS_ASSERT(stream != nullptr && stream->getMemoryData() != nullptr);
+		delete stream;
+#endif
+	}
+};
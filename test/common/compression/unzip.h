@@ -0,0 +1,241 @@
+#include <cxxtest/TestSuite.h>
+#include "common/compression/unzip.h"
+#include "common/archive.h"
+#include "common/config-manager.h"
+#include "common/crc.h"
+#include "common/memstream.h"
+
+/**
+ * A test suite for the ZIP archive in common/compression/unzip.h
+ * The archives are built at runtime. Deflated members use stored
+ * deflate blocks so that no compressor is needed.
+ */
+class UnzipTestSuite : public CxxTest::TestSuite {
+	struct Member {
+		const char *name;
+		uint16 method;
+		uint32 offset;
+		uint32 crc;
+		uint32 compressedSize;
+		uint32 size;
+	};
+
+	static void fillContents(byte *contents, uint32 size, byte seed) {
+		for (uint32 i = 0; i < size; i++)
+			contents[i] = (byte)(i * seed + (i >> 8));
+	}
+
+	static void writeMember(Common::MemoryWriteStreamDynamic &zip, Member &member) {
+		byte *contents = new byte[member.size];
+		fillContents(contents, member.size, (byte)member.size);
+		Common::CRC32 crc;
+		member.crc = crc.crcFast(contents, member.size);
+		// A single stored deflate block
+		member.compressedSize = member.method == 8 ? member.size + 5 : member.size;
+		member.offset = zip.pos();
+
+		zip.writeUint32LE(0x04034b50);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(member.method);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(member.crc);
+		zip.writeUint32LE(member.compressedSize);
+		zip.writeUint32LE(member.size);
+		zip.writeUint16LE(strlen(member.name));
+		zip.writeUint16LE(0);
+		zip.write(member.name, strlen(member.name));
+		if (member.method == 8) {
+			zip.writeByte(1);
+			zip.writeUint16LE(member.size);
+			zip.writeUint16LE(~member.size);
+		}
+		zip.write(contents, member.size);
+		delete[] contents;
+	}
+
+	static void writeDirectory(Common::MemoryWriteStreamDynamic &zip, const Member *members, int count) {
+		uint32 directoryOffset = zip.pos();
+		for (int i = 0; i < count; i++) {
+			zip.writeUint32LE(0x02014b50);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(20);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(members[i].method);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(members[i].crc);
+			zip.writeUint32LE(members[i].compressedSize);
+			zip.writeUint32LE(members[i].size);
+			zip.writeUint16LE(strlen(members[i].name));
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint16LE(0);
+			zip.writeUint32LE(0);
+			zip.writeUint32LE(members[i].offset);
+			zip.write(members[i].name, strlen(members[i].name));
+		}
+		uint32 directorySize = zip.pos() - directoryOffset;
+
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(count);
+		zip.writeUint16LE(count);
+		zip.writeUint32LE(directorySize);
+		zip.writeUint32LE(directoryOffset);
+		zip.writeUint16LE(0);
+	}
+
+	/** Reports when the archive has deleted its stream. */
+	class TrackedReadStream : public Common::MemoryReadStream {
+	public:
+		TrackedReadStream(const byte *data, uint32 size, bool &deleted)
+			: Common::MemoryReadStream(data, size), _deleted(deleted) {}
+		~TrackedReadStream() override { _deleted = true; }
+
+	private:
+		bool &_deleted;
+	};
+
+	/** A stream which is not memory backed, and cannot be opened again. */
+	class UnmappedReadStream : public Common::MemoryReadStream {
+	public:
+		UnmappedReadStream(const byte *data, uint32 size) : Common::MemoryReadStream(data, size) {}
+		const byte *getMemoryData() const override { return nullptr; }
+	};
+
+	static bool checkContents(Common::SeekableReadStream *stream, uint32 size) {
+		if (!stream || stream->size() != size)
+			return false;
+
+		byte *expected = new byte[size];
+		byte *contents = new byte[size];
+		fillContents(expected, size, (byte)size);
+		bool ok = stream->read(contents, size) == size && memcmp(contents, expected, size) == 0;
+		delete[] expected;
+		delete[] contents;
+		return ok;
+	}
+
+public:
+	void test_stream_big_members() {
+		Member members[] = {
+			{ "small.bin", 0, 0, 0, 0, 100 },
+			{ "stored.bin", 0, 0, 0, 0, 3000 },
+			{ "deflated.bin", 8, 0, 0, 0, 2000 }
+		};
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::YES);
+		for (int i = 0; i < ARRAYSIZE(members); i++)
+			writeMember(zip, members[i]);
+		writeDirectory(zip, members, ARRAYSIZE(members));
+
+		ConfMan.setInt("archive_stream_threshold", 1, Common::ConfigManager::kApplicationDomain);
+		Common::Archive *archive = Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size()));
+		ConfMan.removeKey("archive_stream_threshold", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT(archive != nullptr);
+
+		Common::SeekableReadStream *small = archive->createReadStreamForMember("small.bin");
+		Common::SeekableReadStream *stored = archive->createReadStreamForMember("stored.bin");
+		Common::SeekableReadStream *deflated = archive->createReadStreamForMember("deflated.bin");
+
+		// Big stored members point right into the archive
+		const byte *storedData = zip.getData() + members[1].offset + 30 + strlen(members[1].name);
+		TS_ASSERT(stored != nullptr && stored->getMemoryData() == storedData);
+		TS_ASSERT(small != nullptr && small->getMemoryData() != zip.getData() + members[0].offset + 30 + strlen(members[0].name));
+
+		// Streamed members do not share a position
+		TS_ASSERT(checkContents(stored, members[1].size));
+		TS_ASSERT(checkContents(deflated, members[2].size));
+		TS_ASSERT(checkContents(small, members[0].size));
+
+		TS_ASSERT(deflated->seek(100));
+		TS_ASSERT(stored->seek(0));
+		TS_ASSERT_EQUALS(deflated->readByte(), (byte)(100 * (byte)members[2].size));
+		TS_ASSERT_EQUALS(stored->readByte(), 0);
+
+		delete small;
+		delete stored;
+		delete deflated;
+		delete archive;
+	}
+
+	void test_stream_outlives_archive() {
+		Member members[] = {
+			{ "stored.bin", 0, 0, 0, 0, 3000 },
+			{ "deflated.bin", 8, 0, 0, 0, 2000 }
+		};
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::YES);
+		for (int i = 0; i < ARRAYSIZE(members); i++)
+			writeMember(zip, members[i]);
+		writeDirectory(zip, members, ARRAYSIZE(members));
+
+		bool deleted = false;
+		ConfMan.setInt("archive_stream_threshold", 1, Common::ConfigManager::kApplicationDomain);
+		Common::Archive *archive = Common::makeZipArchive(new TrackedReadStream(zip.getData(), zip.size(), deleted));
+		ConfMan.removeKey("archive_stream_threshold", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT(archive != nullptr);
+
+		Common::SeekableReadStream *stored = archive->createReadStreamForMember("stored.bin");
+		Common::SeekableReadStream *deflated = archive->createReadStreamForMember("deflated.bin");
+		delete archive;
+
+		// The streamed members keep the ZIP file open
+		TS_ASSERT(!deleted);
+		TS_ASSERT(checkContents(stored, members[0].size));
+		TS_ASSERT(checkContents(deflated, members[1].size));
+
+		delete stored;
+		TS_ASSERT(!deleted);
+		delete deflated;
+		TS_ASSERT(deleted);
+	}
+
+	void test_stream_needs_own_zip_stream() {
+		Member members[] = {
+			{ "deflated.bin", 8, 0, 0, 0, 2000 }
+		};
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::YES);
+		writeMember(zip, members[0]);
+		writeDirectory(zip, members, 1);
+
+		ConfMan.setInt("archive_stream_threshold", 1, Common::ConfigManager::kApplicationDomain);
+		Common::Archive *archive = Common::makeZipArchive(new UnmappedReadStream(zip.getData(), zip.size()));
+		ConfMan.removeKey("archive_stream_threshold", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT(archive != nullptr);
+
+		// The ZIP file cannot be opened again, so the member is loaded into memory
+		Common::SeekableReadStream *deflated = archive->createReadStreamForMember("deflated.bin");
+		TS_ASSERT(deflated != nullptr && deflated->getMemoryData() != nullptr);
+		TS_ASSERT(checkContents(deflated, members[0].size));
+
+		delete deflated;
+		delete archive;
+	}
+
+	void test_stream_threshold_disabled() {
+		Member members[] = {
+			{ "deflated.bin", 8, 0, 0, 0, 2000 }
+		};
+
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::YES);
+		writeMember(zip, members[0]);
+		writeDirectory(zip, members, 1);
+
+		ConfMan.setInt("archive_stream_threshold", 0, Common::ConfigManager::kApplicationDomain);
+		Common::Archive *archive = Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size()));
+		ConfMan.removeKey("archive_stream_threshold", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT(archive != nullptr);
+
+		// Loaded into memory as a whole
+		Common::SeekableReadStream *deflated = archive->createReadStreamForMember("deflated.bin");
+		TS_ASSERT(deflated != nullptr && deflated->getMemoryData() != nullptr);
+		TS_ASSERT(checkContents(deflated, members[0].size));
+
+		delete deflated;
+		delete archive;
+	}
+};
@@ -0,0 +1,294 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+#if BENCHMARK_TIME
+template<class Map>
+static void benchmarkMap(const char *name, uint count, int iters) {
+	uint32 insertTime = 0, lookupTime = 0, iterateTime = 0, eraseTime = 0;
+	uint32 sum = 0;
+
+	for (int iter = 0; iter < iters; iter++) {
+		Map map;
+
+		uint32 start = g_system->getMillis();
+		for (uint i = 0; i < count; i++)
+			map[i * 7919] = i;
+		insertTime += g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (uint i = 0; i < count * 2; i++)
+			sum += map.getValOrDefault(i * 7919, 1);
+		lookupTime += g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+			sum += it->_value;
+		iterateTime += g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (uint i = 0; i < count; i++)
+			map.erase(i * 7919);
+		eraseTime += g_system->getMillis() - start;
+
+		TS_ASSERT(map.empty());
+	}
+
+	debug("%s: %d iters of %u elements: insert %u ms, lookup %u ms, iterate %u ms, erase %u ms (checksum %u)",
+		name, iters, count, insertTime, lookupTime, iterateTime, eraseTime, sum);
+}
+#endif
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("FOO"));
+		TS_ASSERT(container2.contains("quux"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(0);
+		container.erase(1);
+		container.erase(2);
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container.size(), 1u);
+	}
+
+	void test_lookup() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+
+		TS_ASSERT_EQUALS(container[0], 17);
+		TS_ASSERT_EQUALS(container[1], -1);
+		TS_ASSERT_EQUALS(container[2], 45);
+		TS_ASSERT_EQUALS(container.getValOrDefault(3), 0);
+		TS_ASSERT_EQUALS(container.getValOrDefault(3, 99), 99);
+
+		int out = 0;
+		TS_ASSERT(container.tryGetVal(2, out));
+		TS_ASSERT_EQUALS(out, 45);
+		TS_ASSERT(!container.tryGetVal(4, out));
+
+		TS_ASSERT(container.find(1) != container.end());
+		TS_ASSERT(container.find(5) == container.end());
+	}
+
+	void test_iterator_begin_end() {
+		Common::FlatHashMap<int, int> container;
+
+		// The container is initially empty ...
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+
+		// ... then non-empty ...
+		container[324] = 33;
+		TS_ASSERT_DIFFERS(container.begin(), container.end());
+
+		// ... and again empty.
+		container.clear(true);
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+	}
+
+	void test_erase_while_iterating() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 100; i++)
+			container[i] = i;
+
+		// Erasing does not move elements, so iteration may continue
+		for (Common::FlatHashMap<int, int>::iterator it = container.begin(); it != container.end(); ++it) {
+			if (it->_key & 1)
+				container.erase(it);
+		}
+
+		TS_ASSERT_EQUALS(container.size(), 50u);
+		for (int i = 0; i < 100; i++)
+			TS_ASSERT_EQUALS(container.contains(i), !(i & 1));
+	}
+
+	void test_hash_map_copy() {
+		// If these tests fail, the copy constructor or assignment is broken
+		Common::FlatHashMap<int, int> map1, container2;
+		map1[323] = 32;
+		container2 = map1;
+		TS_ASSERT_EQUALS(container2[323], 32);
+
+		Common::FlatHashMap<int, int> container3(map1);
+		TS_ASSERT_EQUALS(container3[323], 32);
+
+		container3[323] = 1;
+		TS_ASSERT_EQUALS(map1[323], 32);
+	}
+
+	void test_collision() {
+		// NB: The usefulness of this example depends strongly on the
+		// specific hashmap implementation.
+		// It is constructed to insert multiple colliding elements.
+		Common::FlatHashMap<int, int> h;
+		h[5] = 1;
+		h[32+5] = 1;
+		h[64+5] = 1;
+		h[128+5] = 1;
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(32+5);
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(5);
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h[32+5] = 1;
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h[5] = 1;
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(32+5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+	}
+
+	void test_strided_keys() {
+		// Keys that are multiples of a large power of two differ in their
+		// high bits only; they must still be spread over all groups
+		Common::FlatHashMap<uint32, uint32> container;
+		for (uint32 i = 0; i < 8192; i++)
+			container[i << 19] = i;
+
+		TS_ASSERT_EQUALS(container.size(), 8192u);
+		for (uint32 i = 0; i < 8192; i++) {
+			TS_ASSERT(container.contains(i << 19));
+			TS_ASSERT_EQUALS(container[i << 19], i);
+			TS_ASSERT(!container.contains((i << 19) + 1));
+		}
+
+		for (uint32 i = 0; i < 8192; i += 2)
+			container.erase(i << 19);
+		TS_ASSERT_EQUALS(container.size(), 4096u);
+		for (uint32 i = 0; i < 8192; i++)
+			TS_ASSERT_EQUALS(container.contains(i << 19), (i & 1) != 0);
+	}
+
+	void test_many_elements() {
+		// Grow well past several rehashes and churn through deleted slots
+		Common::FlatHashMap<uint, uint> container;
+		Common::HashMap<uint, uint> reference;
+
+		for (uint i = 0; i < 5000; i++) {
+			container[i * 31] = i;
+			reference[i * 31] = i;
+			if (i % 3 == 0) {
+				container.erase((i / 2) * 31);
+				reference.erase((i / 2) * 31);
+			}
+		}
+
+		TS_ASSERT_EQUALS(container.size(), reference.size());
+		for (Common::HashMap<uint, uint>::const_iterator it = reference.begin(); it != reference.end(); ++it)
+			TS_ASSERT_EQUALS(container.getValOrDefault(it->_key, 0xFFFFFFFF), it->_value);
+
+		uint count = 0;
+		for (Common::FlatHashMap<uint, uint>::const_iterator it = container.begin(); it != container.end(); ++it) {
+			TS_ASSERT(reference.contains(it->_key));
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+
+	void test_write_while_growing() {
+		// Every insertion which grows the map must still store its value
+		Common::FlatHashMap<uint, Common::String> setContainer;
+		Common::FlatHashMap<uint, Common::String> indexContainer;
+
+		for (uint i = 0; i < 1000; i++) {
+			Common::String value = Common::String::format("value %u", i);
+			setContainer.setVal(i, value);
+			indexContainer[i] = value;
+			TS_ASSERT_EQUALS(setContainer.getValOrDefault(i), value);
+			TS_ASSERT_EQUALS(indexContainer.getValOrDefault(i), value);
+		}
+
+		for (uint i = 0; i < 1000; i++) {
+			Common::String value = Common::String::format("value %u", i);
+			TS_ASSERT_EQUALS(setContainer[i], value);
+			TS_ASSERT_EQUALS(indexContainer[i], value);
+		}
+	}
+
+	void test_map_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 50;
+#else
+		const int iters = 1;
+#endif
+		benchmarkMap<Common::HashMap<uint, uint> >("HashMap", 100000, iters);
+		benchmarkMap<Common::FlatHashMap<uint, uint> >("FlatHashMap", 100000, iters);
+#endif
+	}
+};
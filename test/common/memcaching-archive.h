@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/stream.h"
+
+class CountingArchive : public Common::MemcachingCaseInsensitiveArchive {
+public:
+	CountingArchive() : Common::MemcachingCaseInsensitiveArchive(16), reads(0) {}
+
+	bool hasFile(const Common::Path &path) const override { return true; }
+	int listMembers(Common::ArchiveMemberList &list) const override { return 0; }
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override { return Common::ArchiveMemberPtr(); }
+
+	Common::SharedArchiveContents readContentsForPath(const Common::Path &translatedPath) const override {
+		reads++;
+
+		// Member "a" is 100 bytes, "b" is 200 bytes etc.
+		uint32 size = (translatedPath.toString()[0] - 'a' + 1) * 100;
+		byte *contents = new byte[size];
+		memset(contents, translatedPath.toString()[0], size);
+		return Common::SharedArchiveContents(contents, size);
+	}
+
+	mutable int reads;
+};
+
+class MemcachingArchiveTestSuite : public CxxTest::TestSuite
+{
+public:
+	void tearDown() {
+		// The budget is shared by all the archives
+		Common::MemcachingCaseInsensitiveArchive::setMaxCachedSize(0);
+	}
+
+	void test_reopen_cached() {
+		CountingArchive archive;
+		archive.setMaxCachedSize(1000);
+
+		delete archive.createReadStreamForMember("a");
+		delete archive.createReadStreamForMember("a");
+		delete archive.createReadStreamForMember("A");
+
+		TS_ASSERT_EQUALS(archive.reads, 1);
+		TS_ASSERT_EQUALS(archive.getCacheMisses(), 1u);
+		TS_ASSERT_EQUALS(archive.getCacheHits(), 2u);
+		TS_ASSERT_EQUALS(archive.getCachedSize(), 100u);
+	}
+
+	void test_lru_eviction() {
+		CountingArchive archive;
+		archive.setMaxCachedSize(600);
+
+		delete archive.createReadStreamForMember("a");
+		delete archive.createReadStreamForMember("b");
+		delete archive.createReadStreamForMember("c");
+		TS_ASSERT_EQUALS(archive.getCachedSize(), 600u);
+
+		// Touch "a", so that "b" is the least recently used member
+		delete archive.createReadStreamForMember("a");
+		delete archive.createReadStreamForMember("d");
+		TS_ASSERT_EQUALS(archive.reads, 4);
+		TS_ASSERT(archive.getCachedSize() <= 600u);
+
+		archive.resetCacheStats();
+		delete archive.createReadStreamForMember("a");
+		delete archive.createReadStreamForMember("d");
+		TS_ASSERT_EQUALS(archive.getCacheHits(), 2u);
+		delete archive.createReadStreamForMember("b");
+		TS_ASSERT_EQUALS(archive.getCacheMisses(), 1u);
+	}
+
+	void test_too_big_for_budget() {
+		CountingArchive archive;
+		archive.setMaxCachedSize(150);
+
+		delete archive.createReadStreamForMember("b");
+		TS_ASSERT_EQUALS(archive.getCachedSize(), 0u);
+		delete archive.createReadStreamForMember("b");
+		TS_ASSERT_EQUALS(archive.reads, 2);
+
+		// Members still referenced by a stream are not read again
+		Common::SeekableReadStream *stream = archive.createReadStreamForMember("b");
+		delete archive.createReadStreamForMember("b");
+		TS_ASSERT_EQUALS(archive.reads, 3);
+		TS_ASSERT_EQUALS(stream->size(), 200);
+		TS_ASSERT_EQUALS(stream->readByte(), 'b');
+		delete stream;
+	}
+
+	void test_shrink_budget() {
+		CountingArchive archive;
+		archive.setMaxCachedSize(1000);
+
+		delete archive.createReadStreamForMember("a");
+		delete archive.createReadStreamForMember("b");
+		archive.setMaxCachedSize(250);
+		TS_ASSERT_EQUALS(archive.getCachedSize(), 200u);
+
+		delete archive.createReadStreamForMember("b");
+		TS_ASSERT_EQUALS(archive.reads, 2);
+		delete archive.createReadStreamForMember("a");
+		TS_ASSERT_EQUALS(archive.reads, 3);
+	}
+
+	void test_shared_budget() {
+		Common::MemcachingCaseInsensitiveArchive::setMaxCachedSize(500);
+
+		CountingArchive archive1;
+		delete archive1.createReadStreamForMember("b");
+
+		{
+			// Members of another archive are evicted to make room
+			CountingArchive archive2;
+			delete archive2.createReadStreamForMember("c");
+			delete archive2.createReadStreamForMember("a");
+			TS_ASSERT_EQUALS(Common::MemcachingCaseInsensitiveArchive::getCachedSize(), 400u);
+
+			delete archive1.createReadStreamForMember("b");
+			TS_ASSERT_EQUALS(archive1.reads, 2);
+			delete archive2.createReadStreamForMember("c");
+			TS_ASSERT_EQUALS(archive2.reads, 3);
+			TS_ASSERT_EQUALS(Common::MemcachingCaseInsensitiveArchive::getCachedSize(), 500u);
+		}
+
+		// Destroying an archive gives its share of the budget back
+		TS_ASSERT_EQUALS(Common::MemcachingCaseInsensitiveArchive::getCachedSize(), 200u);
+	}
+};
@@ -104,4 +104,14 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_memory_data() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		// The data does not depend on the stream position
+		TS_ASSERT_EQUALS(ms.getMemoryData(), contents);
+		ms.seek(3, SEEK_SET);
+		TS_ASSERT_EQUALS(ms.getMemoryData(), contents);
+	}
 };
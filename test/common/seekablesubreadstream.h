@@ -70,4 +70,16 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_memory_data() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+		TS_ASSERT_EQUALS(ssrs.getMemoryData(), contents + 2);
+
+		// Nested substreams add up their offsets
+		Common::SeekableSubReadStream nested(&ssrs, 1, 4);
+		TS_ASSERT_EQUALS(nested.getMemoryData(), contents + 3);
+	}
 };
@@ -0,0 +1,91 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/spsc-queue.h"
+#include "common/thread.h"
+#include "../null_osystem.h"
+
+struct SPSCQueueTestData {
+	Common::SPSCQueue<uint32, 16> queue;
+	uint32 count;
+};
+
+static void spscProducerThread(void *param) {
+	SPSCQueueTestData *data = (SPSCQueueTestData *)param;
+
+	for (uint32 i = 0; i < data->count; i++) {
+		while (!data->queue.push(i))
+			;
+	}
+}
+
+static void spscNoopThread(void *param) {
+}
+
+class SPSCQueueTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_push_pop() {
+		Common::SPSCQueue<int, 4> queue;
+		int item = 0;
+
+		TS_ASSERT(queue.empty());
+		TS_ASSERT(!queue.pop(item));
+
+		TS_ASSERT(queue.push(1));
+		TS_ASSERT(queue.push(2));
+		TS_ASSERT(!queue.empty());
+
+		TS_ASSERT(queue.pop(item));
+		TS_ASSERT_EQUALS(item, 1);
+		TS_ASSERT(queue.pop(item));
+		TS_ASSERT_EQUALS(item, 2);
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_full() {
+		Common::SPSCQueue<int, 4> queue;
+		int item = 0;
+
+		// Wrap around the ring several times
+		for (int round = 0; round < 3; round++) {
+			for (int i = 0; i < 4; i++)
+				TS_ASSERT(queue.push(round * 4 + i));
+			TS_ASSERT(!queue.push(-1));
+
+			for (int i = 0; i < 4; i++) {
+				TS_ASSERT(queue.pop(item));
+				TS_ASSERT_EQUALS(item, round * 4 + i);
+			}
+			TS_ASSERT(!queue.pop(item));
+		}
+	}
+
+	void test_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		// The producer would wait forever if it was run synchronously
+		Common::Thread probe;
+		if (!probe.start(spscNoopThread, nullptr))
+			return;
+		probe.join();
+
+		SPSCQueueTestData data;
+		data.count = 100000;
+
+		Common::Thread producer;
+		producer.start(spscProducerThread, &data);
+
+		// Every item arrives exactly once and in order
+		uint32 expected = 0, item = 0;
+		while (expected < data.count) {
+			if (data.queue.pop(item)) {
+				TS_ASSERT_EQUALS(item, expected);
+				expected++;
+			}
+		}
+
+		producer.join();
+		TS_ASSERT(data.queue.empty());
+	}
+};
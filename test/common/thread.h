@@ -0,0 +1,119 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/thread.h"
+#include "../null_osystem.h"
+
+static void incrementJob(void *param, uint job) {
+	Common::Array<uint> &counts = *(Common::Array<uint> *)param;
+	counts[job]++;
+}
+
+static void nestedJob(void *param, uint job) {
+	// Runs on the calling thread, since the pool is busy
+	Common::Array<uint> *counts = (Common::Array<uint> *)param;
+	Common::runParallelJobs(counts[job].size(), incrementJob, &counts[job]);
+}
+
+static void setFlagThread(void *param) {
+	*(bool *)param = true;
+}
+
+static void postThread(void *param) {
+	((Common::Semaphore *)param)->post();
+}
+
+class ThreadTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_thread_join() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		bool flag = false;
+
+		Common::Thread thread;
+		thread.start(setFlagThread, &flag);
+		thread.join();
+
+		TS_ASSERT(flag);
+		TS_ASSERT(!thread.isRunning());
+	}
+
+	void test_parallel_jobs() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		// Use worker threads even on single core hosts
+		ConfMan.setInt("worker_threads", 4, Common::ConfigManager::kApplicationDomain);
+		// The pool reads the configuration when it is created
+		Common::ParallelJobsPool::destroy();
+
+		// Every job must run exactly once, whatever the number of threads
+		for (uint threads = 0; threads <= 5; threads++) {
+			Common::Array<uint> counts;
+			counts.resize(37);
+			for (uint i = 0; i < counts.size(); i++)
+				counts[i] = 0;
+
+			Common::runParallelJobs(counts.size(), incrementJob, &counts, threads);
+
+			for (uint i = 0; i < counts.size(); i++)
+				TS_ASSERT_EQUALS(counts[i], 1u);
+		}
+
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+		Common::ParallelJobsPool::destroy();
+	}
+
+	void test_parallel_nested_jobs() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		ConfMan.setInt("worker_threads", 3, Common::ConfigManager::kApplicationDomain);
+		// The pool reads the configuration when it is created
+		Common::ParallelJobsPool::destroy();
+
+		Common::Array<uint> counts[5];
+		for (uint i = 0; i < ARRAYSIZE(counts); i++) {
+			counts[i].resize(11);
+			for (uint j = 0; j < counts[i].size(); j++)
+				counts[i][j] = 0;
+		}
+
+		Common::runParallelJobs(ARRAYSIZE(counts), nestedJob, counts);
+
+		for (uint i = 0; i < ARRAYSIZE(counts); i++) {
+			for (uint j = 0; j < counts[i].size(); j++)
+				TS_ASSERT_EQUALS(counts[i][j], 1u);
+		}
+
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+		Common::ParallelJobsPool::destroy();
+	}
+
+	void test_semaphore() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		Common::Semaphore semaphore;
+		if (!semaphore.isValid())
+			return;
+
+		// Posts are counted, even when nobody is waiting yet
+		semaphore.post();
+		semaphore.wait();
+
+		Common::Thread thread;
+		thread.start(postThread, &semaphore);
+		semaphore.wait();
+		thread.join();
+	}
+
+	void test_parallel_no_jobs() {
+		Common::Array<uint> counts;
+		Common::runParallelJobs(0, incrementJob, &counts);
+		TS_ASSERT(counts.empty());
+	}
+};
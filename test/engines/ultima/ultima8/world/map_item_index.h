@@ -0,0 +1,283 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/list.h"
+#include "common/system.h"
+#include "engines/ultima/ultima8/world/map_item_index.h"
+
+#include "../../../../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+namespace U8MapItemIndexTest {
+
+using Ultima::Ultima8::Box;
+using Ultima::Ultima8::Item;
+using Ultima::Ultima8::MapItemIndex;
+
+// Crusader map chunk size and largest footpad
+const int32 kChunkSize = 1024;
+const int32 kMaxFootpad = 0x1F * 32;
+
+// Stand-in for an Item, about as large as a real one. The index never
+// dereferences its item pointers, so these can be stored in it.
+struct BenchItem {
+	int32 _x, _y, _z;
+	int32 _xd, _yd;
+	byte _otherData[140];
+
+	Box getWorldBox() const {
+		return Box(_x, _y, _z, _xd, _yd, 8);
+	}
+};
+
+static Item *toItem(BenchItem *item) {
+	return reinterpret_cast<Item *>(item);
+}
+
+static const BenchItem *fromItem(const Item *item) {
+	return reinterpret_cast<const BenchItem *>(item);
+}
+
+static uint32 nextRandom(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) & 0xFFFFFF;
+}
+
+// A map of numChunks x numChunks chunks, with the items both in per-chunk
+// lists, like CurrentMap used to search them, and in a MapItemIndex
+class BenchMap {
+public:
+	BenchMap(int numChunks, int itemsPerChunk) : _numChunks(numChunks), _index(numChunks) {
+		_lists.resize(numChunks * numChunks);
+
+		uint32 seed = 1;
+		int count = numChunks * numChunks * itemsPerChunk;
+		for (int i = 0; i < count; i++) {
+			BenchItem *item = new BenchItem();
+			item->_x = nextRandom(seed) % (numChunks * kChunkSize);
+			item->_y = nextRandom(seed) % (numChunks * kChunkSize);
+			item->_z = 0;
+			item->_xd = 32 + (nextRandom(seed) % 4) * 96;
+			item->_yd = 32 + (nextRandom(seed) % 4) * 96;
+			_items.push_back(item);
+
+			int cx = item->_x / kChunkSize;
+			int cy = item->_y / kChunkSize;
+			_lists[cy * numChunks + cx].push_back(item);
+			_index.addToEnd(cx, cy, toItem(item), item->_x, item->_y);
+		}
+	}
+
+	~BenchMap() {
+		for (uint i = 0; i < _items.size(); i++)
+			delete _items[i];
+	}
+
+	// Count the items around (x,y) like CurrentMap::areaSearch
+	uint areaSearchList(int32 x, int32 y, int32 range) const {
+		const Box searchrange(x + range, y + range, 0, range * 2 + 1, range * 2 + 1, 1);
+		uint count = 0;
+		for (int cy = chunkMin(y - range); cy <= chunkMax(y + range); cy++) {
+			for (int cx = chunkMin(x - range); cx <= chunkMax(x + range); cx++) {
+				const Common::List<BenchItem *> &list = _lists[cy * _numChunks + cx];
+				for (Common::List<BenchItem *>::const_iterator it = list.begin(); it != list.end(); ++it) {
+					if (searchrange.containsXY((*it)->_x, (*it)->_y))
+						count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	uint areaSearchIndex(int32 x, int32 y, int32 range) const {
+		const Box searchrange(x + range, y + range, 0, range * 2 + 1, range * 2 + 1, 1);
+		uint count = 0;
+		for (int cy = chunkMin(y - range); cy <= chunkMax(y + range); cy++) {
+			for (int cx = chunkMin(x - range); cx <= chunkMax(x + range); cx++) {
+				const MapItemIndex::EntryArray &entries = _index.getChunk(cx, cy);
+				for (uint i = 0; i < entries.size(); i++) {
+					if (searchrange.containsXY(entries[i]._x, entries[i]._y))
+						count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	// Count the items overlapping the box like CurrentMap::getPositionInfo
+	uint overlapList(const Box &target) const {
+		uint count = 0;
+		for (int cx = chunkMin(target._x - target._xd); cx <= chunkMax(target._x); cx++) {
+			for (int cy = chunkMin(target._y - target._yd); cy <= chunkMax(target._y); cy++) {
+				const Common::List<BenchItem *> &list = _lists[cy * _numChunks + cx];
+				for (Common::List<BenchItem *>::const_iterator it = list.begin(); it != list.end(); ++it) {
+					if (target.overlapsXY((*it)->getWorldBox()))
+						count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	uint overlapIndex(const Box &target) const {
+		uint count = 0;
+		for (int cx = chunkMin(target._x - target._xd); cx <= chunkMax(target._x); cx++) {
+			for (int cy = chunkMin(target._y - target._yd); cy <= chunkMax(target._y); cy++) {
+				const MapItemIndex::EntryArray &entries = _index.getChunk(cx, cy);
+				for (uint i = 0; i < entries.size(); i++) {
+					if (!entries[i].mayOverlapXY(target, kMaxFootpad, 1))
+						continue;
+					if (target.overlapsXY(fromItem(entries[i]._item)->getWorldBox()))
+						count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	int32 getSize() const {
+		return _numChunks * kChunkSize;
+	}
+
+private:
+	// Chunk range to search, one chunk around the area like CurrentMap
+	int chunkMin(int32 v) const {
+		return CLIP<int>(v / kChunkSize - 1, 0, _numChunks - 1);
+	}
+
+	int chunkMax(int32 v) const {
+		return CLIP<int>(v / kChunkSize + 1, 0, _numChunks - 1);
+	}
+
+	int _numChunks;
+	Common::Array<BenchItem *> _items;
+	Common::Array<Common::List<BenchItem *> > _lists;
+	MapItemIndex _index;
+};
+
+// Typical usecode queries: area searches for nearby items, and collision
+// checks for actors and projectiles
+static void runQueries(const BenchMap &map, int count, bool useIndex, uint &areaMatches, uint &overlapMatches) {
+	static const int32 ranges[] = { 64, 256, 512, 1024, 2048 };
+
+	uint32 seed = 7;
+	areaMatches = 0;
+	overlapMatches = 0;
+	for (int i = 0; i < count; i++) {
+		int32 x = nextRandom(seed) % map.getSize();
+		int32 y = nextRandom(seed) % map.getSize();
+		int32 range = ranges[i % ARRAYSIZE(ranges)];
+		areaMatches += useIndex ? map.areaSearchIndex(x, y, range) : map.areaSearchList(x, y, range);
+
+		// an actor footpad, or a projectile moving a few steps
+		const Box target = (i & 1) ? Box(x, y, 0, 128, 128, 8) : Box(x, y, 0, 64, 24, 8);
+		overlapMatches += useIndex ? map.overlapIndex(target) : map.overlapList(target);
+	}
+}
+
+} // End of namespace U8MapItemIndexTest
+
+using namespace U8MapItemIndexTest;
+
+class U8MapItemIndexTestSuite : public CxxTest::TestSuite {
+public:
+	void test_order() {
+		MapItemIndex index(4);
+		BenchItem a, b, c;
+
+		index.addToEnd(1, 2, toItem(&a), 1100, 2100);
+		index.addToStart(1, 2, toItem(&b), 1200, 2200);
+		index.addToEnd(1, 2, toItem(&c), 1300, 2300);
+		TS_ASSERT(index.getChunk(2, 1).empty());
+
+		// same order as a list with push_front and push_back
+		const MapItemIndex::EntryArray &entries = index.getChunk(1, 2);
+		TS_ASSERT_EQUALS(entries.size(), 3U);
+		TS_ASSERT_EQUALS(entries[0]._item, toItem(&b));
+		TS_ASSERT_EQUALS(entries[1]._item, toItem(&a));
+		TS_ASSERT_EQUALS(entries[2]._item, toItem(&c));
+		TS_ASSERT_EQUALS(entries[1]._x, 1100);
+		TS_ASSERT_EQUALS(entries[1]._y, 2100);
+
+		TS_ASSERT(index.setLocation(1, 2, toItem(&a), 1150, 2050));
+		TS_ASSERT_EQUALS(entries[1]._x, 1150);
+		TS_ASSERT_EQUALS(entries[1]._y, 2050);
+		TS_ASSERT(!index.setLocation(2, 2, toItem(&a), 0, 0));
+
+		TS_ASSERT(index.remove(1, 2, toItem(&a)));
+		TS_ASSERT(!index.remove(1, 2, toItem(&a)));
+		TS_ASSERT_EQUALS(entries.size(), 2U);
+		TS_ASSERT_EQUALS(entries[0]._item, toItem(&b));
+		TS_ASSERT_EQUALS(entries[1]._item, toItem(&c));
+
+		index.clear();
+		TS_ASSERT(index.getChunk(1, 2).empty());
+	}
+
+	void test_may_overlap() {
+		const Box box(1000, 2000, 0, 100, 50, 10);
+		MapItemIndex::Entry entry;
+
+		// overlapping with a footpad of up to 200
+		entry._x = 1199;
+		entry._y = 2199;
+		TS_ASSERT(entry.mayOverlapXY(box, 200, 0));
+		entry._x = 1200;
+		TS_ASSERT(!entry.mayOverlapXY(box, 200, 0));
+		TS_ASSERT(entry.mayOverlapXY(box, 200, 1));
+
+		// the item's origin must be past the far side of the box
+		entry._x = 901;
+		entry._y = 1951;
+		TS_ASSERT(entry.mayOverlapXY(box, 200, 0));
+		entry._y = 1950;
+		TS_ASSERT(!entry.mayOverlapXY(box, 200, 0));
+		TS_ASSERT(entry.mayOverlapXY(box, 200, 1));
+	}
+
+	void test_search_matches_lists() {
+		BenchMap map(8, 20);
+		uint listArea, listOverlap, indexArea, indexOverlap;
+
+		runQueries(map, 500, false, listArea, listOverlap);
+		runQueries(map, 500, true, indexArea, indexOverlap);
+		TS_ASSERT_EQUALS(listArea, indexArea);
+		TS_ASSERT_EQUALS(listOverlap, indexOverlap);
+		TS_ASSERT(listArea > 0);
+		TS_ASSERT(listOverlap > 0);
+	}
+
+	void test_search_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int queries = 100000;
+#else
+		const int queries = 5000;
+#endif
+		// A busy Crusader map
+		BenchMap map(32, 40);
+		uint listArea, listOverlap, indexArea, indexOverlap;
+
+		uint32 start = g_system->getMillis();
+		runQueries(map, queries, false, listArea, listOverlap);
+		uint32 listTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		runQueries(map, queries, true, indexArea, indexOverlap);
+		uint32 indexTime = g_system->getMillis() - start;
+
+		TS_ASSERT_EQUALS(listArea, indexArea);
+		TS_ASSERT_EQUALS(listOverlap, indexOverlap);
+
+		debug("MapItemIndex: %d queries: item lists %u ms, index %u ms (%u area matches, %u overlaps)",
+			queries, listTime, indexTime, indexArea, indexOverlap);
+#endif
+	}
+};
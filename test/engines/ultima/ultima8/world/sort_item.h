@@ -869,4 +869,36 @@ class U8SortItemTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT(!si1.overlap(si2));
 		TS_ASSERT(!si2.overlap(si1));
 	}
+
+	/* Rolling back the display list drops dependencies added after that point */
+	void test_depends_remove_added() {
+		Ultima::Ultima8::SortItem si1;
+		Ultima::Ultima8::SortItem si2;
+		Ultima::Ultima8::SortItem si3;
+		Ultima::Ultima8::SortItem si4;
+
+		si2._addNum = 1;
+		si3._addNum = 2;
+		si4._addNum = 3;
+
+		si1._depends.push_back(&si3);
+		si1._depends.push_back(&si2);
+		si1._depends.push_back(&si4);
+
+		si1._depends.removeAddedFrom(2);
+		Ultima::Ultima8::SortItem::DependsList::iterator it = si1._depends.begin();
+		TS_ASSERT(it != si1._depends.end());
+		TS_ASSERT(*it == &si2);
+		++it;
+		TS_ASSERT(!(it != si1._depends.end()));
+		TS_ASSERT(si1._depends.tail != nullptr && si1._depends.tail->val == &si2);
+
+		// Removed nodes are reused
+		si1._depends.push_back(&si3);
+		TS_ASSERT(si1._depends.tail->val == &si3);
+
+		si1._depends.removeAddedFrom(0);
+		TS_ASSERT(!(si1._depends.begin() != si1._depends.end()));
+		TS_ASSERT(si1._depends.tail == nullptr);
+	}
 };
@@ -0,0 +1,109 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+
+#include "graphics/tinygl/tinygl.h"
+
+#include "../null_osystem.h"
+
+static const int kTinyGLWidth = 160;
+static const int kTinyGLHeight = 120;
+
+// Deterministic pseudo random coordinates in [low, high]
+static float tinyGLRandom(uint32 &seed, float low, float high) {
+	seed = seed * 1103515245 + 12345;
+	return low + ((seed >> 16) & 0x7fff) * (high - low) / 0x7fff;
+}
+
+static void drawTinyGLScene(float quadOffset) {
+	uint32 seed = 1;
+
+	tglViewport(0, 0, kTinyGLWidth, kTinyGLHeight);
+	tglMatrixMode(TGL_PROJECTION);
+	tglLoadIdentity();
+	tglMatrixMode(TGL_MODELVIEW);
+	tglLoadIdentity();
+
+	tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+	tglClearDepth(1.0f);
+	tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+	tglEnable(TGL_DEPTH_TEST);
+	tglEnable(TGL_BLEND);
+	tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+	// Overlapping blended triangles, partly outside of the screen
+	for (int i = 0; i < 24; i++) {
+		tglBegin(TGL_TRIANGLES);
+		for (int v = 0; v < 3; v++) {
+			tglColor4f(tinyGLRandom(seed, 0.0f, 1.0f), tinyGLRandom(seed, 0.0f, 1.0f),
+			           tinyGLRandom(seed, 0.0f, 1.0f), tinyGLRandom(seed, 0.0f, 1.0f));
+			tglVertex3f(tinyGLRandom(seed, -1.2f, 1.2f), tinyGLRandom(seed, -1.2f, 1.2f),
+			            tinyGLRandom(seed, -1.0f, 1.0f));
+		}
+		tglEnd();
+	}
+
+	tglDisable(TGL_BLEND);
+
+	tglBegin(TGL_QUADS);
+	tglColor4f(1.0f, 1.0f, 0.0f, 1.0f);
+	tglVertex3f(quadOffset - 0.5f, -0.5f, 0.0f);
+	tglVertex3f(quadOffset + 0.5f, -0.5f, 0.0f);
+	tglVertex3f(quadOffset + 0.5f, 0.5f, 0.5f);
+	tglVertex3f(quadOffset - 0.5f, 0.5f, 0.5f);
+	tglEnd();
+
+	tglBegin(TGL_LINE_STRIP);
+	for (int i = 0; i < 16; i++) {
+		tglColor4f(0.0f, 1.0f, i / 16.0f, 1.0f);
+		tglVertex3f(tinyGLRandom(seed, -1.0f, 1.0f), tinyGLRandom(seed, -1.0f, 1.0f), -0.5f);
+	}
+	tglEnd();
+
+	Common::List<Common::Rect> dirtyAreas;
+	TinyGL::presentBuffer(dirtyAreas);
+}
+
+static Graphics::Surface *renderTinyGLScene(bool tiled, bool dirtyRects) {
+	ConfMan.setBool("tinygl_tiled_rasterization", tiled, Common::ConfigManager::kApplicationDomain);
+
+	Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+	TinyGL::ContextHandle *context = TinyGL::createContext(kTinyGLWidth, kTinyGLHeight, format, 256, false, dirtyRects);
+
+	// With dirty rectangles, the second frame only redraws around the moved quad
+	drawTinyGLScene(0.0f);
+	drawTinyGLScene(0.3f);
+
+	Graphics::Surface *surface = TinyGL::copyFromFrameBuffer(format);
+	TinyGL::destroyContext(context);
+
+	ConfMan.removeKey("tinygl_tiled_rasterization", Common::ConfigManager::kApplicationDomain);
+	return surface;
+}
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+public:
+	void test_tiled_rasterization() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		// Use worker threads even on single core hosts
+		ConfMan.setInt("worker_threads", 3, Common::ConfigManager::kApplicationDomain);
+
+		for (int dirtyRects = 0; dirtyRects <= 1; dirtyRects++) {
+			Graphics::Surface *serial = renderTinyGLScene(false, dirtyRects);
+			Graphics::Surface *tiled = renderTinyGLScene(true, dirtyRects);
+
+			TS_ASSERT_EQUALS(serial->pitch, tiled->pitch);
+			TS_ASSERT_EQUALS(memcmp(serial->getPixels(), tiled->getPixels(), serial->pitch * serial->h), 0);
+
+			serial->free();
+			delete serial;
+			tiled->free();
+			delete tiled;
+		}
+
+		ConfMan.removeKey("worker_threads", Common::ConfigManager::kApplicationDomain);
+	}
+};
@@ -0,0 +1,160 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_rows.h"
+
+// The scalar arithmetic shared by the kernels, for builds without any of them
+static void convertRowScalar(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, bool halfChroma, const Graphics::YUVToRGBRowFormat &format) {
+	Graphics::yuvToRGBRowTail(dst, ySrc, uSrc, vSrc, aSrc, 0, width, halfChroma, format);
+}
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	// Not a multiple of the vector sizes, to also cover the scalar tails
+	static const int kWidth = 44;
+	static const int kHeight = 12;
+	// The kernels may differ from the lookup tables by one for each component
+	static const int kTolerance = 1;
+
+	enum Layout {
+		k444,
+		k422,
+		k420,
+		k420Alpha,
+		k410
+	};
+
+	byte _y[kWidth * kHeight];
+	byte _a[kWidth * kHeight];
+	// Large enough for 444, with the extra row and column needed by 410
+	byte _u[(kWidth + 1) * (kHeight + 1)];
+	byte _v[(kWidth + 1) * (kHeight + 1)];
+
+	void fillPlanes() {
+		uint32 seed = 1;
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			seed = seed * 1103515245 + 12345;
+			_y[i] = (byte)(seed >> 16);
+			_a[i] = (byte)(seed >> 24);
+		}
+
+		for (int i = 0; i < (kWidth + 1) * (kHeight + 1); i++) {
+			seed = seed * 1103515245 + 12345;
+			_u[i] = (byte)(seed >> 16);
+			_v[i] = (byte)(seed >> 24);
+		}
+
+		// Make sure the extremes are covered
+		_y[0] = _u[0] = _v[0] = 0;
+		_y[1] = _u[1] = _v[1] = 255;
+		_u[2] = 0;
+		_v[2] = 255;
+	}
+
+	void convert(Graphics::Surface &dst, Layout layout, Graphics::YUVToRGBManager::LuminanceScale scale) {
+		switch (layout) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth + 1);
+			break;
+		case k422:
+			YUVToRGBMan.convert422(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth + 1);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth + 1);
+			break;
+		case k420Alpha:
+			YUVToRGBMan.convert420Alpha(&dst, scale, _y, _u, _v, _a, kWidth, kHeight, kWidth, kWidth + 1);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&dst, scale, _y, _u, _v, kWidth, kHeight, kWidth, kWidth + 1);
+			break;
+		}
+	}
+
+	void checkKernel(Graphics::YUVToRGBManager::RowFunc rowFunc) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0)
+		};
+
+		fillPlanes();
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			const Graphics::PixelFormat &format = formats[f];
+
+			for (int layout = k444; layout <= k410; layout++) {
+				for (int s = 0; s < 2; s++) {
+					const Graphics::YUVToRGBManager::LuminanceScale scale = s ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+					Graphics::Surface expected, actual;
+					expected.create(kWidth, kHeight, format);
+					actual.create(kWidth, kHeight, format);
+
+					Graphics::YUVToRGBManager::setRowFunc(nullptr);
+					convert(expected, (Layout)layout, scale);
+					Graphics::YUVToRGBManager::setRowFunc(rowFunc);
+					convert(actual, (Layout)layout, scale);
+
+					// Compare each component in the units of the pixel format
+					const int rMask = 0xFF >> format.rLoss;
+					const int gMask = 0xFF >> format.gLoss;
+					const int bMask = 0xFF >> format.bLoss;
+					const int aMask = 0xFF >> format.aLoss;
+
+					int maxDiff = 0;
+					for (int y = 0; y < kHeight; y++) {
+						for (int x = 0; x < kWidth; x++) {
+							const int p1 = expected.getPixel(x, y);
+							const int p2 = actual.getPixel(x, y);
+
+							TS_ASSERT_EQUALS((p1 >> format.aShift) & aMask, (p2 >> format.aShift) & aMask);
+							maxDiff = MAX(maxDiff, ABS(((p1 >> format.rShift) & rMask) - ((p2 >> format.rShift) & rMask)));
+							maxDiff = MAX(maxDiff, ABS(((p1 >> format.gShift) & gMask) - ((p2 >> format.gShift) & gMask)));
+							maxDiff = MAX(maxDiff, ABS(((p1 >> format.bShift) & bMask) - ((p2 >> format.bShift) & bMask)));
+						}
+					}
+
+					TS_ASSERT_LESS_THAN_EQUALS(maxDiff, kTolerance);
+
+					expected.free();
+					actual.free();
+				}
+			}
+		}
+
+		Graphics::YUVToRGBManager::setRowFunc(nullptr);
+	}
+
+public:
+	void test_scalar() {
+		checkKernel(convertRowScalar);
+	}
+
+	void test_neon() {
+#ifdef SCUMMVM_NEON
+		checkKernel(Graphics::YUVToRGBManager::convertRowNEON);
+#endif
+	}
+
+	void test_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernel(Graphics::YUVToRGBManager::convertRowSSE2);
+#endif
+	}
+
+	void test_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernel(Graphics::YUVToRGBManager::convertRowAVX2);
+#endif
+	}
+};
@@ -0,0 +1,93 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#ifdef USE_BINK
+#include "video/bink_idct.h"
+#endif
+
+class BinkIDCTTestSuite : public CxxTest::TestSuite
+{
+	static const uint32 kPitch = 13;
+	static const int kNumBlocks = 500;
+
+	static void fillBlock(int32 *block, uint32 &seed, int i) {
+		// Alternate between dense blocks, and blocks with only a few
+		// coefficients like most real ones
+		for (int j = 0; j < 64; j++) {
+			seed = seed * 1103515245 + 12345;
+			int32 value = (int32)((seed >> 8) & 0x7FFF) - 0x4000;
+			if ((i & 1) && (j & 7) > 1 && j > 16)
+				value = 0;
+			block[j] = value;
+		}
+	}
+
+	static void fillPixels(byte *pixels, uint32 &seed) {
+		for (uint32 j = 0; j < kPitch * 8; j++) {
+			seed = seed * 1103515245 + 12345;
+			pixels[j] = (byte)(seed >> 16);
+		}
+	}
+
+#ifdef USE_BINK
+	static void checkKernels(Video::BinkIDCT::Func put, Video::BinkIDCT::Func add) {
+		uint32 seed = 1;
+		int32 block[64];
+		byte expected[kPitch * 8];
+		byte actual[kPitch * 8];
+
+		for (int i = 0; i < kNumBlocks; i++) {
+			fillBlock(block, seed, i);
+
+			// Put
+			fillPixels(expected, seed);
+			memcpy(actual, expected, sizeof(actual));
+			Video::BinkIDCT::putGeneric(expected, kPitch, block);
+			put(actual, kPitch, block);
+			TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(actual)), 0);
+
+			// Add
+			fillPixels(expected, seed);
+			memcpy(actual, expected, sizeof(actual));
+			Video::BinkIDCT::addGeneric(expected, kPitch, block);
+			add(actual, kPitch, block);
+			TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(actual)), 0);
+		}
+	}
+#endif
+
+public:
+	void test_transform() {
+#ifdef USE_BINK
+		uint32 seed = 1;
+		int32 block[64];
+		byte pixels[kPitch * 8];
+
+		fillBlock(block, seed, 0);
+		Video::BinkIDCT::putGeneric(pixels, kPitch, block);
+		Video::BinkIDCT::transform(block);
+
+		// The put kernel stores the transformed block truncated to 8 bits
+		for (int y = 0; y < 8; y++)
+			for (int x = 0; x < 8; x++)
+				TS_ASSERT_EQUALS(pixels[y * kPitch + x], (byte)block[y * 8 + x]);
+#endif
+	}
+
+	void test_neon() {
+#if defined(USE_BINK) && defined(SCUMMVM_NEON)
+		checkKernels(Video::BinkIDCT::putNEON, Video::BinkIDCT::addNEON);
+#endif
+	}
+
+	void test_sse2() {
+#if defined(USE_BINK) && defined(SCUMMVM_SSE2)
+		if (instrset_detect() >= 2)
+			checkKernels(Video::BinkIDCT::putSSE2, Video::BinkIDCT::addSSE2);
+#endif
+	}
+};
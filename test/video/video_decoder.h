@@ -0,0 +1,125 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+static const int kReadAheadFrameCount = 60;
+
+// A video whose frames are filled with their frame number, and which
+// changes its palette every tenth frame
+class ReadAheadTestDecoder : public Video::VideoDecoder {
+public:
+	bool loadStream(Common::SeekableReadStream *stream) override { return false; }
+
+	void load() { addTrack(new TestVideoTrack()); }
+
+private:
+	class TestVideoTrack : public FixedRateVideoTrack {
+	public:
+		TestVideoTrack() : _curFrame(-1), _dirtyPalette(false) {
+			_surface.create(16, 8, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_palette, 0, sizeof(_palette));
+		}
+
+		~TestVideoTrack() { _surface.free(); }
+
+		bool isSeekable() const override { return true; }
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return kReadAheadFrameCount; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			_surface.fillRect(Common::Rect(_surface.w, _surface.h), (byte)_curFrame);
+
+			_dirtyPalette = (_curFrame % 10) == 0;
+			if (_dirtyPalette)
+				memset(_palette, _curFrame, sizeof(_palette));
+
+			return &_surface;
+		}
+
+		const byte *getPalette() const override { _dirtyPalette = false; return _palette; }
+		bool hasDirtyPalette() const override { return _dirtyPalette; }
+
+	protected:
+		Common::Rational getFrameRate() const override { return 30; }
+
+	private:
+		Graphics::Surface _surface;
+		int _curFrame;
+		byte _palette[256 * 3];
+		mutable bool _dirtyPalette;
+	};
+};
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+	// Decode the next frame and check that it is frame @p frame
+	static void checkNextFrame(ReadAheadTestDecoder &decoder, int frame) {
+		const Graphics::Surface *surface = decoder.decodeNextFrame();
+
+		TS_ASSERT(surface);
+		if (!surface)
+			return;
+
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), frame);
+		TS_ASSERT_EQUALS(*(const byte *)surface->getBasePtr(15, 7), (byte)frame);
+		TS_ASSERT_EQUALS(decoder.hasDirtyPalette(), (frame % 10) == 0);
+
+		if (decoder.hasDirtyPalette())
+			TS_ASSERT_EQUALS(decoder.getPalette()[767], (byte)frame);
+	}
+
+public:
+	void test_read_ahead() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		for (uint readAhead = 0; readAhead <= 4; readAhead += 4) {
+			ReadAheadTestDecoder decoder;
+			decoder.load();
+			TS_ASSERT(decoder.setReadAheadFrames(readAhead));
+
+			for (int frame = 0; frame < kReadAheadFrameCount; frame++) {
+				checkNextFrame(decoder, frame);
+				TS_ASSERT_EQUALS(decoder.endOfVideo(), frame == kReadAheadFrameCount - 1);
+			}
+
+			decoder.close();
+		}
+	}
+
+	void test_read_ahead_seek() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		ReadAheadTestDecoder decoder;
+		decoder.load();
+		TS_ASSERT(decoder.setReadAheadFrames(8));
+
+		for (int frame = 0; frame < 10; frame++)
+			checkNextFrame(decoder, frame);
+
+		// The frames decoded ahead must be dropped
+		TS_ASSERT(decoder.seekToFrame(40));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 39);
+		checkNextFrame(decoder, 40);
+		checkNextFrame(decoder, 41);
+
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), -1);
+		for (int frame = 0; frame < 12; frame++)
+			checkNextFrame(decoder, frame);
+
+		decoder.close();
+	}
+};
@@ -36,6 +36,7 @@
 #include "common/bitstream.h"
 #include "common/compression/huffman.h"
 #include "common/system.h"
+#include "common/thread.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -307,12 +308,37 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32
 
 	initBundles();
 	initHuffman();
+
+	_idctPut = BinkIDCT::getPutFunc();
+	_idctAdd = BinkIDCT::getAddFunc();
+
+	// The planes are stored one after another in the bitstream, so they have
+	// to be parsed in order. Only the IDCTs, which are most of the work, can
+	// be deferred until the whole frame is parsed and then run in parallel.
+	_parallelPlanes = Common::getWorkerThreadCount() > 1;
+
+	for (int i = 0; i < 4; i++) {
+		PlaneJob &job = _planeJobs[i];
+
+		job.idcts   = nullptr;
+		job.count   = 0;
+		job.pitch   = (i == 1 || i == 2) ? _uvBlockWidth * 8 : _yBlockWidth * 8;
+		job.idctPut = _idctPut;
+		job.idctAdd = _idctAdd;
+
+		if (_parallelPlanes && (i != 3 || _hasAlpha)) {
+			uint32 blockCount = (i == 1 || i == 2) ? _uvBlockWidth * _uvBlockHeight : _yBlockWidth * _yBlockHeight;
+			job.idcts = new DeferredIDCT[blockCount];
+		}
+	}
 }
 
 BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 	for (int i = 0; i < 4; i++) {
 		delete[] _curPlanes[i]; _curPlanes[i] = 0;
 		delete[] _oldPlanes[i]; _oldPlanes[i] = 0;
+
+		delete[] _planeJobs[i].idcts; _planeJobs[i].idcts = 0;
 	}
 
 	deinitBundles();
@@ -478,6 +504,9 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
+	if (_parallelPlanes)
+		runPlaneJobs();
+
 	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
@@ -595,7 +624,28 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 
 	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
 		video.bits->skip(32 - (video.bits->pos() & 0x1F));
+}
 
+void BinkDecoder::BinkVideoTrack::runPlaneJobs() {
+	Common::runParallelJobs(ARRAYSIZE(_planeJobs), runPlaneJob, _planeJobs);
+}
+
+void BinkDecoder::BinkVideoTrack::runPlaneJob(void *param, uint planeIdx) {
+	PlaneJob &job = ((PlaneJob *)param)[planeIdx];
+
+	// Blocks only read from the previous frame, and 16x16 blocks only write
+	// over blocks which have not been parsed yet. Running the IDCTs after
+	// all other blocks of the plane therefore gives the same result.
+	for (uint32 i = 0; i < job.count; i++) {
+		const DeferredIDCT &idct = job.idcts[i];
+
+		if (idct.add)
+			job.idctAdd(idct.dest, job.pitch, idct.block);
+		else
+			job.idctPut(idct.dest, job.pitch, idct.block);
+	}
+
+	job.count = 0;
 }
 
 void BinkDecoder::BinkVideoTrack::readBundle(VideoFrame &video, Source source) {
@@ -815,7 +865,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCT(block);
+	BinkIDCT::transform(block);
 
 	int32 *src   = block;
 	byte  *dest1 = ctx.dest;
@@ -1410,86 +1460,32 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-	const int a0 = (src)[s0] + (src)[s4]; \
-	const int a1 = (src)[s0] - (src)[s4]; \
-	const int a2 = (src)[s2] + (src)[s6]; \
-	const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-	const int a4 = (src)[s5] + (src)[s3]; \
-	const int a5 = (src)[s5] - (src)[s3]; \
-	const int a6 = (src)[s1] + (src)[s7]; \
-	const int a7 = (src)[s1] - (src)[s7]; \
-	const int b0 = a4 + a6; \
-	const int b1 = (A3*(a5 + a7)) >> 11; \
-	const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-	const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-	const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-	(dest)[d0] = munge(a0+a2   +b0); \
-	(dest)[d1] = munge(a1+a3-a2+b2); \
-	(dest)[d2] = munge(a1-a3+a2+b3); \
-	(dest)[d3] = munge(a0-a2   -b4); \
-	(dest)[d4] = munge(a0-a2   +b4); \
-	(dest)[d5] = munge(a1-a3+a2-b3); \
-	(dest)[d6] = munge(a1+a3-a2-b2); \
-	(dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int32 *dest, const int32 *src) {
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
-	int i;
-	int32 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
+	if (!_parallelPlanes) {
+		_idctAdd(ctx.dest, ctx.pitch, block);
+		return;
 	}
-}
 
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
-	int i, j;
+	PlaneJob &job = _planeJobs[ctx.planeIdx];
+	DeferredIDCT &idct = job.idcts[job.count++];
 
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
+	idct.dest = ctx.dest;
+	idct.add  = true;
+	memcpy(idct.block, block, sizeof(idct.block));
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
-	int i;
-	int32 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
+	if (!_parallelPlanes) {
+		_idctPut(ctx.dest, ctx.pitch, block);
+		return;
 	}
+
+	PlaneJob &job = _planeJobs[ctx.planeIdx];
+	DeferredIDCT &idct = job.idcts[job.count++];
+
+	idct.dest = ctx.dest;
+	idct.add  = false;
+	memcpy(idct.block, block, sizeof(idct.block));
 }
 
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
@@ -35,6 +35,7 @@
 #include "common/rational.h"
 
 #include "video/video_decoder.h"
+#include "video/bink_idct.h"
 
 #include "graphics/surface.h"
 
@@ -221,6 +222,23 @@ private:
 			kBlockRaw           ///< Uncoded 8x8 block.
 		};
 
+		/** An IDCT whose result is written once its whole plane has been parsed. */
+		struct DeferredIDCT {
+			byte *dest;
+			bool add;
+			int32 block[64];
+		};
+
+		/** The IDCTs of a plane, run in parallel to the other planes once the frame has been parsed. */
+		struct PlaneJob {
+			DeferredIDCT *idcts;
+			uint32 count;
+			uint32 pitch;
+
+			BinkIDCT::Func idctPut;
+			BinkIDCT::Func idctAdd;
+		};
+
 		/** Data structure for decoding and tranlating Huffman'd data. */
 		struct Huffman {
 			int  index;       ///< Index of the Huffman codebook to use.
@@ -275,6 +293,12 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		BinkIDCT::Func _idctPut; ///< IDCT kernel storing its result.
+		BinkIDCT::Func _idctAdd; ///< IDCT kernel adding its result.
+
+		bool _parallelPlanes;     ///< Are the IDCTs of the planes deferred and run in parallel?
+		PlaneJob _planeJobs[4];   ///< The deferred IDCTs of each plane.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -286,6 +310,11 @@ private:
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
+		/** Run the deferred IDCTs of all planes, one plane per worker thread. */
+		void runPlaneJobs();
+		/** Run the deferred IDCTs of a plane. */
+		static void runPlaneJob(void *param, uint planeIdx);
+
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
 
@@ -332,7 +361,6 @@ private:
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
 		// Bink video IDCT
-		void IDCT(int32 *block);
 		void IDCTPut(DecodeContext &ctx, int32 *block);
 		void IDCTAdd(DecodeContext &ctx, int32 *block);
 	};
@@ -0,0 +1,69 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VIDEO_BINK_IDCT_H
+#define VIDEO_BINK_IDCT_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * Inverse DCT of the Bink video decoder.
+ *
+ * The put kernels transform a block of 8x8 dequantized coefficients and
+ * store the result into an 8x8 block of a plane, the add kernels add the
+ * result to the pixels already in the plane. Like the original decoder,
+ * results are truncated to 8 bits rather than clamped. Every kernel
+ * computes exactly the same as the generic ones.
+ */
+class BinkIDCT {
+public:
+	typedef void (*Func)(byte *dest, uint32 pitch, const int32 *block);
+
+	/** Return the fastest put kernel supported by the CPU. */
+	static Func getPutFunc();
+
+	/** Return the fastest add kernel supported by the CPU. */
+	static Func getAddFunc();
+
+	/** Transform a block in place, without rounding the result to pixels. */
+	static void transform(int32 *block);
+
+	static void putGeneric(byte *dest, uint32 pitch, const int32 *block);
+	static void addGeneric(byte *dest, uint32 pitch, const int32 *block);
+#ifdef SCUMMVM_NEON
+	static void putNEON(byte *dest, uint32 pitch, const int32 *block);
+	static void addNEON(byte *dest, uint32 pitch, const int32 *block);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void putSSE2(byte *dest, uint32 pitch, const int32 *block);
+	static void addSSE2(byte *dest, uint32 pitch, const int32 *block);
+#endif
+
+private:
+	static Func _putFunc;
+	static Func _addFunc;
+};
+
+} // End of namespace Video
+
+#endif
@@ -0,0 +1,167 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "video/bink_idct.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Video {
+
+// The same constants as in the generic transform
+enum {
+	kA1 =  2896,
+	kA2 =  2217,
+	kA3 =  3784,
+	kA4 = -5352
+};
+
+static inline int32x4_t mulShift(int32x4_t a, int32 c) {
+	return vshrq_n_s32(vmulq_n_s32(a, c), 11);
+}
+
+static inline void transpose4(int32x4_t &r0, int32x4_t &r1, int32x4_t &r2, int32x4_t &r3) {
+	const int32x4x2_t t01 = vtrnq_s32(r0, r1);
+	const int32x4x2_t t23 = vtrnq_s32(r2, r3);
+	r0 = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));
+	r1 = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));
+	r2 = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0]));
+	r3 = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1]));
+}
+
+/** One pass of the transform on four independent lines at once. */
+template<bool munge>
+static inline void transformLines(int32x4_t *d, const int32x4_t *s) {
+	const int32x4_t a0 = vaddq_s32(s[0], s[4]);
+	const int32x4_t a1 = vsubq_s32(s[0], s[4]);
+	const int32x4_t a2 = vaddq_s32(s[2], s[6]);
+	const int32x4_t a3 = mulShift(vsubq_s32(s[2], s[6]), kA1);
+	const int32x4_t a4 = vaddq_s32(s[5], s[3]);
+	const int32x4_t a5 = vsubq_s32(s[5], s[3]);
+	const int32x4_t a6 = vaddq_s32(s[1], s[7]);
+	const int32x4_t a7 = vsubq_s32(s[1], s[7]);
+	const int32x4_t b0 = vaddq_s32(a4, a6);
+	const int32x4_t b1 = mulShift(vaddq_s32(a5, a7), kA3);
+	const int32x4_t b2 = vaddq_s32(vsubq_s32(mulShift(a5, kA4), b0), b1);
+	const int32x4_t b3 = vsubq_s32(mulShift(vsubq_s32(a6, a4), kA1), b2);
+	const int32x4_t b4 = vsubq_s32(vaddq_s32(mulShift(a7, kA2), b3), b1);
+
+	const int32x4_t c0 = vaddq_s32(a0, a2);
+	const int32x4_t c1 = vsubq_s32(vaddq_s32(a1, a3), a2);
+	const int32x4_t c2 = vaddq_s32(vsubq_s32(a1, a3), a2);
+	const int32x4_t c3 = vsubq_s32(a0, a2);
+
+	d[0] = vaddq_s32(c0, b0);
+	d[1] = vaddq_s32(c1, b2);
+	d[2] = vaddq_s32(c2, b3);
+	d[3] = vsubq_s32(c3, b4);
+	d[4] = vaddq_s32(c3, b4);
+	d[5] = vsubq_s32(c2, b3);
+	d[6] = vsubq_s32(c1, b2);
+	d[7] = vsubq_s32(c0, b0);
+
+	if (munge) {
+		const int32x4_t round = vdupq_n_s32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = vshrq_n_s32(vaddq_s32(d[i], round), 8);
+	}
+}
+
+/**
+ * Transform a block. Row i of the result is stored in rows[2 * i] (columns
+ * 0-3) and rows[2 * i + 1] (columns 4-7).
+ */
+static inline void transformBlock(int32x4_t *rows, const int32 *block) {
+	int32x4_t s[8], d[8];
+
+	// Columns, four at a time
+	for (int half = 0; half < 2; half++) {
+		for (int i = 0; i < 8; i++)
+			s[i] = vld1q_s32(block + i * 8 + half * 4);
+		transformLines<false>(d, s);
+		for (int i = 0; i < 8; i++)
+			rows[i * 2 + half] = d[i];
+	}
+
+	// Rows, four at a time, transposed so that each vector holds the same
+	// column of four rows
+	for (int quad = 0; quad < 8; quad += 4) {
+		int32x4_t *r = rows + quad * 2;
+		for (int i = 0; i < 4; i++) {
+			s[i] = r[i * 2];
+			s[i + 4] = r[i * 2 + 1];
+		}
+		transpose4(s[0], s[1], s[2], s[3]);
+		transpose4(s[4], s[5], s[6], s[7]);
+
+		transformLines<true>(d, s);
+
+		transpose4(d[0], d[1], d[2], d[3]);
+		transpose4(d[4], d[5], d[6], d[7]);
+		for (int i = 0; i < 4; i++) {
+			r[i * 2] = d[i];
+			r[i * 2 + 1] = d[i + 4];
+		}
+	}
+}
+
+/** Truncate the eight 32-bit values of a row to bytes. */
+static inline uint8x8_t packRow(int32x4_t lo, int32x4_t hi) {
+	const int16x8_t words = vcombine_s16(vmovn_s32(lo), vmovn_s32(hi));
+	return vmovn_u16(vreinterpretq_u16_s16(words));
+}
+
+void BinkIDCT::putNEON(byte *dest, uint32 pitch, const int32 *block) {
+	int32x4_t rows[16];
+	transformBlock(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, packRow(rows[i * 2], rows[i * 2 + 1]));
+}
+
+void BinkIDCT::addNEON(byte *dest, uint32 pitch, const int32 *block) {
+	int32x4_t rows[16];
+	transformBlock(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), packRow(rows[i * 2], rows[i * 2 + 1])));
+}
+
+} // End of namespace Video
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif // __GNUC__
+
+#endif // SCUMMVM_NEON
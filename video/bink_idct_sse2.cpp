@@ -0,0 +1,176 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "video/bink_idct.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Video {
+
+// The same constants as in the generic transform
+enum {
+	kA1 =  2896,
+	kA2 =  2217,
+	kA3 =  3784,
+	kA4 = -5352
+};
+
+/** Multiply 32-bit lanes by a constant, keeping the low 32 bits of the products. */
+static inline __m128i mulConst(__m128i a, int32 c) {
+	const __m128i b = _mm_set1_epi32(c);
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128i mulShift(__m128i a, int32 c) {
+	return _mm_srai_epi32(mulConst(a, c), 11);
+}
+
+static inline void transpose4(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t1);
+	r1 = _mm_unpackhi_epi64(t0, t1);
+	r2 = _mm_unpacklo_epi64(t2, t3);
+	r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+/** One pass of the transform on four independent lines at once. */
+template<bool munge>
+static inline void transformLines(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = mulShift(_mm_sub_epi32(s[2], s[6]), kA1);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = mulShift(_mm_add_epi32(a5, a7), kA3);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(mulShift(a5, kA4), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(mulShift(_mm_sub_epi32(a6, a4), kA1), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(mulShift(a7, kA2), b3), b1);
+
+	const __m128i c0 = _mm_add_epi32(a0, a2);
+	const __m128i c1 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i c2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	const __m128i c3 = _mm_sub_epi32(a0, a2);
+
+	d[0] = _mm_add_epi32(c0, b0);
+	d[1] = _mm_add_epi32(c1, b2);
+	d[2] = _mm_add_epi32(c2, b3);
+	d[3] = _mm_sub_epi32(c3, b4);
+	d[4] = _mm_add_epi32(c3, b4);
+	d[5] = _mm_sub_epi32(c2, b3);
+	d[6] = _mm_sub_epi32(c1, b2);
+	d[7] = _mm_sub_epi32(c0, b0);
+
+	if (munge) {
+		const __m128i round = _mm_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = _mm_srai_epi32(_mm_add_epi32(d[i], round), 8);
+	}
+}
+
+/**
+ * Transform a block. Row i of the result is stored in rows[2 * i] (columns
+ * 0-3) and rows[2 * i + 1] (columns 4-7).
+ */
+static inline void transformBlock(__m128i *rows, const int32 *block) {
+	__m128i s[8], d[8];
+
+	// Columns, four at a time
+	for (int half = 0; half < 2; half++) {
+		for (int i = 0; i < 8; i++)
+			s[i] = _mm_loadu_si128((const __m128i *)(block + i * 8 + half * 4));
+		transformLines<false>(d, s);
+		for (int i = 0; i < 8; i++)
+			rows[i * 2 + half] = d[i];
+	}
+
+	// Rows, four at a time, transposed so that each vector holds the same
+	// column of four rows
+	for (int quad = 0; quad < 8; quad += 4) {
+		__m128i *r = rows + quad * 2;
+		for (int i = 0; i < 4; i++) {
+			s[i] = r[i * 2];
+			s[i + 4] = r[i * 2 + 1];
+		}
+		transpose4(s[0], s[1], s[2], s[3]);
+		transpose4(s[4], s[5], s[6], s[7]);
+
+		transformLines<true>(d, s);
+
+		transpose4(d[0], d[1], d[2], d[3]);
+		transpose4(d[4], d[5], d[6], d[7]);
+		for (int i = 0; i < 4; i++) {
+			r[i * 2] = d[i];
+			r[i * 2 + 1] = d[i + 4];
+		}
+	}
+}
+
+/** Truncate the eight 32-bit values of a row to bytes, in the low half of the result. */
+static inline __m128i packRow(__m128i lo, __m128i hi) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i words = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+	return _mm_packus_epi16(words, words);
+}
+
+void BinkIDCT::putSSE2(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i rows[16];
+	transformBlock(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, packRow(rows[i * 2], rows[i * 2 + 1]));
+}
+
+void BinkIDCT::addSSE2(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i rows[16];
+	transformBlock(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i pixels = _mm_loadl_epi64((const __m128i *)dest);
+		_mm_storel_epi64((__m128i *)dest, _mm_add_epi8(pixels, packRow(rows[i * 2], rows[i * 2 + 1])));
+	}
+}
+
+} // End of namespace Video
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
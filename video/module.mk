@@ -18,7 +18,17 @@ MODULE_OBJS := \
 
 ifdef USE_BINK
 MODULE_OBJS += \
-	bink_decoder.o
+	bink_decoder.o \
+	bink_idct.o
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	bink_idct_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	bink_idct_sse2.o
+endif
 endif
 
 ifdef USE_THEORADEC
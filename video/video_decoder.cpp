@@ -26,10 +26,81 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/mutex.h"
 #include "common/system.h"
+#include "common/thread.h"
+
+#include "graphics/surface.h"
 
 namespace Video {
 
+struct VideoDecoder::ReadAheadState {
+	int curFrame;
+	uint32 nextFrameStartTime;
+	bool reversed;
+	bool endOfTrack;
+	bool hasNextTrack;
+};
+
+struct VideoDecoder::ReadAheadFrame {
+	ReadAheadFrame() : hasSurface(false), dirtyPalette(false) {}
+	~ReadAheadFrame() { surface.free(); }
+
+	Graphics::Surface surface;
+	bool hasSurface;
+	byte palette[256 * 3];
+	bool dirtyPalette;
+
+	// The state of the video track after decoding this frame
+	ReadAheadState state;
+};
+
+struct VideoDecoder::ReadAheadQueue {
+	ReadAheadQueue(VideoTrack *videoTrack, uint frameCount) :
+			track(videoTrack), size(frameCount + 1), start(0), count(0),
+			paused(true), busy(false), idleRequested(false), quit(false) {
+		frames = new ReadAheadFrame[size];
+	}
+
+	~ReadAheadQueue() {
+		mutex.lock();
+		quit = true;
+		mutex.unlock();
+
+		// The thread finishes the frame it is working on first
+		wake.post();
+		thread.join();
+
+		delete[] frames;
+	}
+
+	VideoTrack *track;
+
+	// The ring holds one frame more than is decoded ahead, as the frame
+	// handed out last must stay valid until the next decodeNextFrame()
+	ReadAheadFrame *frames;
+	uint size;
+	uint start;
+	uint count;
+
+	// The state after the frame handed out last, which is what the
+	// playback status functions report
+	ReadAheadState state;
+	byte palette[256 * 3];
+
+	// The thread lives as long as the queue and sleeps on wake while it
+	// is paused or has nothing to do. The mutex guards start, count and
+	// the flags below.
+	Common::Mutex mutex;
+	Common::Semaphore wake;
+	Common::Semaphore idle;
+	Common::Thread thread;
+	bool paused;
+	bool busy;
+	bool idleRequested;
+	bool quit;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -47,9 +118,20 @@ VideoDecoder::VideoDecoder() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
+	_readAhead = 0;
+}
+
+VideoDecoder::~VideoDecoder() {
+	delete _readAhead;
 }
 
 void VideoDecoder::close() {
+	if (_readAhead) {
+		stopReadAhead();
+		delete _readAhead;
+		_readAhead = 0;
+	}
+
 	if (isPlaying())
 		stop();
 
@@ -120,6 +202,8 @@ void VideoDecoder::delayMillis(uint msecs) {
 }
 
 void VideoDecoder::pauseVideo(bool pause) {
+	stopReadAhead();
+
 	if (pause) {
 		_pauseLevel++;
 
@@ -211,6 +295,9 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
+	if (_readAhead)
+		return nextReadAheadFrame();
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -236,17 +323,26 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	stopReadAhead();
+
 	// Attempt to make sure all the tracks are in the requested direction
+	bool changed = false;
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
 			if (!((VideoTrack *)*it)->setReverse(reverse))
 				return false;
 
 			_needsUpdate = true; // force an update
+			changed = true;
 		}
 	}
 
 	findNextVideoTrack();
+
+	// Frames decoded ahead were decoded in the old direction
+	if (changed)
+		flushReadAhead();
+
 	return true;
 }
 
@@ -256,6 +352,9 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (_readAhead)
+		return _readAhead->state.curFrame;
+
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -297,13 +396,29 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
+	uint32 nextFrameStartTime;
+	bool reversed;
+
+	if (_readAhead) {
+		if (!_readAhead->state.hasNextTrack)
+			return 0;
+
+		nextFrameStartTime = _readAhead->state.nextFrameStartTime;
+		reversed = _readAhead->state.reversed;
+	} else {
+		if (!_nextVideoTrack)
+			return 0;
+
+		nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+		reversed = _nextVideoTrack->isReversed();
+	}
+
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (reversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -322,8 +437,12 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool endReached;
+		if (track->getTrackType() == Track::kTrackTypeVideo)
+			endReached = isVideoTrackEnd((const VideoTrack *)track);
+		else
+			endReached = track->endOfTrack();
+
 		if (!endReached)
 			return false;
 	}
@@ -346,6 +465,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	flushReadAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -362,6 +483,7 @@ bool VideoDecoder::rewind() {
 	_startTime = g_system->getMillis();
 	resetPauseStartTime();
 	findNextVideoTrack();
+	flushReadAhead();
 	return true;
 }
 
@@ -380,6 +502,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	flushReadAhead();
+
 	// Stop all tracks so they can be seek'ed
 	if (isPlaying())
 		stopAudio();
@@ -404,6 +528,7 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 
 	resetPauseStartTime();
 	findNextVideoTrack();
+	flushReadAhead();
 	_needsUpdate = true;
 	return true;
 }
@@ -446,6 +571,8 @@ void VideoDecoder::stop() {
 	if (!isPlaying())
 		return;
 
+	stopReadAhead();
+
 	// Stop audio here so we don't have it affect getTime()
 	stopAudio();
 
@@ -931,11 +1058,22 @@ void VideoDecoder::setEndFrame(uint frame) {
 }
 
 void VideoDecoder::resetStartTime() {
-	if (_nextVideoTrack) {
-		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(_nextVideoTrack->getCurFrame());
-		if (isPlaying()) {
-			_startTime = g_system->getMillis() - (curTime.msecs() / _playbackRate).toInt();
-		}
+	Audio::Timestamp curTime;
+
+	if (_readAhead) {
+		if (!_readAhead->state.hasNextTrack)
+			return;
+
+		curTime = _readAhead->track->getFrameTime(_readAhead->state.curFrame);
+	} else {
+		if (!_nextVideoTrack)
+			return;
+
+		curTime = _nextVideoTrack->getFrameTime(_nextVideoTrack->getCurFrame());
+	}
+
+	if (isPlaying()) {
+		_startTime = g_system->getMillis() - (curTime.msecs() / _playbackRate).toInt();
 	}
 }
 
@@ -1020,11 +1158,7 @@ bool VideoDecoder::hasFramesLeft() const {
 		if ((*it)->getTrackType() != Track::kTrackTypeVideo)
 			continue;
 
-		const VideoTrack *track = (const VideoTrack *)*it;
-
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
-		if (!endReached)
+		if (!isVideoTrackEnd((const VideoTrack *)*it))
 			return true;
 	}
 
@@ -1056,4 +1190,209 @@ void VideoDecoder::eraseTrack(Track *track) {
 	}
 }
 
+bool VideoDecoder::setReadAheadFrames(uint frameCount) {
+	if (_readAhead) {
+		stopReadAhead();
+		delete _readAhead;
+		_readAhead = 0;
+	}
+
+	if (frameCount == 0)
+		return true;
+
+	VideoTrack *track = 0;
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			// The playback status is tracked for a single video track
+			if (track)
+				return false;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	if (!track)
+		return false;
+
+	_readAhead = new ReadAheadQueue(track, frameCount);
+	flushReadAhead();
+
+	// Without a thread, frames are decoded when they are needed
+	if (_readAhead->wake.isValid() && _readAhead->idle.isValid())
+		_readAhead->thread.tryStart(readAheadThreadProc, this);
+
+	return true;
+}
+
+void VideoDecoder::readAheadThreadProc(void *param) {
+	((VideoDecoder *)param)->readAheadFrames();
+}
+
+void VideoDecoder::readAheadFrames() {
+	ReadAheadQueue &queue = *_readAhead;
+
+	for (;;) {
+		uint slot;
+		bool work;
+
+		{
+			Common::StackLock lock(queue.mutex);
+
+			if (queue.quit)
+				return;
+
+			work = !queue.paused && queue.count < queue.size - 1 && !queue.track->endOfTrack();
+			slot = (queue.start + queue.count) % queue.size;
+			queue.busy = work;
+		}
+
+		if (!work) {
+			queue.wake.wait();
+			continue;
+		}
+
+		// The slot is outside of the ready frames, so it is ours alone
+		decodeReadAheadFrame(queue.frames[slot]);
+
+		Common::StackLock lock(queue.mutex);
+		queue.count++;
+		queue.busy = false;
+
+		if (queue.idleRequested) {
+			queue.idleRequested = false;
+			queue.idle.post();
+		}
+	}
+}
+
+void VideoDecoder::decodeReadAheadFrame(ReadAheadFrame &frame) {
+	frame.hasSurface = false;
+	frame.dirtyPalette = false;
+
+	readNextPacket();
+
+	if (_nextVideoTrack) {
+		const Graphics::Surface *surface = _nextVideoTrack->decodeNextFrame();
+
+		// The track reuses its surface, so keep a copy
+		if (surface) {
+			if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format) {
+				frame.surface.free();
+				frame.surface.create(surface->w, surface->h, surface->format);
+			}
+
+			frame.surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+			frame.hasSurface = true;
+		}
+
+		if (_nextVideoTrack->hasDirtyPalette()) {
+			const byte *palette = _nextVideoTrack->getPalette();
+
+			if (palette) {
+				memcpy(frame.palette, palette, sizeof(frame.palette));
+				frame.dirtyPalette = true;
+			}
+		}
+
+		findNextVideoTrack();
+	}
+
+	getReadAheadState(frame.state);
+}
+
+void VideoDecoder::getReadAheadState(ReadAheadState &state) const {
+	const VideoTrack *track = _readAhead->track;
+
+	state.curFrame = track->getCurFrame();
+	state.nextFrameStartTime = track->getNextFrameStartTime();
+	state.reversed = track->isReversed();
+	state.endOfTrack = track->endOfTrack();
+	state.hasNextTrack = _nextVideoTrack != 0;
+}
+
+const Graphics::Surface *VideoDecoder::nextReadAheadFrame() {
+	ReadAheadQueue &queue = *_readAhead;
+
+	queue.mutex.lock();
+	bool ready = queue.count != 0;
+	queue.mutex.unlock();
+
+	if (!ready) {
+		// Wait for the frame the thread is working on, or decode it here
+		// if the thread was idle
+		stopReadAhead();
+
+		if (queue.count == 0) {
+			decodeReadAheadFrame(queue.frames[queue.start]);
+			queue.count = 1;
+		}
+	}
+
+	ReadAheadFrame &frame = queue.frames[queue.start];
+	queue.state = frame.state;
+
+	if (frame.dirtyPalette) {
+		memcpy(queue.palette, frame.palette, sizeof(queue.palette));
+		_palette = queue.palette;
+		_dirtyPalette = true;
+	}
+
+	{
+		Common::StackLock lock(queue.mutex);
+		queue.start = (queue.start + 1) % queue.size;
+		queue.count--;
+		queue.paused = false;
+	}
+
+	// Let the thread fill the free slot
+	queue.wake.post();
+
+	return frame.hasSurface ? &frame.surface : 0;
+}
+
+void VideoDecoder::stopReadAhead() {
+	if (!_readAhead)
+		return;
+
+	bool wait;
+
+	{
+		Common::StackLock lock(_readAhead->mutex);
+		_readAhead->paused = true;
+		wait = _readAhead->busy;
+		_readAhead->idleRequested = wait;
+	}
+
+	// The thread finishes the frame it is working on first. It is
+	// resumed by the next call to nextReadAheadFrame().
+	if (wait)
+		_readAhead->idle.wait();
+}
+
+void VideoDecoder::flushReadAhead() {
+	if (!_readAhead)
+		return;
+
+	stopReadAhead();
+	_readAhead->count = 0;
+	getReadAheadState(_readAhead->state);
+}
+
+bool VideoDecoder::isVideoTrackEnd(const VideoTrack *track) const {
+	bool endOfTrack;
+	uint32 nextFrameStartTime;
+
+	if (_readAhead) {
+		endOfTrack = _readAhead->state.endOfTrack;
+		nextFrameStartTime = _readAhead->state.nextFrameStartTime;
+	} else {
+		endOfTrack = track->endOfTrack();
+		nextFrameStartTime = track->getNextFrameStartTime();
+	}
+
+	bool videoEndTimeReached = _endTimeSet && nextFrameStartTime >= (uint)_endTime.msecs();
+	return endOfTrack || (isPlaying() && videoEndTimeReached);
+}
+
 } // End of namespace Video
@@ -52,7 +52,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -364,6 +364,28 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Decode frames ahead of time on a background thread.
+	 *
+	 * When enabled, up to @p frameCount frames are decoded in advance into
+	 * a ring of surfaces, and decodeNextFrame() hands back the next ready
+	 * frame instead of decoding it on the spot. This smooths out frames
+	 * which take much longer than others to decode. Seeking, rewinding and
+	 * changing the playback direction flush the decoded frames.
+	 *
+	 * This should be called after loadStream(), before the first
+	 * decodeNextFrame() call. Closing the video disables it again.
+	 *
+	 * This is only supported for videos with exactly one video track, and
+	 * must only be used with decoders which do not override
+	 * decodeNextFrame() or rewind(), and whose readNextPacket() and track
+	 * decoding do not touch non thread-safe global state.
+	 *
+	 * @param frameCount The number of frames to decode ahead, or 0 to disable
+	 * @return true on success, false otherwise
+	 */
+	bool setReadAheadFrames(uint frameCount);
+
 	/**
 	 * Set the video to decode frames in reverse.
 	 *
@@ -1011,6 +1033,21 @@ private:
 	Audio::Mixer::SoundType _soundType;
 
 	AudioTrack *_mainAudioTrack;
+
+	// Frames decoded ahead of time, see setReadAheadFrames()
+	struct ReadAheadState;
+	struct ReadAheadFrame;
+	struct ReadAheadQueue;
+	ReadAheadQueue *_readAhead;
+
+	static void readAheadThreadProc(void *param);
+	void readAheadFrames();
+	void decodeReadAheadFrame(ReadAheadFrame &frame);
+	void getReadAheadState(ReadAheadState &state) const;
+	const Graphics::Surface *nextReadAheadFrame();
+	void stopReadAhead();
+	void flushReadAhead();
+	bool isVideoTrackEnd(const VideoTrack *track) const;
 };
 
 } // End of namespace Video